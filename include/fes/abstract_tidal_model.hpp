@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "fes/angle/astronomic.hpp"
+#include "fes/detail/shared_matrix.hpp"
 #include "fes/eigen.hpp"
 #include "fes/geometry/point.hpp"
 #include "fes/wave.hpp"
@@ -134,6 +135,11 @@ template <typename T>
 class AbstractTidalModel
     : public std::enable_shared_from_this<AbstractTidalModel<T>> {
  public:
+  /// Values of the tidal constituents handled by the model. The values of a
+  /// model restored from shared memory are borrowed from it.
+  using Constituents =
+      std::map<Constituent, detail::SharedVector<std::complex<T>>>;
+
   /// Default constructor
   AbstractTidalModel() = default;
 
@@ -215,13 +221,10 @@ class AbstractTidalModel
   }
 
   /// Get the tidal constituents handled by the model.
-  constexpr auto data() const
-      -> const std::map<Constituent, Vector<std::complex<T>>>& {
-    return data_;
-  }
+  constexpr auto data() const -> const Constituents& { return data_; }
 
   /// Clear all tidal constituents.
-  inline auto clear() -> void {
+  virtual auto clear() -> void {
     data_.clear();
     dynamic_.clear();
   }
@@ -247,7 +250,7 @@ class AbstractTidalModel
 
  protected:
   /// Tidal constituents handled by the model.
-  std::map<Constituent, Vector<std::complex<T>>> data_{};
+  Constituents data_{};
 
   /// List of tidal constituents handled by the model but not interpolated.
   std::vector<Constituent> dynamic_{};
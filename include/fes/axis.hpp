@@ -7,17 +7,25 @@
 #pragma once
 #include <Eigen/Core>
 #include <boost/optional.hpp>
+#include <istream>
 #include <limits>
 #include <memory>
+#include <ostream>
 #include <tuple>
 
 #include "fes/detail/math.hpp"
+#include "fes/eigen.hpp"
 #include "fes/string_view.hpp"
 
 namespace fes {
 
 /// @brief A coordinate axis a variable that specifies one of the coordinates
 /// of a variable's values.
+///
+/// The axis values must be strictly monotonic. Evenly spaced values are
+/// described by their start and step; otherwise the values are stored, and a
+/// table partitioning the axis range into uniform buckets keeps the search of
+/// the closest value in constant time.
 class Axis : public std::enable_shared_from_this<Axis> {
  public:
   /// Default constructor.
@@ -25,7 +33,8 @@ class Axis : public std::enable_shared_from_this<Axis> {
 
   /// Build an axis from a vector of points.
   ///
-  /// @param[in] points The axis points.
+  /// @param[in] points The axis points, strictly monotonic. They may not be
+  /// evenly spaced (e.g. Mercator or Gaussian latitudes).
   /// @param[in] epsilon The tolerance used to determine if the axis is
   /// circular.
   /// @param[in] is_circular True if the axis is circular. For example,
@@ -58,10 +67,12 @@ class Axis : public std::enable_shared_from_this<Axis> {
   ///
   /// @param[in] other The other axis.
   /// @return True if the axes are equal.
-  constexpr auto operator==(const Axis& other) const -> bool {
+  inline auto operator==(const Axis& other) const -> bool {
     return is_circular_ == other.is_circular_ && circle_ == other.circle_ &&
            is_ascending_ == other.is_ascending_ && size_ == other.size_ &&
-           start_ == other.start_ && step_ == other.step_;
+           start_ == other.start_ && step_ == other.step_ &&
+           points_.size() == other.points_.size() &&
+           (points_.array() == other.points_.array()).all();
   }
 
   /// Return the size of the axis.
@@ -71,21 +82,27 @@ class Axis : public std::enable_shared_from_this<Axis> {
   constexpr auto start() const -> double { return start_; }
 
   /// Return the last value of the axis.
-  constexpr auto end() const -> double { return (*this)(size() - 1); }
+  inline auto end() const -> double { return (*this)(size() - 1); }
 
-  /// Return the step of the axis.
+  /// Return the step of the axis. For an axis whose values are not evenly
+  /// spaced, return the mean step.
   constexpr auto step() const -> double { return step_; }
 
   /// Return the minimum value of the axis.
-  constexpr auto min_value() const -> double {
+  inline auto min_value() const -> double {
     return is_ascending_ ? start() : end();
   }
 
   /// Return the maximum value of the axis.
-  constexpr auto max_value() const -> double {
+  inline auto max_value() const -> double {
     return is_ascending_ ? end() : start();
   }
 
+  /// True if the axis values are evenly spaced.
+  inline auto is_regular() const noexcept -> bool {
+    return points_.size() == 0;
+  }
+
   /// True if the axis is ascending.
   constexpr auto is_ascending() const -> bool { return is_ascending_; }
 
@@ -101,11 +118,12 @@ class Axis : public std::enable_shared_from_this<Axis> {
   ///
   /// @param[in] index The index.
   /// @return The value at the given index.
-  constexpr auto operator()(const int64_t index) const -> double {
+  inline auto operator()(const int64_t index) const -> double {
     if (index < 0 || index >= size_) {
       throw std::out_of_range("The index is out of range.");
     }
-    return static_cast<double>(start_ + index * step_);
+    return is_regular() ? static_cast<double>(start_ + index * step_)
+                        : points_[index];
   }
 
   /// Search the index on the axis that is closest to the given value.
@@ -117,9 +135,11 @@ class Axis : public std::enable_shared_from_this<Axis> {
   /// end.
   /// @return The index of the closest value. Return -1 if the value is
   /// out of bounds and bounded is false.
-  FES_MATH_CONSTEXPR auto find_index(const double coordinate,
-                                     const bool bounded = false) const noexcept
-      -> int64_t {
+  inline auto find_index(const double coordinate,
+                         const bool bounded = false) const noexcept -> int64_t {
+    if (!is_regular()) {
+      return find_irregular_index(normalize_coordinate(coordinate), bounded);
+    }
     auto index = static_cast<int64_t>(
         std::round((normalize_coordinate(coordinate) - start_) / step_));
     if (index < 0) {
@@ -147,10 +167,18 @@ class Axis : public std::enable_shared_from_this<Axis> {
   /// @return The serialized axis.
   auto getstate() const -> std::string;
 
+  /// @brief Serialize the axis to a stream.
+  /// @param[in,out] os The stream receiving the serialized axis.
+  auto getstate(std::ostream& os) const -> void;
+
   /// @brief Deserialize the axis.
   /// @param[in] data The serialized axis.
   static auto setstate(const string_view& data) -> Axis;
 
+  /// @brief Deserialize the axis from a stream.
+  /// @param[in,out] is The stream providing the serialized axis.
+  static auto setstate(std::istream& is) -> Axis;
+
  private:
   /// True if the axis is circular.
   bool is_circular_{};
@@ -164,6 +192,33 @@ class Axis : public std::enable_shared_from_this<Axis> {
   double start_{};
   /// The step between two values of the axis.
   double step_{};
+  /// The axis values if they are not evenly spaced, empty otherwise.
+  Eigen::VectorXd points_{};
+  /// For each bucket of the uniform partition of the axis range, the rank, in
+  /// ascending order, of the last axis value less than or equal to the lower
+  /// bound of the bucket.
+  Vector<int64_t> buckets_{};
+  /// Number of buckets per unit of the axis.
+  double bucket_scale_{};
+
+  /// Returns the axis value of a given rank in ascending order.
+  inline auto sorted_value(const int64_t rank) const -> double {
+    return points_[is_ascending_ ? rank : size_ - 1 - rank];
+  }
+
+  /// Build the bucket table of an axis whose values are not evenly spaced.
+  auto build_buckets() -> void;
+
+  /// Search the index of the closest value on an axis whose values are not
+  /// evenly spaced.
+  ///
+  /// @param[in] coordinate The normalized coordinate to search.
+  /// @param[in] bounded True if the search should be bounded by the axis
+  /// limits.
+  /// @return The index of the closest value, or -1 if the value is out of
+  /// bounds and bounded is false.
+  auto find_irregular_index(double coordinate, bool bounded) const noexcept
+      -> int64_t;
 
   /// Determines whether the values contained in the vector are evenly spaced
   /// from each other.
@@ -186,7 +241,7 @@ class Axis : public std::enable_shared_from_this<Axis> {
   ///
   /// @param[in] coordinate The coordinate to be normalized.
   /// @return The normalized value of the coordinate.
-  constexpr auto normalize_coordinate(const double coordinate) const noexcept
+  inline auto normalize_coordinate(const double coordinate) const noexcept
       -> double {
     if (is_angle() &&
         (coordinate >= min_value() + detail::math::circle_degrees<double>() ||
@@ -39,6 +39,15 @@ class Grid {
     return data_[(this->*get_index_)(x, y)];
   }
 
+  /// Get the position in the 1D array of the value at the given coordinates.
+  /// @param[in] x The x coordinate.
+  /// @param[in] y The y coordinate.
+  /// @return The position of the value in the 1D array.
+  constexpr auto index(const Eigen::Index x, const Eigen::Index y) const
+      noexcept -> Eigen::Index {
+    return (this->*get_index_)(x, y);
+  }
+
   /// Get the number of rows in the grid.
   /// @return The number of rows in the grid.
   constexpr auto nx() const noexcept -> size_t { return nx_; }
@@ -0,0 +1,81 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/detail/nearest_cell_table.hpp
+/// @brief Nearest valid cell lookup table of a Cartesian grid.
+#pragma once
+#include <Eigen/Core>
+#include <cstdint>
+#include <utility>
+
+#include "fes/axis.hpp"
+#include "fes/eigen.hpp"
+
+namespace fes {
+namespace detail {
+
+/// @brief Table giving, for each cell of a Cartesian grid, the nearest cell
+/// holding a defined value.
+///
+/// The table is built once with a distance transform seeded from the defined
+/// cells located on the edge of the undefined areas (the coastline). An
+/// undefined cell located at less than a given distance from a defined cell
+/// is associated with the nearest defined cell, so that the extrapolation of
+/// the grid is reduced to a table lookup.
+class NearestCellTable {
+ public:
+  /// Default constructor (empty table).
+  NearestCellTable() = default;
+
+  /// Build the table from the mask of the defined cells of a grid.
+  ///
+  /// @param[in] lon The longitude axis of the grid.
+  /// @param[in] lat The latitude axis of the grid.
+  /// @param[in] valid The mask of the defined cells, stored in the same order
+  /// as the grid values.
+  /// @param[in] row_major Whether the grid is stored in longitude-major order.
+  /// @param[in] max_distance The maximum distance, in meters, between an
+  /// undefined cell and the defined cell used to extrapolate it.
+  NearestCellTable(const Axis& lon, const Axis& lat,
+                   const Eigen::Ref<const Vector<bool>>& valid,
+                   bool row_major, double max_distance);
+
+  /// Build the table from its serialized content.
+  ///
+  /// @param[in] nearest The index of the nearest defined cell for each cell of
+  /// the grid.
+  explicit NearestCellTable(Vector<int32_t> nearest)
+      : nearest_(std::move(nearest)) {}
+
+  /// Get the index of the nearest defined cell.
+  ///
+  /// @param[in] index The index of the cell in the grid values.
+  /// @return The index of the nearest defined cell, the index itself if the
+  /// cell is defined, or -1 if no defined cell is close enough.
+  inline auto operator()(const Eigen::Index index) const noexcept -> int32_t {
+    return nearest_[index];
+  }
+
+  /// True if the table is empty (extrapolation disabled).
+  inline auto empty() const noexcept -> bool { return nearest_.size() == 0; }
+
+  /// True if the cell at the given index is defined.
+  ///
+  /// @param[in] index The index of the cell in the grid values.
+  inline auto is_valid(const Eigen::Index index) const noexcept -> bool {
+    return nearest_[index] == index;
+  }
+
+  /// Get the index of the nearest defined cell for each cell of the grid.
+  constexpr auto nearest() const noexcept -> const Vector<int32_t>& {
+    return nearest_;
+  }
+
+ private:
+  /// Index of the nearest defined cell for each cell of the grid.
+  Vector<int32_t> nearest_{};
+};
+
+}  // namespace detail
+}  // namespace fes
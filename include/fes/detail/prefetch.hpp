@@ -0,0 +1,33 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/detail/prefetch.hpp
+/// @brief Software prefetching.
+#pragma once
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace fes {
+namespace detail {
+
+/// @brief Hint the processor to load, for reading, the cache line containing
+/// an address.
+///
+/// This function does nothing if the compiler provides no prefetch
+/// instruction.
+///
+/// @param[in] address The address to load.
+inline auto prefetch(const void* address) noexcept -> void {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+}  // namespace detail
+}  // namespace fes
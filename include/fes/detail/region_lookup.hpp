@@ -0,0 +1,83 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/detail/region_lookup.hpp
+/// @brief Coarse raster used to dispatch points to the regions covering them.
+#pragma once
+#include <Eigen/Core>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "fes/axis.hpp"
+#include "fes/eigen.hpp"
+
+namespace fes {
+namespace detail {
+
+/// @brief Coarse global raster listing, for each of its cells, the regions
+/// (grids, grid cells, ...) whose extent intersects the cell.
+///
+/// The candidates of each cell are stored in a compressed sparse row layout,
+/// sorted by increasing region index.
+class RegionLookup {
+ public:
+  /// Default constructor (empty raster).
+  RegionLookup() = default;
+
+  /// Build the raster from the extents of the regions.
+  ///
+  /// @param[in] extents The extent of each region: minimum longitude, minimum
+  /// latitude, maximum longitude and maximum latitude, in degrees. The maximum
+  /// longitude may exceed 180 degrees if the region crosses the antimeridian.
+  /// Regions whose extent is not finite are ignored.
+  /// @param[in] resolution The size of the raster cells, in degrees.
+  RegionLookup(const Eigen::Ref<const Eigen::Matrix<double, -1, 4>>& extents,
+               double resolution);
+
+  /// Build the raster from the axes defining Cartesian grids.
+  ///
+  /// @param[in] grids The longitude and latitude axes of each grid.
+  /// @param[in] resolution The size of the raster cells, in degrees.
+  RegionLookup(const std::vector<std::pair<const Axis*, const Axis*>>& grids,
+               double resolution);
+
+  /// Get the regions covering the cell containing a given point.
+  ///
+  /// @param[in] lon The longitude of the point, in degrees.
+  /// @param[in] lat The latitude of the point, in degrees.
+  /// @return The range of the indices of the regions covering the cell.
+  auto candidates(double lon, double lat) const noexcept
+      -> std::pair<const int32_t*, const int32_t*>;
+
+  /// Get the size of the raster cells, in degrees.
+  constexpr auto resolution() const noexcept -> double { return resolution_; }
+
+ private:
+  /// Size of the raster cells, in degrees.
+  double resolution_{};
+  /// Number of columns of the raster.
+  int64_t nx_{};
+  /// Number of rows of the raster.
+  int64_t ny_{};
+  /// Position of the first candidate of each cell in regions_ (nx_ * ny_ + 1
+  /// items).
+  Vector<int32_t> offsets_{};
+  /// Indices of the regions covering the cells.
+  Vector<int32_t> regions_{};
+
+  /// Convert the extents of Cartesian grids.
+  static auto extents(
+      const std::vector<std::pair<const Axis*, const Axis*>>& grids)
+      -> Eigen::Matrix<double, -1, 4>;
+
+  /// Get the column of the raster containing a longitude.
+  auto column(double lon) const noexcept -> int64_t;
+
+  /// Get the row of the raster containing a latitude.
+  auto row(double lat) const noexcept -> int64_t;
+};
+
+}  // namespace detail
+}  // namespace fes
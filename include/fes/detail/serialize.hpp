@@ -6,44 +6,201 @@
 /// @brief Serialization utilities.
 #pragma once
 #include <Eigen/Core>
+#include <algorithm>
+#include <cstdint>
+#include <istream>
 #include <map>
+#include <memory>
+#include <ostream>
 #include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "fes/detail/isviewstream.hpp"
+#include "fes/detail/shared_matrix.hpp"
 
 namespace fes {
 namespace detail {
 namespace serialize {
 
-/// @brief Write data to a stringstream
+/// @brief Stream buffer counting the characters written, without storing
+/// them.
+class CountingBuffer : public std::streambuf {
+ public:
+  /// @brief Get the number of characters written.
+  inline auto size() const noexcept -> size_t { return size_; }
+
+ protected:
+  /// @brief Count a sequence of characters.
+  auto xsputn(const char* /*s*/, std::streamsize count)
+      -> std::streamsize override {
+    size_ += static_cast<size_t>(count);
+    return count;
+  }
+
+  /// @brief Count a character.
+  auto overflow(int_type ch) -> int_type override {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      ++size_;
+    }
+    return traits_type::not_eof(ch);
+  }
+
+ private:
+  /// The number of characters written.
+  size_t size_{0};
+};
+
+/// @brief Arrays stored outside of a serialized state.
+///
+/// When a registry is attached to a stream, write_matrix records the address
+/// of the large arrays in the registry instead of writing their values, and
+/// read_matrix copies their values from the buffers of the registry. The
+/// serialized state then only holds the shape of these arrays, which can be
+/// transferred separately without being copied into the state. If the
+/// registry has an owner keeping its buffers alive, read_shared_matrix
+/// borrows the buffers instead of copying them.
+class OutOfBand {
+ public:
+  /// A memory area: its address and its size in bytes.
+  using Buffer = std::pair<const char*, size_t>;
+
+  /// Default minimum size, in bytes, of the arrays stored out-of-band.
+  static constexpr size_t kMinSize = 4096;
+
+  /// @brief Build a registry collecting the arrays written.
+  ///
+  /// @param[in] min_size The minimum size, in bytes, of the arrays stored
+  /// out-of-band. The smaller arrays are written in the state.
+  explicit OutOfBand(const size_t min_size = kMinSize) : min_size_(min_size) {}
+
+  /// @brief Build a registry providing the arrays to read.
+  ///
+  /// @param[in] buffers The arrays stored out-of-band, in the order in which
+  /// they were written.
+  explicit OutOfBand(std::vector<Buffer> buffers)
+      : buffers_(std::move(buffers)) {}
+
+  /// @brief Build a registry providing arrays that can be borrowed.
+  ///
+  /// @param[in] buffers The arrays stored out-of-band, in the order in which
+  /// they were written. They must not be modified while they are used.
+  /// @param[in] owner The object keeping the arrays alive, shared by the
+  /// matrices borrowing them.
+  OutOfBand(std::vector<Buffer> buffers, std::shared_ptr<const void> owner)
+      : buffers_(std::move(buffers)), owner_(std::move(owner)) {}
+
+  /// @brief Attach the registry to a stream.
+  ///
+  /// The registry must outlive the operations done on the stream.
+  inline auto attach(std::ios_base& stream) -> void {
+    stream.pword(index()) = this;
+  }
+
+  /// @brief Get the registry attached to a stream.
+  ///
+  /// @return The registry or nullptr if no registry is attached.
+  static auto get(std::ios_base& stream) -> OutOfBand* {
+    return static_cast<OutOfBand*>(stream.pword(index()));
+  }
+
+  /// @brief Record an array if it must be stored out-of-band.
+  ///
+  /// @param[in] data The address of the array.
+  /// @param[in] size The size of the array in bytes.
+  /// @return True if the array is stored out-of-band.
+  inline auto push(const void* data, const size_t size) -> bool {
+    if (size < min_size_) {
+      return false;
+    }
+    buffers_.emplace_back(static_cast<const char*>(data), size);
+    return true;
+  }
+
+  /// @brief Get the next array stored out-of-band.
+  ///
+  /// @param[in] size The expected size of the array in bytes.
+  /// @return The address of the array.
+  inline auto pop(const size_t size) -> const char* {
+    if (next_ >= buffers_.size() || buffers_[next_].second != size) {
+      throw std::invalid_argument("invalid out-of-band buffer");
+    }
+    return buffers_[next_++].first;
+  }
+
+  /// @brief Get the minimum size, in bytes, of the arrays stored out-of-band.
+  constexpr auto min_size() const noexcept -> size_t { return min_size_; }
+
+  /// @brief Get the arrays stored out-of-band.
+  constexpr auto buffers() const noexcept -> const std::vector<Buffer>& {
+    return buffers_;
+  }
+
+  /// @brief Get the object keeping the arrays alive, or nullptr if the arrays
+  /// cannot be borrowed.
+  constexpr auto owner() const noexcept -> const std::shared_ptr<const void>& {
+    return owner_;
+  }
+
+ private:
+  /// The minimum size of the arrays stored out-of-band.
+  size_t min_size_{kMinSize};
+  /// The arrays stored out-of-band.
+  std::vector<Buffer> buffers_{};
+  /// The index of the next array to read.
+  size_t next_{0};
+  /// The object keeping the arrays alive.
+  std::shared_ptr<const void> owner_{};
+
+  /// Get the index of the stream storage slot holding the registry.
+  static auto index() -> int {
+    static const auto result = std::ios_base::xalloc();
+    return result;
+  }
+};
+
+/// @brief Check that a stream is still usable after an operation.
+/// @param[in] stream The stream to check.
+inline auto check_stream(const std::ios& stream) -> void {
+  if (stream.fail()) {
+    throw std::runtime_error("unable to read or write the serialized data");
+  }
+}
+
+/// @brief Write data to a stream
 /// @tparam T The type of the data to write
-/// @param[in] ss The stringstream to write to
+/// @param[in] ss The stream to write to
 /// @param[in] data The data to write
 template <typename T>
-auto write_data(std::stringstream& ss, const T& data) -> void {
+auto write_data(std::ostream& ss, const T& data) -> void {
   ss.write(reinterpret_cast<const char*>(&data), sizeof(data));
+  check_stream(ss);
 }
 
-/// @brief Read data from a stringstream
+/// @brief Read data from a stream
 /// @tparam T The type of the data to read
-/// @param[in] ss The stringstream to read from
+/// @param[in] ss The stream to read from
 /// @return The data read
 template <typename T>
-auto read_data(detail::isviewstream& ss) -> T {
+auto read_data(std::istream& ss) -> T {
   auto data = T{};
   ss.read(reinterpret_cast<char*>(&data), sizeof(data));
+  check_stream(ss);
   return data;
 }
 
-/// @brief Write a string to a stringstream
-/// @param[in] ss The stringstream to write to
+/// @brief Write a string to a stream
+/// @param[in] ss The stream to write to
 /// @param[in] data The string to write
-inline auto write_string(std::stringstream& ss, const std::string& data)
-    -> void {
+inline auto write_string(std::ostream& ss, const std::string& data) -> void {
   auto size = data.size();
   write_data(ss, size);
   ss.write(data.data(), data.size());
+  check_stream(ss);
 }
 
 /// @brief Read a string from a stringstream
@@ -53,76 +210,238 @@ inline auto read_string(detail::isviewstream& ss) -> fes::string_view {
   return ss.readview(read_data<size_t>(ss));
 }
 
-/// @brief Write an Eigen matrix to a stringstream
+/// @brief Write the state of an object, prefixed by its size like
+/// write_string, without building the state in memory.
+///
+/// The object is serialized twice: once to count the size of its state, then
+/// to write it. The first pass only counts the characters written, without
+/// copying the arrays of the object.
+///
+/// @tparam T The type of the object, providing a `getstate(std::ostream&)`
+/// method.
+/// @param[in] ss The stream to write to
+/// @param[in] object The object to write
+template <typename T>
+auto write_object(std::ostream& ss, const T& object) -> void {
+  auto buffer = CountingBuffer();
+  std::ostream counter(&buffer);
+  // The arrays stored out-of-band are not part of the size of the state.
+  auto* parent = OutOfBand::get(ss);
+  auto out_of_band = OutOfBand(parent != nullptr ? parent->min_size() : 0);
+  if (parent != nullptr) {
+    out_of_band.attach(counter);
+  }
+  object.getstate(counter);
+  write_data(ss, buffer.size());
+  object.getstate(ss);
+}
+
+/// @brief Read an object written by write_object directly from a stream.
+///
+/// @tparam T The type of the object, providing a static
+/// `setstate(std::istream&)` method.
+/// @param[in] ss The stream to read from
+/// @return The object read
+template <typename T>
+auto read_object(std::istream& ss) -> T {
+  read_data<size_t>(ss);
+  return T::setstate(ss);
+}
+
+/// @brief Write the shape and the values of a matrix to a stream.
+///
+/// @tparam T The type of the values
+/// @param[in] ss The stream to write to
+/// @param[in] data The values of the matrix
+/// @param[in] rows The number of rows in the matrix
+/// @param[in] cols The number of columns in the matrix
+template <typename T>
+auto write_values(std::ostream& ss, const T* data, const Eigen::Index rows,
+                  const Eigen::Index cols) -> void {
+  write_data(ss, rows);
+  write_data(ss, cols);
+  const auto size = static_cast<size_t>(rows * cols) * sizeof(T);
+  auto* out_of_band = OutOfBand::get(ss);
+  if (out_of_band != nullptr) {
+    const auto stored = out_of_band->push(data, size);
+    write_data(ss, stored);
+    if (stored) {
+      return;
+    }
+  }
+  ss.write(reinterpret_cast<const char*>(data),
+           static_cast<std::streamsize>(size));
+  check_stream(ss);
+}
+
+/// @brief Read the shape of a matrix from a stream.
+///
+/// @tparam ROWS The number of rows in the matrix
+/// @tparam COLS The number of columns in the matrix
+/// @param[in] ss The stream to read from
+/// @return The number of rows and columns
+template <int ROWS, int COLS>
+auto read_shape(std::istream& ss) -> std::pair<Eigen::Index, Eigen::Index> {
+  auto rows = read_data<Eigen::Index>(ss);
+  auto cols = read_data<Eigen::Index>(ss);
+  if ((ROWS != Eigen::Dynamic && rows != ROWS) ||
+      (COLS != Eigen::Dynamic && cols != COLS) || rows < 0 || cols < 0) {
+    throw std::invalid_argument("invalid matrix shape");
+  }
+  return {rows, cols};
+}
+
+/// @brief Read the values of a matrix from a stream.
+///
+/// @tparam T The type of the values
+/// @param[in] ss The stream to read from
+/// @param[out] data The values of the matrix
+/// @param[in] size The number of values
+template <typename T>
+auto read_values(std::istream& ss, T* data, const Eigen::Index size) -> void {
+  const auto bytes = static_cast<size_t>(size) * sizeof(T);
+  auto* out_of_band = OutOfBand::get(ss);
+  if (out_of_band != nullptr && read_data<bool>(ss)) {
+    std::copy_n(out_of_band->pop(bytes), bytes, reinterpret_cast<char*>(data));
+    return;
+  }
+  ss.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(bytes));
+  check_stream(ss);
+}
+
+/// @brief Write an Eigen matrix to a stream
+///
+/// If an OutOfBand registry is attached to the stream, the large matrices are
+/// recorded in the registry instead of being written.
+///
 /// @tparam T The type of the matrix
 /// @tparam ROWS The number of rows in the matrix
 /// @tparam COLS The number of columns in the matrix
-/// @param[in] ss The stringstream to write to
+/// @tparam OPTIONS The storage options of the matrix
+/// @param[in] ss The stream to write to
 /// @param[in] data The matrix to write
-template <typename T, int ROWS, int COLS>
-auto write_matrix(std::stringstream& ss,
-                  const Eigen::Matrix<T, ROWS, COLS>& data) -> void {
-  write_data(ss, data.rows());
-  write_data(ss, data.cols());
-  ss.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+template <typename T, int ROWS, int COLS, int OPTIONS>
+auto write_matrix(std::ostream& ss,
+                  const Eigen::Matrix<T, ROWS, COLS, OPTIONS>& data) -> void {
+  write_values(ss, data.data(), data.rows(), data.cols());
 }
 
-/// @brief Read an Eigen matrix from a stringstream
+/// @brief Write a shared matrix to a stream, like an Eigen matrix.
+///
 /// @tparam T The type of the matrix
 /// @tparam ROWS The number of rows in the matrix
 /// @tparam COLS The number of columns in the matrix
-/// @param[in] ss The stringstream to read from
+/// @tparam OPTIONS The storage options of the matrix
+/// @param[in] ss The stream to write to
+/// @param[in] data The matrix to write
+template <typename T, int ROWS, int COLS, int OPTIONS>
+auto write_matrix(std::ostream& ss,
+                  const SharedMatrix<T, ROWS, COLS, OPTIONS>& data) -> void {
+  write_values(ss, data.data(), data.rows(), data.cols());
+}
+
+/// @brief Read an Eigen matrix from a stream
+///
+/// If an OutOfBand registry is attached to the stream, the matrices stored
+/// out-of-band are copied from the buffers of the registry.
+///
+/// @tparam T The type of the matrix
+/// @tparam ROWS The number of rows in the matrix
+/// @tparam COLS The number of columns in the matrix
+/// @tparam OPTIONS The storage options of the matrix
+/// @param[in] ss The stream to read from
 /// @return The matrix read
-template <typename T, int ROWS, int COLS>
-auto read_matrix(detail::isviewstream& ss) -> Eigen::Matrix<T, ROWS, COLS> {
-  auto rows = read_data<Eigen::Index>(ss);
-  auto cols = read_data<Eigen::Index>(ss);
-  auto data = Eigen::Matrix<T, ROWS, COLS>(rows, cols);
-  ss.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(T));
+template <typename T, int ROWS, int COLS,
+          int OPTIONS = Eigen::Matrix<T, ROWS, COLS>::Options>
+auto read_matrix(std::istream& ss) -> Eigen::Matrix<T, ROWS, COLS, OPTIONS> {
+  const auto shape = read_shape<ROWS, COLS>(ss);
+  auto data = Eigen::Matrix<T, ROWS, COLS, OPTIONS>(shape.first, shape.second);
+  read_values(ss, data.data(), data.size());
   return data;
 }
 
-/// @brief Write the map of constituents to a stringstream
+/// @brief Read a shared matrix from a stream
+///
+/// If the OutOfBand registry attached to the stream has an owner, the
+/// matrices stored out-of-band borrow the buffers of the registry, provided
+/// that they are suitably aligned. Otherwise, the values are copied as by
+/// read_matrix.
+///
+/// @tparam T The type of the matrix
+/// @tparam ROWS The number of rows in the matrix
+/// @tparam COLS The number of columns in the matrix
+/// @tparam OPTIONS The storage options of the matrix
+/// @param[in] ss The stream to read from
+/// @return The matrix read
+template <typename T, int ROWS, int COLS,
+          int OPTIONS = Eigen::Matrix<T, ROWS, COLS>::Options>
+auto read_shared_matrix(std::istream& ss)
+    -> SharedMatrix<T, ROWS, COLS, OPTIONS> {
+  const auto shape = read_shape<ROWS, COLS>(ss);
+  auto* out_of_band = OutOfBand::get(ss);
+  if (out_of_band != nullptr && out_of_band->owner() != nullptr) {
+    auto data = Eigen::Matrix<T, ROWS, COLS, OPTIONS>();
+    if (read_data<bool>(ss)) {
+      const auto size =
+          static_cast<size_t>(shape.first * shape.second) * sizeof(T);
+      const auto* buffer = out_of_band->pop(size);
+      if (reinterpret_cast<std::uintptr_t>(buffer) % alignof(T) == 0) {
+        return {reinterpret_cast<const T*>(buffer), shape.first, shape.second,
+                out_of_band->owner()};
+      }
+      data.resize(shape.first, shape.second);
+      std::copy_n(buffer, size, reinterpret_cast<char*>(data.data()));
+    } else {
+      data.resize(shape.first, shape.second);
+      ss.read(reinterpret_cast<char*>(data.data()),
+              static_cast<std::streamsize>(data.size() * sizeof(T)));
+      check_stream(ss);
+    }
+    return {std::move(data)};
+  }
+  auto data = Eigen::Matrix<T, ROWS, COLS, OPTIONS>(shape.first, shape.second);
+  read_values(ss, data.data(), data.size());
+  return {std::move(data)};
+}
+
+/// @brief Write the map of constituents to a stream
 /// @tparam T The type of the constituents
 /// @tparam U The type of the data
-/// @param[in] ss The stringstream to write to
+/// @param[in] ss The stream to write to
 /// @param[in] data The map of constituents to write
 template <typename T, typename U>
-auto write_constituent_map(
-    std::stringstream& ss,
-    const std::map<T, Eigen::Matrix<U, Eigen::Dynamic, 1>>& data) -> void {
+auto write_constituent_map(std::ostream& ss,
+                           const std::map<T, SharedVector<U>>& data) -> void {
   write_data(ss, data.size());
   for (const auto& item : data) {
     write_data(ss, item.first);
-    write_matrix<U, Eigen::Dynamic, 1>(ss, item.second);
+    write_matrix(ss, item.second);
   }
 }
 
-/// @brief Read the map of constituents from a stringstream
+/// @brief Read the map of constituents from a stream
 /// @tparam T The type of the constituents
 /// @tparam U The type of the data
-/// @param[in] ss The stringstream to read from
+/// @param[in] ss The stream to read from
 /// @return The map of constituents read
 template <typename T, typename U>
-auto read_constituent_map(detail::isviewstream& ss)
-    -> std::map<T, Eigen::Matrix<U, Eigen::Dynamic, 1>> {
+auto read_constituent_map(std::istream& ss) -> std::map<T, SharedVector<U>> {
   auto size = read_data<Eigen::Index>(ss);
-  auto data = std::map<T, Eigen::Matrix<U, Eigen::Dynamic, 1>>{};
+  auto data = std::map<T, SharedVector<U>>{};
   for (auto ix = 0; ix < size; ++ix) {
     auto constituent = read_data<T>(ss);
-    auto map = read_matrix<U, Eigen::Dynamic, 1>(ss);
-    data.emplace(constituent, map);
+    data.emplace(constituent, read_shared_matrix<U, Eigen::Dynamic, 1>(ss));
   }
   return data;
 }
 
-/// @brief Write an unordered map to a stringstream
+/// @brief Write an unordered map to a stream
 /// @tparam T The type of the key
 /// @tparam U The type of the value
-/// @param[in] ss The stringstream to write to
+/// @param[in] ss The stream to write to
 /// @param[in] data The unordered map to write
 template <typename T, typename U>
-auto write_unordered_map(std::stringstream& ss,
+auto write_unordered_map(std::ostream& ss,
                          const std::unordered_map<T, U>& data) -> void {
   write_data(ss, data.size());
   for (const auto& item : data) {
@@ -131,13 +450,13 @@ auto write_unordered_map(std::stringstream& ss,
   }
 }
 
-/// @brief Read an unordered map from a stringstream
+/// @brief Read an unordered map from a stream
 /// @tparam T The type of the key
 /// @tparam U The type of the value
-/// @param[in] ss The stringstream to read from
+/// @param[in] ss The stream to read from
 /// @return The unordered map read
 template <typename T, typename U>
-auto read_unordered_map(detail::isviewstream& ss) -> std::unordered_map<T, U> {
+auto read_unordered_map(std::istream& ss) -> std::unordered_map<T, U> {
   auto size = read_data<size_t>(ss);
   auto data = std::unordered_map<T, U>{};
   for (size_t ix = 0; ix < size; ++ix) {
@@ -148,6 +467,40 @@ auto read_unordered_map(detail::isviewstream& ss) -> std::unordered_map<T, U> {
   return data;
 }
 
+/// @brief Check that the values of an array read from a state are within a
+/// range.
+///
+/// @tparam Derived The type of the array
+/// @param[in] data The values to check
+/// @param[in] lower The lower bound of the range (included)
+/// @param[in] upper The upper bound of the range (excluded)
+/// @return True if all the values are within the range
+template <typename Derived>
+auto in_range(const Eigen::DenseBase<Derived>& data, const int64_t lower,
+              const int64_t upper) -> bool {
+  const auto* first = data.derived().data();
+  return std::all_of(first, first + data.size(), [&](const int64_t item) {
+    return item >= lower && item < upper;
+  });
+}
+
+/// @brief Check that an array read from a state is a valid table of offsets
+/// of a compressed sparse row layout: it starts with 0, does not decrease and
+/// ends with the number of items listed.
+///
+/// @tparam Derived The type of the array
+/// @param[in] offsets The offsets to check
+/// @param[in] size The number of items listed
+/// @return True if the offsets are valid
+template <typename Derived>
+auto is_offsets(const Eigen::DenseBase<Derived>& offsets, const int64_t size)
+    -> bool {
+  const auto* first = offsets.derived().data();
+  const auto* last = first + offsets.size();
+  return offsets.size() != 0 && *first == 0 && *(last - 1) == size &&
+         std::is_sorted(first, last);
+}
+
 }  // namespace serialize
 }  // namespace detail
 }  // namespace fes
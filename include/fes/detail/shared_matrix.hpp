@@ -0,0 +1,125 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/detail/shared_matrix.hpp
+/// @brief Read-only matrices owning their values or borrowing external memory.
+#pragma once
+#include <Eigen/Core>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace fes {
+namespace detail {
+
+/// @brief Read-only matrix whose values are either owned by the matrix or
+/// borrowed from an external memory area, such as a mapped file.
+///
+/// The matrix is an Eigen::Map on its values, which are kept alive by an
+/// owner shared by the copies of the matrix: a matrix built from an Eigen
+/// matrix takes it over, a matrix borrowing external memory holds the owner
+/// of this memory. Copying a matrix does not copy its values.
+///
+/// @tparam T The type of the matrix elements.
+/// @tparam Rows The number of rows at compile time.
+/// @tparam Cols The number of columns at compile time.
+/// @tparam Options The storage options of the matrix.
+template <typename T, int Rows, int Cols,
+          int Options = Eigen::Matrix<T, Rows, Cols>::Options>
+class SharedMatrix
+    : public Eigen::Map<const Eigen::Matrix<T, Rows, Cols, Options>> {
+ public:
+  /// The type of the matrices owning their values.
+  using PlainMatrix = Eigen::Matrix<T, Rows, Cols, Options>;
+
+  /// The type of the view on the values.
+  using Base = Eigen::Map<const PlainMatrix>;
+
+  /// Build an empty matrix.
+  SharedMatrix()
+      : Base(nullptr, Rows == Eigen::Dynamic ? 0 : Rows,
+             Cols == Eigen::Dynamic ? 0 : Cols) {}
+
+  /// Build a matrix taking over the values of an Eigen matrix.
+  ///
+  /// @param[in] matrix The values of the matrix.
+  SharedMatrix(PlainMatrix matrix)
+      : SharedMatrix(std::make_shared<const PlainMatrix>(std::move(matrix))) {
+  }
+
+  /// Build a matrix borrowing external memory.
+  ///
+  /// @param[in] data The values of the matrix.
+  /// @param[in] rows The number of rows.
+  /// @param[in] cols The number of columns.
+  /// @param[in] owner The object keeping the memory alive as long as the
+  /// matrix or one of its copies uses it.
+  SharedMatrix(const T* data, const Eigen::Index rows, const Eigen::Index cols,
+               std::shared_ptr<const void> owner)
+      : Base(data, rows, cols), owner_(std::move(owner)) {}
+
+  /// Copy constructor: the copy shares the values of the matrix.
+  SharedMatrix(const SharedMatrix& other)
+      : Base(other.data(), other.rows(), other.cols()), owner_(other.owner_) {}
+
+  /// Move constructor.
+  SharedMatrix(SharedMatrix&& other) noexcept
+      : Base(other.data(), other.rows(), other.cols()),
+        owner_(std::move(other.owner_)) {
+    other.reset();
+  }
+
+  /// Default destructor.
+  ~SharedMatrix() = default;
+
+  /// Copy assignment: the matrix shares the values of the other one.
+  auto operator=(const SharedMatrix& other) -> SharedMatrix& {
+    if (this != &other) {
+      owner_ = other.owner_;
+      rebind(other.data(), other.rows(), other.cols());
+    }
+    return *this;
+  }
+
+  /// Move assignment.
+  auto operator=(SharedMatrix&& other) noexcept -> SharedMatrix& {
+    if (this != &other) {
+      owner_ = std::move(other.owner_);
+      rebind(other.data(), other.rows(), other.cols());
+      other.reset();
+    }
+    return *this;
+  }
+
+ private:
+  /// The object keeping the values alive.
+  std::shared_ptr<const void> owner_{};
+
+  /// Build a matrix from the Eigen matrix owning its values.
+  explicit SharedMatrix(std::shared_ptr<const PlainMatrix> matrix)
+      : Base(matrix->data(), matrix->rows(), matrix->cols()),
+        owner_(std::move(matrix)) {}
+
+  /// Map the matrix on other values.
+  inline auto rebind(const T* data, const Eigen::Index rows,
+                     const Eigen::Index cols) noexcept -> void {
+    new (static_cast<Base*>(this)) Base(data, rows, cols);
+  }
+
+  /// Make the matrix empty.
+  inline auto reset() noexcept -> void {
+    owner_.reset();
+    rebind(nullptr, Rows == Eigen::Dynamic ? 0 : Rows,
+           Cols == Eigen::Dynamic ? 0 : Cols);
+  }
+};
+
+/// @brief Alias for a read-only vector owning its values or borrowing
+/// external memory.
+/// @tparam T The type of the vector elements.
+template <typename T>
+using SharedVector = SharedMatrix<T, Eigen::Dynamic, 1>;
+
+}  // namespace detail
+}  // namespace fes
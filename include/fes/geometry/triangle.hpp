@@ -5,6 +5,7 @@
 /// @file include/fes/geometry/triangle.hpp
 /// @brief Triangle in Geographic Coordinate System
 #pragma once
+#include <array>
 #include <boost/geometry.hpp>
 #include <ostream>
 #include <sstream>
@@ -147,6 +148,71 @@ class Triangle : public triangle_t {
   }
 };
 
+/// @brief Geodetic triangle whose vertices are stored inline.
+///
+/// Unlike Triangle, whose ring is stored in a heap-allocated container, this
+/// triangle is a closed ring of four points held by value: building or copying
+/// it does not allocate memory. It provides the operations needed to locate a
+/// point in a mesh and to interpolate within the selected triangle.
+class StaticTriangle : public std::array<Point, 4> {
+ public:
+  /// Default constructor.
+  StaticTriangle() = default;
+
+  /// Construct a triangle from three points.
+  ///
+  /// @param[in] v1 The first vertex.
+  /// @param[in] v2 The second vertex.
+  /// @param[in] v3 The third vertex.
+  inline StaticTriangle(const Point &v1, const Point &v2, const Point &v3)
+      : std::array<Point, 4>{{v1, v2, v3, v1}} {}
+
+  /// Get the first vertex.
+  constexpr auto v1() const -> const Point & { return (*this)[0]; }
+
+  /// Get the second vertex.
+  constexpr auto v2() const -> const Point & { return (*this)[1]; }
+
+  /// Get the third vertex.
+  constexpr auto v3() const -> const Point & { return (*this)[2]; }
+
+  /// Returns the vertex index of the triangle corresponding to the given point,
+  /// or -1 if the point is not a vertex of the triangle.
+  ///
+  /// @param[in] point The point.
+  inline auto is_vertex(const Point &point) const -> int {
+    for (int ix = 0; ix < 3; ++ix) {
+      if (point == (*this)[ix]) {
+        return ix;
+      }
+    }
+    return -1;
+  }
+
+  /// Test if the point is inside or on the border of the triangle.
+  ///
+  /// @param[in] point The point.
+  /// @return True if the point is inside of or on the border of the triangle,
+  /// else false
+  /// @note The result is identical to the one of Triangle::covered_by.
+  inline auto covered_by(const geometry::Point &point) const -> bool {
+    return boost::geometry::covered_by(point, *this);
+  }
+
+  /// Convert the triangle to a Triangle.
+  inline explicit operator Triangle() const { return {v1(), v2(), v3()}; }
+
+  /// Compute the angles \f$\xi\f$ and \f$\eta\f$ of the reference right-angled
+  /// triangle in the Cartesian space.
+  ///
+  /// @param[in] point The point.
+  /// @return A tuple containing the angles  \f$\xi\f$ and \f$\eta\f$.
+  /// @warning The given point must be inside the triangle otherwise the result
+  /// is undefined.
+  auto reference_right_angled(const Point &point) const
+      -> std::tuple<double, double>;
+};
+
 }  // namespace geometry
 }  // namespace fes
 
@@ -225,6 +291,25 @@ struct interior_rings<fg::Triangle> {
   }
 };
 
+/// @brief Tag of the static triangle geometry.
+template <>
+struct tag<fg::StaticTriangle> {
+  /// @brief Type of the tag.
+  using type = ring_tag;
+};
+/// @brief Orientation of the static triangle geometry.
+template <>
+struct point_order<fg::StaticTriangle> {
+  /// @brief Orientation of the ring, identical to the one of Triangle.
+  static const order_selector value = counterclockwise;
+};
+/// @brief Closure of the static triangle geometry.
+template <>
+struct closure<fg::StaticTriangle> {
+  /// @brief The first vertex is repeated at the end of the ring.
+  static const closure_selector value = closed;
+};
+
 }  // namespace traits
 }  // namespace geometry
 }  // namespace boost
@@ -0,0 +1,124 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/mesh/bucket_grid.hpp
+/// @brief Spatial hash of the triangles of a mesh.
+#pragma once
+#include <Eigen/Core>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "fes/detail/shared_matrix.hpp"
+#include "fes/eigen.hpp"
+#include "fes/string_view.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// @brief Grid of buckets listing the triangles whose bounding box intersects
+/// each bucket.
+///
+/// The rows of the grid have a constant height. The number of buckets of each
+/// row decreases with the cosine of its latitude, so that the buckets have
+/// roughly the same size on the sphere. The triangles of each bucket are
+/// stored in a compressed sparse row layout, sorted by increasing index.
+class BucketGrid {
+ public:
+  /// Default constructor (empty grid).
+  BucketGrid() = default;
+
+  /// Build the grid of the buckets of a mesh.
+  ///
+  /// @param[in] lon The longitude coordinates of the mesh vertices.
+  /// @param[in] lat The latitude coordinates of the mesh vertices.
+  /// @param[in] triangles The mesh triangles.
+  /// @param[in] resolution The height of the buckets, in degrees. If 0, it is
+  /// derived from the mean size of the triangles. The resolution is coarsened
+  /// if needed to limit the number of buckets to kMaxBucketsPerTriangle times
+  /// the number of triangles, or kMinBuckets for small meshes.
+  BucketGrid(const Eigen::Ref<const Eigen::VectorXd>& lon,
+             const Eigen::Ref<const Eigen::VectorXd>& lat,
+             const Eigen::Ref<const Eigen::Matrix<int32_t, -1, 3>>& triangles,
+             double resolution = 0);
+
+  /// Maximum number of buckets per triangle of the mesh.
+  static constexpr int64_t kMaxBucketsPerTriangle = 4;
+
+  /// Number of buckets always allowed, whatever the size of the mesh.
+  static constexpr int64_t kMinBuckets = int64_t(1) << 20;
+
+  /// Get the triangles whose bounding box intersects the bucket containing a
+  /// given point.
+  ///
+  /// @param[in] lon The longitude of the point, in degrees.
+  /// @param[in] lat The latitude of the point, in degrees.
+  /// @return The range of the indices of the triangles.
+  auto candidates(double lon, double lat) const noexcept
+      -> std::pair<const int32_t*, const int32_t*>;
+
+  /// Get the height of the buckets, in degrees.
+  constexpr auto resolution() const noexcept -> double { return resolution_; }
+
+  /// Get the number of buckets of the grid.
+  inline auto size() const noexcept -> int64_t {
+    return columns_.size() == 0 ? 0 : columns_[columns_.size() - 1];
+  }
+
+  /// Check if the grid is empty.
+  inline auto empty() const noexcept -> bool { return size() == 0; }
+
+  /// Get the indices of the triangles listed in the buckets.
+  inline auto triangles() const noexcept
+      -> Eigen::Map<const Vector<int32_t>> const& {
+    return triangles_;
+  }
+
+  /// @brief Get a string representation of the grid state.
+  ///
+  /// @return The string representation of the grid state.
+  auto getstate() const -> std::string;
+
+  /// @brief Write the grid state to a stream, without building it in memory.
+  ///
+  /// @param[in,out] os The stream receiving the state (the bytes returned by
+  /// getstate()).
+  auto getstate(std::ostream& os) const -> void;
+
+  /// @brief Build a grid from serialized state.
+  ///
+  /// @param[in] data The serialized state.
+  /// @return The grid.
+  static auto setstate(const string_view& data) -> BucketGrid;
+
+  /// @brief Build a grid from a serialized state read from a stream.
+  ///
+  /// @param[in,out] is The stream providing the state.
+  /// @return The grid.
+  static auto setstate(std::istream& is) -> BucketGrid;
+
+ private:
+  /// Height of the buckets, in degrees.
+  double resolution_{};
+  /// Number of rows of the grid.
+  int64_t ny_{};
+  /// Index of the first bucket of each row (ny_ + 1 items).
+  detail::SharedVector<int64_t> columns_{};
+  /// Position of the first triangle of each bucket in triangles_ (size() + 1
+  /// items).
+  detail::SharedVector<int64_t> offsets_{};
+  /// Indices of the triangles listed in the buckets.
+  detail::SharedVector<int32_t> triangles_{};
+
+  /// Get the row of the grid containing a latitude.
+  auto row(double lat) const noexcept -> int64_t;
+
+  /// Get the column of a row containing a longitude.
+  auto column(double lon, int64_t row) const noexcept -> int64_t;
+};
+
+}  // namespace mesh
+}  // namespace fes
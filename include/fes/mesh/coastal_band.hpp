@@ -0,0 +1,162 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/mesh/coastal_band.hpp
+/// @brief Precomputed extrapolation stencils along the boundary of a mesh.
+#pragma once
+#include <Eigen/Core>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "fes/detail/shared_matrix.hpp"
+#include "fes/eigen.hpp"
+#include "fes/mesh/packed_rtree.hpp"
+#include "fes/string_view.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// @brief Raster of the cells located within the extrapolation distance of
+/// a mesh, each cell storing the stencil of the vertices that may be the
+/// nearest to the points it contains.
+///
+/// The k vertices nearest to a point of a cell are within the distance of the
+/// k-th vertex nearest to the center of the cell, increased by twice the
+/// distance between the center and the corners of the cell. The stencil of a
+/// cell lists these vertices with their ECEF coordinates, so that the nearest
+/// vertices of a point are found by scanning its stencil instead of searching
+/// the R-Tree, with the same result. The cells whose stencil has more than
+/// kMaxVertices vertices are not stored: their points are searched in the
+/// R-Tree.
+///
+/// A point located outside the mesh, but within the extrapolation distance of
+/// a vertex, is within this distance (increased by half the length of the
+/// longest edge) of a vertex of the boundary of the mesh. The raster therefore
+/// only covers a band around the boundary. The cells of the band are sorted
+/// by their position in a global longitude/latitude grid, and their stencils
+/// are stored in a compressed sparse row layout.
+class CoastalBand {
+ public:
+  /// Maximum number of vertices of a stencil.
+  static constexpr int64_t kMaxVertices = 96;
+
+  /// Maximum number of cells of the band.
+  static constexpr int64_t kMaxCells = int64_t(1) << 20;
+
+  /// Default constructor (empty band).
+  CoastalBand() = default;
+
+  /// Build the band of a mesh.
+  ///
+  /// @param[in] lon The longitude coordinates of the mesh vertices.
+  /// @param[in] lat The latitude coordinates of the mesh vertices.
+  /// @param[in] ecef The ECEF coordinates of the mesh vertices.
+  /// @param[in] boundary The vertices located on the boundary of the mesh.
+  /// @param[in] rtree The R-Tree of the vertices used by the mesh triangles.
+  /// @param[in] neighbors The number of nearest vertices searched by the
+  /// queries, limited to PackedRTree::kMaxNeighbors.
+  /// @param[in] max_distance The extrapolation distance, in meters.
+  /// @param[in] margin The distance, in meters, added to the extrapolation
+  /// distance to select the cells of the band (half the length of the
+  /// longest edge of the mesh).
+  /// @param[in] resolution The size of the cells, in degrees. If 0, it is
+  /// derived from the distance between the boundary vertices, and increased
+  /// if necessary so that the band has at most kMaxCells cells.
+  /// @throw std::invalid_argument if the band built with the given resolution
+  /// has more than kMaxCells cells.
+  CoastalBand(const Eigen::Ref<const Eigen::VectorXd>& lon,
+              const Eigen::Ref<const Eigen::VectorXd>& lat,
+              const Eigen::Ref<const Eigen::Matrix<double, -1, 3>>& ecef,
+              const Eigen::Ref<const Vector<int32_t>>& boundary,
+              const PackedRTree& rtree,
+              size_t neighbors, double max_distance, double margin,
+              double resolution = 0);
+
+  /// Search the vertices nearest to a point in the stencil of its cell.
+  ///
+  /// The neighbors found are those returned by PackedRTree::nearest.
+  ///
+  /// @param[in] lon The longitude of the point, in degrees.
+  /// @param[in] lat The latitude of the point, in degrees.
+  /// @param[in] point The ECEF coordinates of the point.
+  /// @param[in] k The number of neighbors to search.
+  /// @param[out] neighbors The neighbors found.
+  /// @return False if the point is not covered by a stencil of the band, or
+  /// if more neighbors are searched than when the band was built: the
+  /// neighbors must then be searched in the R-Tree.
+  auto nearest(double lon, double lat, const Eigen::Vector3d& point, size_t k,
+               PackedRTree::Neighbors& neighbors) const -> bool;
+
+  /// Get the extrapolation distance, in meters.
+  constexpr auto max_distance() const noexcept -> double {
+    return max_distance_;
+  }
+
+  /// Get the size of the cells, in degrees.
+  constexpr auto resolution() const noexcept -> double { return resolution_; }
+
+  /// Get the number of cells of the band.
+  inline auto size() const noexcept -> int64_t { return cells_.size(); }
+
+  /// Check if the band is empty.
+  inline auto empty() const noexcept -> bool { return cells_.size() == 0; }
+
+  /// Get the indices of the vertices of the stencils.
+  inline auto vertices() const noexcept
+      -> Eigen::Map<const Vector<int32_t>> const& {
+    return vertices_;
+  }
+
+  /// @brief Get a string representation of the band state.
+  ///
+  /// @return The string representation of the band state.
+  auto getstate() const -> std::string;
+
+  /// @brief Write the band state to a stream, without building it in memory.
+  ///
+  /// @param[in,out] os The stream receiving the state (the bytes returned by
+  /// getstate()).
+  auto getstate(std::ostream& os) const -> void;
+
+  /// @brief Build a band from serialized state.
+  ///
+  /// @param[in] data The serialized state.
+  /// @return The band.
+  static auto setstate(const string_view& data) -> CoastalBand;
+
+  /// @brief Build a band from a serialized state read from a stream.
+  ///
+  /// @param[in,out] is The stream providing the state.
+  /// @return The band.
+  static auto setstate(std::istream& is) -> CoastalBand;
+
+ private:
+  /// Extrapolation distance, in meters.
+  double max_distance_{};
+  /// Size of the cells, in degrees.
+  double resolution_{};
+  /// Number of columns of the global grid.
+  int64_t nx_{};
+  /// Number of nearest vertices covered by the stencils.
+  int64_t neighbors_{};
+  /// Position of the cells of the band in the global grid, sorted in
+  /// ascending order.
+  detail::SharedVector<int64_t> cells_{};
+  /// Position of the first vertex of each cell in vertices_ (size() + 1
+  /// items).
+  detail::SharedVector<int64_t> offsets_{};
+  /// Indices of the vertices of the stencils.
+  detail::SharedVector<int32_t> vertices_{};
+  /// ECEF coordinates of the vertices of the stencils, one per column.
+  detail::SharedMatrix<double, 3, -1> points_{};
+
+  /// Get the position in the global grid of the cell containing a point.
+  auto cell(double lon, double lat) const noexcept -> int64_t;
+};
+
+}  // namespace mesh
+}  // namespace fes
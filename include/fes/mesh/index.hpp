@@ -6,17 +6,30 @@
 /// @brief Mesh indexer
 #pragma once
 #include <Eigen/Core>
+#include <algorithm>
+#include <boost/container/static_vector.hpp>
 #include <boost/geometry.hpp>
+#include <cmath>
 #include <cstdint>
+#include <istream>
+#include <limits>
 #include <memory>
-#include <set>
+#include <ostream>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "fes/detail/math.hpp"
+#include "fes/detail/shared_matrix.hpp"
+#include "fes/eigen.hpp"
 #include "fes/geometry/box.hpp"
 #include "fes/geometry/ecef.hpp"
 #include "fes/geometry/point.hpp"
 #include "fes/geometry/triangle.hpp"
+#include "fes/mesh/bucket_grid.hpp"
+#include "fes/mesh/coastal_band.hpp"
+#include "fes/mesh/packed_rtree.hpp"
 #include "fes/string_view.hpp"
 
 namespace fes {
@@ -29,24 +42,41 @@ struct VertexAttribute {
   int32_t triangle_index;
 };
 
+/// @brief Structures used to locate the triangle containing a point.
+enum IndexType : uint8_t {
+  kRTree = 0x01,       //!< R-Tree of the mesh vertices
+  kBucketGrid = 0x02,  //!< Grid of buckets listing the triangles
+};
+
+/// Maximum number of triangles considered when searching the vertices nearest
+/// to a point located outside the mesh.
+constexpr size_t kMaxNearestTriangles = 128;
+
 /// @brief Result of a triangle query.
 ///
 /// This structure contains the result of a triangle query. It includes the
 /// triangle index, the query point, the selected triangle, and the nearest
 /// vertices from triangles closest to the query point when the point is
-/// outside the mesh.
+/// outside the mesh. All its members are stored inline, so that a query can
+/// be performed without allocating memory.
 struct TriangleQueryResult {
+  /// List of vertices, with a capacity sufficient to store all the vertices
+  /// of the nearest triangles.
+  using VertexList =
+      boost::container::static_vector<VertexAttribute,
+                                      3 * kMaxNearestTriangles>;
+
   /// The triangle index.
   std::int32_t index{-1};
   /// The query point used for the search.
   geometry::Point point{};
   /// The selected triangle.
-  geometry::Triangle triangle{};
+  geometry::StaticTriangle triangle{};
   /// List of nearest vertices from triangles closest to the query point.
-  std::vector<VertexAttribute> nearest_vertices{};
+  VertexList nearest_vertices{};
 
   /// Default constructor.
-  constexpr TriangleQueryResult() = default;
+  TriangleQueryResult() = default;
 
   /// @brief Constructs a TriangleQueryResult when the query point is inside the
   /// mesh.
@@ -56,16 +86,16 @@ struct TriangleQueryResult {
   /// weights.
   /// @param[in] triangle The selected triangle.
   inline TriangleQueryResult(const std::int32_t triangle_index,
-                             geometry::Point point, geometry::Triangle triangle)
-      : index(triangle_index), point(point), triangle(std::move(triangle)) {}
+                             geometry::Point point,
+                             const geometry::StaticTriangle& triangle)
+      : index(triangle_index), point(point), triangle(triangle) {}
 
   /// @brief Constructs a TriangleQueryResult when the query point is outside
   /// the mesh.
   /// @param nearest_vertices The nearest vertices from triangles closest to the
   /// query point.
   /// @param point The point to be used to calculate the interpolation weights.
-  inline TriangleQueryResult(std::vector<VertexAttribute> nearest_vertices,
-                             geometry::Point point)
+  inline TriangleQueryResult(VertexList nearest_vertices, geometry::Point point)
       : point(std::move(point)),
         nearest_vertices(std::move(nearest_vertices)) {}
 
@@ -78,18 +108,43 @@ struct TriangleQueryResult {
   inline auto is_valid() const noexcept {
     return is_inside() || !nearest_vertices.empty();
   }
+
+  /// @brief Reset the result to an undefined query of a point.
+  ///
+  /// @param[in] query_point The query point.
+  inline auto reset(const geometry::Point& query_point) noexcept -> void {
+    index = -1;
+    point = query_point;
+    nearest_vertices.clear();
+  }
 };
 
 /// %Index the triangles of a mesh.
 class Index : public std::enable_shared_from_this<Index> {
  public:
+  /// Maximum number of triangles crossed by a walk through the mesh.
+  static constexpr int kMaxWalkSteps = 16;
+
+  /// Number of vertices considered to extrapolate a point. A vertex being
+  /// shared by six triangles on average, their incident triangles nearly fill
+  /// the list of the nearest triangles.
+  static constexpr size_t kExtrapolationNeighbors = kMaxNearestTriangles / 6;
+
   /// Default constructor.
   ///
   /// @param[in] lon The longitude coordinates of the mesh vertices.
   /// @param[in] lat The latitude coordinates of the mesh vertices.
   /// @param[in] triangles The mesh triangles.
+  /// @param[in] type The structure used to locate the triangle containing a
+  /// point. The R-Tree is always built, because it is used to find the
+  /// vertices nearest to the points outside the mesh. With kBucketGrid, the
+  /// points are first located using a grid of buckets, the R-Tree being
+  /// queried only if no triangle of the bucket contains the point.
+  /// @param[in] resolution The height of the buckets, in degrees, used with
+  /// kBucketGrid. If 0, it is derived from the mean size of the triangles.
   Index(Eigen::VectorXd lon, Eigen::VectorXd lat,
-        Eigen::Matrix<int32_t, -1, 3> triangles);
+        Eigen::Matrix<int32_t, -1, 3> triangles, IndexType type = kRTree,
+        double resolution = 0);
 
   /// Search the triangle that contains a point. If such a triangle is not
   /// found, it returns the nearest triangle if it's within a given
@@ -101,6 +156,35 @@ class Index : public std::enable_shared_from_this<Index> {
   auto search(const geometry::Point& point, const double max_distance) const
       -> TriangleQueryResult;
 
+  /// Search the triangle that contains a point, storing the result in a
+  /// structure provided by the caller. This search does not allocate memory:
+  /// the candidate triangles and the nearest vertices are stored in
+  /// fixed-capacity containers.
+  ///
+  /// @param[in] point The point.
+  /// @param[in] max_distance The maximum distance to the nearest triangle.
+  /// @param[out] result The selected triangle.
+  auto search(const geometry::Point& point, const double max_distance,
+              TriangleQueryResult& result) const -> void;
+
+  /// Search the triangle that contains a point by walking through the mesh
+  /// from a given triangle. At each step, the walk crosses the edge opposite
+  /// to the vertex with the most negative barycentric coordinate of the point.
+  /// It stops after kMaxWalkSteps steps, or when it reaches the boundary of
+  /// the mesh, in which case the point must be searched with the R-Tree.
+  ///
+  /// This search is intended for successive queries of close points, such
+  /// as the samples of an along-track profile: the point is then usually
+  /// located in the starting triangle or in one of its neighbors.
+  ///
+  /// @param[in] point The point.
+  /// @param[in] start The index of the triangle from which the walk starts.
+  /// @param[out] result The selected triangle, updated only if the walk
+  /// succeeds.
+  /// @return True if a triangle containing the point was found.
+  auto walk(const geometry::Point& point, int32_t start,
+            TriangleQueryResult& result) const -> bool;
+
   /// Get the number of positions in the index
   inline auto n_positions() const noexcept -> size_t { return lon_.size(); }
 
@@ -110,19 +194,151 @@ class Index : public std::enable_shared_from_this<Index> {
   }
 
   /// Get the longitude coordinates of the mesh vertices.
-  constexpr auto lon() const noexcept -> Eigen::VectorXd const& { return lon_; }
+  inline auto lon() const noexcept -> Eigen::Map<const Eigen::VectorXd> const& {
+    return lon_;
+  }
 
   /// Get the latitude coordinates of the mesh vertices.
-  constexpr auto lat() const noexcept -> Eigen::VectorXd const& { return lat_; }
+  inline auto lat() const noexcept -> Eigen::Map<const Eigen::VectorXd> const& {
+    return lat_;
+  }
 
   /// Get the mesh triangles.
-  constexpr auto triangles() const noexcept
-      -> Eigen::Matrix<int32_t, -1, 3> const& {
+  inline auto triangles() const noexcept
+      -> Eigen::Map<const Eigen::Matrix<int32_t, -1, 3>> const& {
     return triangles_;
   }
 
+  /// Get the ECEF coordinates of the mesh vertices.
+  inline auto ecef() const noexcept
+      -> Eigen::Map<const Eigen::Matrix<double, -1, 3>> const& {
+    return ecef_;
+  }
+
+  /// Get the structure used to locate the triangle containing a point.
+  constexpr auto type() const noexcept -> IndexType { return type_; }
+
+  /// Get the grid of buckets (empty unless the index type is kBucketGrid).
+  constexpr auto bucket_grid() const noexcept -> const BucketGrid& {
+    return bucket_grid_;
+  }
+
+  /// Get the triangles incident to a vertex of the mesh.
+  ///
+  /// @param[in] vertex The index of the vertex.
+  /// @return The range of the indices of the triangles, sorted in ascending
+  /// order.
+  inline auto incident_triangles(const int32_t vertex) const noexcept
+      -> std::pair<const int32_t*, const int32_t*> {
+    return {vertex_triangles_.data() + vertex_offsets_[vertex],
+            vertex_triangles_.data() + vertex_offsets_[vertex + 1]};
+  }
+
+  /// Get the neighbors of the mesh triangles: the neighbor ``k`` of a
+  /// triangle shares the edge opposite to its vertex ``k``, or is -1 if this
+  /// edge lies on the boundary of the mesh.
+  inline auto neighbors() const noexcept
+      -> Eigen::Map<const Eigen::Matrix<int32_t, -1, 3>> const& {
+    return neighbors_;
+  }
+
+  /// @brief Precompute the reference transform of each triangle.
+  ///
+  /// The transform of a triangle is made of the coordinates of its first
+  /// vertex and of the inverse of the Jacobian of the mapping from the
+  /// reference right-angled triangle, the longitudes of the vertices being
+  /// unwrapped across the antimeridian. Once computed, the reference
+  /// coordinates of a point and its containment in a triangle are evaluated
+  /// with a few multiplications instead of being derived from the vertices at
+  /// each query. The table uses 48 bytes per triangle.
+  auto build_reference_transforms() -> void;
+
+  /// Check if the reference transforms of the triangles are precomputed.
+  inline auto has_reference_transforms() const noexcept -> bool {
+    return transforms_.cols() != 0;
+  }
+
+  /// Compute the coordinates of a point in the reference right-angled
+  /// triangle of a mesh triangle, using the precomputed transforms.
+  ///
+  /// @param[in] triangle The index of the triangle.
+  /// @param[in] point The point.
+  /// @return The coordinates (ξ, η) of the point, (0, 0) if the triangle is
+  /// degenerate.
+  /// @note The result is identical, to the rounding errors, to the one of
+  /// geometry::Triangle::reference_right_angled.
+  inline auto reference_right_angled(const int64_t triangle,
+                                     const geometry::Point& point) const
+      noexcept -> std::tuple<double, double> {
+    const auto transform = transforms_.col(triangle);
+    if (std::isnan(transform(2))) {
+      return {0.0, 0.0};
+    }
+    const auto dx =
+        detail::math::normalize_angle(point.lon() - transform(0), -180.0);
+    const auto dy = point.lat() - transform(1);
+    return {transform(2) * dx + transform(3) * dy,
+            transform(4) * dx + transform(5) * dy};
+  }
+
+  /// Check if a point is located in a triangle, using the precomputed
+  /// transforms.
+  ///
+  /// The test is carried out on the reference coordinates of the point, the
+  /// edges of the triangle being straight lines in the longitude/latitude
+  /// plane, as for the %LGP interpolation. The degenerate triangles never
+  /// contain any point.
+  ///
+  /// @param[in] triangle The index of the triangle.
+  /// @param[in] point The point.
+  /// @return True if the point is located inside or on the boundary of the
+  /// triangle.
+  inline auto covered_by(const int64_t triangle,
+                         const geometry::Point& point) const noexcept -> bool {
+    constexpr auto epsilon = 1e-12;
+    const auto transform = transforms_.col(triangle);
+    const auto dx =
+        detail::math::normalize_angle(point.lon() - transform(0), -180.0);
+    const auto dy = point.lat() - transform(1);
+    const auto x = transform(2) * dx + transform(3) * dy;
+    const auto y = transform(4) * dx + transform(5) * dy;
+    return x >= -epsilon && y >= -epsilon && x + y <= 1 + epsilon;
+  }
+
+  /// @brief Precompute the extrapolation stencils of the points located
+  /// around the mesh.
+  ///
+  /// Once built, the vertices nearest to a point located outside the mesh are
+  /// read from the stencil of the cell of the coastal band containing the
+  /// point, instead of being searched in the R-Tree. The stencils give the
+  /// same vertices as the R-Tree, so the extrapolated values do not depend on
+  /// the band. The points located outside the band, or in a cell whose
+  /// stencil would have more than CoastalBand::kMaxVertices vertices, are
+  /// searched in the R-Tree.
+  ///
+  /// @param[in] max_distance The extrapolation distance, in meters, defining
+  /// the width of the band.
+  /// @param[in] resolution The size of the cells of the band, in degrees. If
+  /// 0, it is derived from the distance between the boundary vertices.
+  auto build_coastal_band(double max_distance, double resolution = 0) -> void;
+
+  /// Check if the extrapolation stencils around the mesh are precomputed.
+  inline auto has_coastal_band() const noexcept -> bool {
+    return !coastal_band_.empty();
+  }
+
+  /// Get the extrapolation stencils (empty unless build_coastal_band was
+  /// called).
+  constexpr auto coastal_band() const noexcept -> const CoastalBand& {
+    return coastal_band_;
+  }
+
   /// @brief Get the indices of the triangles that intersect the bounding box.
   ///
+  /// The candidate triangles are selected using the R-Tree, so the cost of the
+  /// selection is proportional to the size of the box, not to the size of the
+  /// mesh.
+  ///
   /// @param[in] bbox The bounding box.
   /// @return The indices of the triangles that intersect the bounding box.
   auto selected_triangles(const geometry::Box& bbox) const
@@ -130,59 +346,109 @@ class Index : public std::enable_shared_from_this<Index> {
 
   /// @brief Get a string representation of the index state.
   ///
+  /// The state contains the search structures (R-Tree, adjacency tables and
+  /// grid of buckets) stored as flat arrays, so that they are restored
+  /// without being rebuilt.
+  ///
   /// @return The string representation of the index state.
   auto getstate() const -> std::string;
 
+  /// @brief Write the index state to a stream, without building it in memory.
+  ///
+  /// @param[in,out] os The stream receiving the state (the bytes returned by
+  /// getstate()).
+  auto getstate(std::ostream& os) const -> void;
+
   /// @brief Build an index from serialized state.
   ///
   /// @param[in] data The serialized state.
   /// @return The index.
   static auto setstate(const string_view& data) -> Index;
 
+  /// @brief Build an index from a serialized state read from a stream.
+  ///
+  /// The arrays of the index are read directly from the stream.
+  ///
+  /// @param[in,out] is The stream providing the state.
+  /// @return The index.
+  static auto setstate(std::istream& is) -> Index;
+
  private:
-  /// Values stored in the R*Tree : Vertex of the triangle in ECEF coordinates,
-  /// index of vertex (0, 1 or 2) and index of triangle.
-  using value_t =
-      std::pair<geometry::EarthCenteredEarthFixed, std::pair<int8_t, int32_t>>;
+  /// Default constructor used by the deserialization.
+  Index() = default;
 
-  /// R*Tree type
-  using rtree_t =
-      boost::geometry::index::rtree<value_t, boost::geometry::index::rstar<16>>;
+  // The arrays of an index restored from shared memory are borrowed from it.
 
   /// The latitude coordinates of the mesh vertices.
-  Eigen::VectorXd lon_;
+  detail::SharedVector<double> lon_;
 
   /// The longitude coordinates of the mesh vertices.
-  Eigen::VectorXd lat_;
+  detail::SharedVector<double> lat_;
 
   /// The indices of the mesh vertices that form each triangle.
-  Eigen::Matrix<int32_t, -1, 3> triangles_;
-
-  /// The R*Tree
-  rtree_t rtree_{};
-
-  /// Search the nearest triangles to a point in ECEF coordinates.
-  inline auto nearest(const geometry::EarthCenteredEarthFixed& cartesian_point,
-                      const size_t max_neighbors) const
-      -> std::pair<std::set<int32_t>, double> {
-    auto triangle_indices = std::set<int>();
-    auto min_distance = std::numeric_limits<double>::max();
-    std::for_each(rtree_.qbegin(boost::geometry::index::nearest(cartesian_point,
-                                                                max_neighbors)),
-                  rtree_.qend(),
-                  [&cartesian_point, &min_distance,
-                   &triangle_indices](const auto& item) -> void {
-                    triangle_indices.emplace(item.second.second);
-                    min_distance = std::min(
-                        min_distance,
-                        boost::geometry::distance(cartesian_point, item.first));
-                  });
-    return std::make_pair(std::move(triangle_indices), min_distance);
-  }
+  detail::SharedMatrix<int32_t, -1, 3> triangles_;
 
-  /// Build the selected triangle.
-  inline auto build_triangle(const int triangle_index) const
-      -> geometry::Triangle {
+  /// The neighbors of each triangle.
+  detail::SharedMatrix<int32_t, -1, 3> neighbors_;
+
+  /// The ECEF coordinates of the mesh vertices.
+  detail::SharedMatrix<double, -1, 3> ecef_;
+
+  /// Position of the first incident triangle of each vertex in
+  /// vertex_triangles_ (n_positions() + 1 items).
+  detail::SharedVector<int64_t> vertex_offsets_;
+
+  /// The triangles incident to each vertex, sorted by increasing index.
+  detail::SharedVector<int32_t> vertex_triangles_;
+
+  /// The length, in meters, of the longest edge of the mesh (chord between
+  /// the ECEF coordinates of its vertices).
+  double max_edge_length_{};
+
+  /// The reference transforms of the triangles: longitude and latitude of the
+  /// first vertex, then the inverse Jacobian (row-major) of the mapping from
+  /// the reference right-angled triangle. Empty if not precomputed.
+  detail::SharedMatrix<double, 6, -1> transforms_;
+
+  /// The R-Tree of the vertices used by the triangles, in ECEF coordinates.
+  PackedRTree rtree_{};
+
+  /// The structure used to locate the triangle containing a point.
+  IndexType type_{kRTree};
+
+  /// The grid of buckets.
+  BucketGrid bucket_grid_{};
+
+  /// The extrapolation stencils around the mesh.
+  CoastalBand coastal_band_{};
+
+  /// Indices of the triangles nearest to a point, sorted in ascending order.
+  using TriangleIndices =
+      boost::container::static_vector<int32_t, kMaxNearestTriangles>;
+
+  /// Search the triangles incident to the vertices nearest to a point in ECEF
+  /// coordinates.
+  ///
+  /// @param[in] cartesian_point The point.
+  /// @param[in] max_neighbors The number of vertices to search.
+  /// @param[out] triangle_indices The indices of the triangles incident to the
+  /// vertices found, limited to kMaxNearestTriangles.
+  /// @return The distance to the nearest vertex.
+  auto nearest(const geometry::EarthCenteredEarthFixed& cartesian_point,
+               size_t max_neighbors, TriangleIndices& triangle_indices) const
+      -> double;
+
+  /// Get the triangles incident to the given vertices.
+  ///
+  /// @param[in] neighbors The vertices, sorted by increasing distance.
+  /// @param[out] triangle_indices The indices of the triangles incident to the
+  /// vertices, limited to kMaxNearestTriangles.
+  auto incident_triangles(const PackedRTree::Neighbors& neighbors,
+                          TriangleIndices& triangle_indices) const -> void;
+
+  /// Build the vertices of the selected triangle.
+  inline auto build_static_triangle(const int triangle_index) const
+      -> geometry::StaticTriangle {
     const Eigen::Vector3i& vertex_indices = triangles_.row(triangle_index);
     const auto i0 = vertex_indices(0);
     const auto i1 = vertex_indices(1);
@@ -193,18 +459,23 @@ class Index : public std::enable_shared_from_this<Index> {
             geometry::Point(lon_(i2), lat_(i2))};
   }
 
+  /// Build the selected triangle.
+  inline auto build_triangle(const int triangle_index) const
+      -> geometry::Triangle {
+    return static_cast<geometry::Triangle>(
+        build_static_triangle(triangle_index));
+  }
+
   /// Filter the vertices of a triangle that are within a maximum distance from
   /// a given point.
   inline auto filter_nearby_vertices(
       const geometry::EarthCenteredEarthFixed& point, const int triangle_index,
       const double max_distance,
-      std::vector<VertexAttribute>& nearest_vertices) const -> void {
-    const Eigen::Vector3i& vertex_indices = triangles_.row(triangle_index);
+      TriangleQueryResult::VertexList& nearest_vertices) const -> void {
+    const auto query = Eigen::RowVector3d(point.x(), point.y(), point.z());
     for (uint8_t vertex_id = 0; vertex_id < 3; ++vertex_id) {
-      const auto vertex_index = vertex_indices(vertex_id);
-      const auto vertex = geometry::EarthCenteredEarthFixed(
-          geometry::Point(lon_(vertex_index), lat_(vertex_index)));
-      const auto distance = detail::geometry::distance(point, vertex);
+      const auto vertex_index = triangles_(triangle_index, vertex_id);
+      const auto distance = (ecef_.row(vertex_index) - query).norm();
       if (distance <= max_distance) {
         nearest_vertices.push_back({vertex_id, triangle_index});
       }
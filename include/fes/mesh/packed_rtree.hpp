@@ -0,0 +1,208 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/mesh/packed_rtree.hpp
+/// @brief Static R-Tree of points stored in flat arrays.
+#pragma once
+#include <Eigen/Core>
+#include <algorithm>
+#include <boost/container/static_vector.hpp>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "fes/detail/shared_matrix.hpp"
+#include "fes/eigen.hpp"
+#include "fes/string_view.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// @brief Static R-Tree of 3D points, packed with the Sort-Tile-Recursive
+/// algorithm.
+///
+/// The tree is built once and never modified. Its nodes are stored level by
+/// level in flat arrays: the children of the node ``i`` of a level are the
+/// items ``i * kNodeSize`` to ``(i + 1) * kNodeSize - 1`` of the level below,
+/// so that the tree is fully described by the bounding boxes of its nodes and
+/// by the points sorted in the order of the leaves. It can therefore be
+/// serialized and restored without being rebuilt. The queries do not allocate
+/// memory.
+class PackedRTree {
+ public:
+  /// Maximum number of children of a node.
+  static constexpr int64_t kNodeSize = 16;
+
+  /// Maximum number of neighbors returned by a nearest neighbor query.
+  static constexpr size_t kMaxNeighbors = 32;
+
+  /// Neighbors found by a query: distance and identifier of each point,
+  /// sorted by increasing distance.
+  using Neighbors =
+      boost::container::static_vector<std::pair<double, int32_t>,
+                                      kMaxNeighbors>;
+
+  /// Default constructor (empty tree).
+  PackedRTree() = default;
+
+  /// Build the tree.
+  ///
+  /// @param[in] points The coordinates of the points, one per column.
+  /// @param[in] ids The identifiers of the points.
+  PackedRTree(const Eigen::Ref<const Eigen::Matrix<double, 3, -1>>& points,
+              const Eigen::Ref<const Vector<int32_t>>& ids);
+
+  /// Get the number of points in the tree.
+  inline auto size() const noexcept -> int64_t { return ids_.size(); }
+
+  /// Check if the tree is empty.
+  inline auto empty() const noexcept -> bool { return ids_.size() == 0; }
+
+  /// Get the identifiers of the points, sorted in the order of the leaves.
+  inline auto ids() const noexcept -> Eigen::Map<const Vector<int32_t>> const& {
+    return ids_;
+  }
+
+  /// Search the points nearest to a given point.
+  ///
+  /// @param[in] point The point.
+  /// @param[in] k The number of neighbors to search, limited to
+  /// kMaxNeighbors.
+  /// @param[out] neighbors The neighbors found.
+  auto nearest(const Eigen::Vector3d& point, size_t k,
+               Neighbors& neighbors) const -> void;
+
+  /// Insert a point in a list of neighbors sorted by increasing distance,
+  /// keeping at most k neighbors.
+  ///
+  /// @param[in] distance The distance (or squared distance) of the point.
+  /// @param[in] id The identifier of the point.
+  /// @param[in] k The maximum number of neighbors kept.
+  /// @param[in,out] neighbors The neighbors found.
+  static inline auto insert(const double distance, const int32_t id,
+                            const size_t k, Neighbors& neighbors) -> void {
+    if (neighbors.size() == k && distance >= neighbors.back().first) {
+      return;
+    }
+    if (neighbors.size() == k) {
+      neighbors.pop_back();
+    }
+    auto item = std::make_pair(distance, id);
+    neighbors.insert(
+        std::upper_bound(neighbors.begin(), neighbors.end(), item,
+                         [](const std::pair<double, int32_t>& lhs,
+                            const std::pair<double, int32_t>& rhs) {
+                           return lhs.first < rhs.first;
+                         }),
+        item);
+  }
+
+  /// Call a function for each point located in a box.
+  ///
+  /// @param[in] min_corner The minimum corner of the box.
+  /// @param[in] max_corner The maximum corner of the box.
+  /// @param[in] function The function called with the identifier of each
+  /// point found.
+  template <typename Function>
+  auto query(const Eigen::Vector3d& min_corner,
+             const Eigen::Vector3d& max_corner, const Function& function) const
+      -> void {
+    if (!empty()) {
+      query(levels() - 1, 0, min_corner, max_corner, function);
+    }
+  }
+
+  /// @brief Get a string representation of the tree state.
+  ///
+  /// @return The string representation of the tree state.
+  auto getstate() const -> std::string;
+
+  /// @brief Write the tree state to a stream, without building it in memory.
+  ///
+  /// @param[in,out] os The stream receiving the state (the bytes returned by
+  /// getstate()).
+  auto getstate(std::ostream& os) const -> void;
+
+  /// @brief Build a tree from serialized state.
+  ///
+  /// @param[in] data The serialized state.
+  /// @return The tree.
+  static auto setstate(const string_view& data) -> PackedRTree;
+
+  /// @brief Build a tree from a serialized state read from a stream.
+  ///
+  /// @param[in,out] is The stream providing the state.
+  /// @return The tree.
+  static auto setstate(std::istream& is) -> PackedRTree;
+
+ private:
+  /// Coordinates of the points, sorted in the order of the leaves.
+  detail::SharedMatrix<double, 3, -1> points_{};
+  /// Identifiers of the points, sorted in the order of the leaves.
+  detail::SharedVector<int32_t> ids_{};
+  /// Bounding boxes of the nodes (minimum then maximum corner), level by
+  /// level from the leaves to the root.
+  detail::SharedMatrix<double, 6, -1> boxes_{};
+  /// Position of the first node of each level in boxes_ (number of levels + 1
+  /// items).
+  detail::SharedVector<int64_t> levels_{};
+
+  /// Get the number of levels of the tree.
+  inline auto levels() const noexcept -> int64_t { return levels_.size() - 1; }
+
+  /// Get the number of items below the nodes of a level: points for the
+  /// leaves, nodes of the level below otherwise.
+  inline auto children(const int64_t level) const noexcept -> int64_t {
+    return level == 0 ? size() : levels_[level] - levels_[level - 1];
+  }
+
+  /// Get the squared distance between a point and the box of a node.
+  inline auto distance2(const int64_t level, const int64_t node,
+                        const Eigen::Vector3d& point) const noexcept
+      -> double {
+    const auto box = boxes_.col(levels_[level] + node);
+    return (box.head<3>() - point)
+        .cwiseMax(point - box.tail<3>())
+        .cwiseMax(0)
+        .squaredNorm();
+  }
+
+  /// Search the nearest neighbors below a node.
+  auto nearest(int64_t level, int64_t node, const Eigen::Vector3d& point,
+               size_t k, Neighbors& neighbors) const -> void;
+
+  /// Call a function for each point located in a box below a node.
+  template <typename Function>
+  auto query(int64_t level, int64_t node, const Eigen::Vector3d& min_corner,
+             const Eigen::Vector3d& max_corner, const Function& function) const
+      -> void;
+};
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename Function>
+auto PackedRTree::query(const int64_t level, const int64_t node,
+                        const Eigen::Vector3d& min_corner,
+                        const Eigen::Vector3d& max_corner,
+                        const Function& function) const -> void {
+  const auto box = boxes_.col(levels_[level] + node);
+  if ((box.head<3>().array() > max_corner.array()).any() ||
+      (box.tail<3>().array() < min_corner.array()).any()) {
+    return;
+  }
+  const auto first = node * kNodeSize;
+  const auto last = std::min(first + kNodeSize, children(level));
+  for (auto ix = first; ix < last; ++ix) {
+    if (level != 0) {
+      query(level - 1, ix, min_corner, max_corner, function);
+    } else if ((points_.col(ix).array() >= min_corner.array()).all() &&
+               (points_.col(ix).array() <= max_corner.array()).all()) {
+      function(ids_[ix]);
+    }
+  }
+}
+
+}  // namespace mesh
+}  // namespace fes
@@ -0,0 +1,96 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/mesh/renumbering.hpp
+/// @brief Locality-improving renumbering of the meshes.
+#pragma once
+#include <Eigen/Core>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "fes/eigen.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// Number of bits used to quantize each coordinate of the Hilbert curve.
+constexpr int kHilbertBits = 16;
+
+/// @brief Get the position of a point on a Hilbert curve covering the
+/// longitude/latitude plane.
+///
+/// @param[in] lon The longitude of the point, in degrees.
+/// @param[in] lat The latitude of the point, in degrees.
+/// @return The position of the point along the curve.
+auto hilbert_index(double lon, double lat) noexcept -> uint64_t;
+
+/// @brief Get the order of the triangles of a mesh along a Hilbert curve.
+///
+/// Sorting the triangles by the position of their barycenter along the curve
+/// stores the triangles close in space close in memory.
+///
+/// @param[in] lon The longitude coordinates of the mesh vertices.
+/// @param[in] lat The latitude coordinates of the mesh vertices.
+/// @param[in] triangles The mesh triangles.
+/// @return The index of the original triangle stored at each new position.
+auto hilbert_order(const Eigen::VectorXd& lon, const Eigen::VectorXd& lat,
+                   const Eigen::Matrix<int32_t, -1, 3>& triangles)
+    -> Vector<int64_t>;
+
+/// @brief Get the order of the items referenced by the rows of a table, in
+/// the order in which they are first referenced.
+///
+/// This order gives the numbering of the vertices (or of the %LGP codes)
+/// matching a new order of the triangles: the items used by neighboring
+/// triangles are stored close in memory. The items that are never referenced
+/// are placed at the end, in their original order.
+///
+/// @param[in] table The table referencing the items, one row per triangle.
+/// @param[in] rows The order in which the rows are visited.
+/// @param[in] size The number of items.
+/// @return The index of the original item stored at each new position.
+template <typename Derived>
+auto first_touch_order(const Eigen::MatrixBase<Derived>& table,
+                       const Vector<int64_t>& rows, int64_t size)
+    -> Vector<int64_t>;
+
+/// @brief Get the inverse of a permutation.
+///
+/// @param[in] order The index of the original item stored at each new
+/// position.
+/// @return The new position of each original item.
+auto inverse_order(const Vector<int64_t>& order) -> Vector<int64_t>;
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename Derived>
+auto first_touch_order(const Eigen::MatrixBase<Derived>& table,
+                       const Vector<int64_t>& rows, const int64_t size)
+    -> Vector<int64_t> {
+  auto result = Vector<int64_t>(size);
+  auto visited = Vector<bool>::Constant(size, false).eval();
+  auto position = int64_t(0);
+  for (Eigen::Index ix = 0; ix < rows.size(); ++ix) {
+    for (Eigen::Index jx = 0; jx < table.cols(); ++jx) {
+      const auto item = static_cast<int64_t>(table(rows[ix], jx));
+      if (item < 0 || item >= size) {
+        throw std::invalid_argument("item index out of range: " +
+                                    std::to_string(item));
+      }
+      if (!visited[item]) {
+        visited[item] = true;
+        result[position++] = item;
+      }
+    }
+  }
+  for (auto item = int64_t(0); item < size; ++item) {
+    if (!visited[item]) {
+      result[position++] = item;
+    }
+  }
+  return result;
+}
+
+}  // namespace mesh
+}  // namespace fes
@@ -0,0 +1,155 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/netcdf/loader.hpp
+/// @brief Loading of the tidal models stored in NetCDF files.
+///
+/// These functions are only available if the library is built with the
+/// FES_ENABLE_NETCDF option.
+#pragma once
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "fes/constituent.hpp"
+#include "fes/mesh/index.hpp"
+#include "fes/tidal_model/cartesian.hpp"
+#include "fes/tidal_model/lgp.hpp"
+
+namespace fes {
+namespace netcdf {
+
+/// Bounding box: minimum longitude, minimum latitude, maximum longitude and
+/// maximum latitude.
+using BoundingBox = std::tuple<double, double, double, double>;
+
+/// @brief Description of a Cartesian tidal model stored in one NetCDF file
+/// per tidal constituent.
+struct CartesianSettings {
+  /// Path to the NetCDF file of each tidal constituent.
+  std::map<Constituent, std::string> paths{};
+  /// Name of the longitude variable.
+  std::string longitude{"lon"};
+  /// Name of the latitude variable.
+  std::string latitude{"lat"};
+  /// Name of the amplitude variable.
+  std::string amplitude{"amplitude"};
+  /// Name of the phase variable.
+  std::string phase{"phase"};
+  /// Tolerance used to determine if the longitude axis is circular.
+  double epsilon{1e-6};
+  /// Maximum distance, in meters, allowed to extrapolate the model.
+  double max_distance{0};
+  /// Tide type handled by the model.
+  TideType tide_type{kTide};
+  /// Tidal constituents considered as part of the model, but not defined by
+  /// the grids.
+  std::vector<Constituent> dynamic{};
+  /// Region to load. If not set, the whole grids are loaded.
+  boost::optional<BoundingBox> bbox{};
+};
+
+/// @brief Description of a %LGP tidal model stored in a NetCDF file.
+struct LGPSettings {
+  /// Path to the NetCDF file.
+  std::string path{};
+  /// Names of the tidal constituents to load. If empty, all the known
+  /// constituents are loaded.
+  std::vector<std::string> constituents{};
+  /// Name of the longitude variable.
+  std::string longitude{"lon"};
+  /// Name of the latitude variable.
+  std::string latitude{"lat"};
+  /// Name of the variable containing the vertices of the triangles.
+  std::string triangle{"triangle"};
+  /// Name of the variable containing the %LGP codes.
+  std::string codes{"codes"};
+  /// Pattern of the amplitude variables, `{constituent}` being replaced by
+  /// the name of the constituent.
+  std::string amplitude{"{constituent}_amplitude"};
+  /// Pattern of the phase variables.
+  std::string phase{"{constituent}_phase"};
+  /// Structure used to locate the triangles containing the points.
+  mesh::IndexType index{mesh::kRTree};
+  /// Whether to precompute the reference transforms of the triangles.
+  bool reference_transforms{false};
+  /// Whether to precompute the coastal extrapolation stencils (requires a
+  /// positive max_distance).
+  bool coastal_band{false};
+  /// Whether to store the values of the constituents in node-major order.
+  bool interleaved{false};
+  /// Whether to renumber the mesh along a Hilbert curve.
+  bool renumber{false};
+  /// Maximum distance, in meters, allowed to extrapolate the model.
+  double max_distance{0};
+  /// Tide type handled by the model.
+  TideType tide_type{kTide};
+  /// Tidal constituents considered as part of the model, but not defined by
+  /// the mesh.
+  std::vector<Constituent> dynamic{};
+  /// Region to load. If not set, the whole mesh is loaded.
+  boost::optional<BoundingBox> bbox{};
+};
+
+/// @brief Check if a variable is stored in double precision.
+///
+/// The precision of the amplitude variables determines the precision of the
+/// model to load: Complex128 for double precision values, Complex64
+/// otherwise.
+///
+/// @param[in] path Path to the NetCDF file.
+/// @param[in] variable Name of the variable.
+/// @return True if the variable is stored in double precision.
+auto is_double_precision(const std::string& path, const std::string& variable)
+    -> bool;
+
+/// @brief Load a Cartesian tidal model.
+///
+/// The files of the tidal constituents are processed concurrently. The
+/// amplitudes and phases are read by blocks of rows and converted straight
+/// into the complex grids of the model: the masked values become NaN, the
+/// scale factors and offsets are applied, and the phases expressed in degrees
+/// are converted to radians.
+///
+/// @tparam T The precision of the model.
+/// @param[in] settings The description of the model.
+/// @param[in] num_threads The number of threads to use. If 0, the number of
+/// threads is determined by the number of cores.
+/// @return The tidal model.
+template <typename T>
+auto load_cartesian(const CartesianSettings& settings, size_t num_threads = 0)
+    -> std::shared_ptr<tidal_model::Cartesian<T>>;
+
+/// @brief Load a %LGP1 tidal model.
+///
+/// The mesh is read first, then the tidal constituents are read concurrently
+/// and converted straight into the complex values of the model.
+///
+/// @tparam T The precision of the model.
+/// @param[in] settings The description of the model.
+/// @param[in] num_threads The number of threads to use. If 0, the number of
+/// threads is determined by the number of cores.
+/// @return The tidal model.
+template <typename T>
+auto load_lgp1(const LGPSettings& settings, size_t num_threads = 0)
+    -> std::shared_ptr<tidal_model::LGP1<T>>;
+
+/// @brief Load a %LGP2 tidal model.
+///
+/// @tparam T The precision of the model.
+/// @param[in] settings The description of the model.
+/// @param[in] num_threads The number of threads to use. If 0, the number of
+/// threads is determined by the number of cores.
+/// @return The tidal model.
+/// @see load_lgp1
+template <typename T>
+auto load_lgp2(const LGPSettings& settings, size_t num_threads = 0)
+    -> std::shared_ptr<tidal_model::LGP2<T>>;
+
+}  // namespace netcdf
+}  // namespace fes
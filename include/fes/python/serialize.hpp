@@ -0,0 +1,201 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/python/serialize.hpp
+/// @brief Serialization of the tidal models to Python bytes and files.
+#pragma once
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "fes/detail/isviewstream.hpp"
+#include "fes/detail/serialize.hpp"
+
+namespace fes {
+namespace python {
+
+/// @brief Stream buffer writing into a preallocated memory area.
+class FixedBuffer : public std::streambuf {
+ public:
+  /// @brief Constructor.
+  ///
+  /// @param[in] data The memory area to write into.
+  /// @param[in] size The size of the memory area.
+  FixedBuffer(char* data, size_t size) { setp(data, data + size); }
+};
+
+/// @brief Serialize an object directly into a Python bytes object.
+///
+/// The size of the state is computed first, so that the state is written
+/// once, into the bytes object, without intermediate string.
+///
+/// @tparam T The type of the object, providing a `getstate(std::ostream&)`
+/// method.
+/// @param[in] object The object to serialize.
+/// @param[in] out_of_band If set, the registry receiving the large arrays,
+/// which are then not written in the state.
+/// @return The serialized state.
+template <typename T>
+auto getstate(const T& object,
+              detail::serialize::OutOfBand* out_of_band = nullptr)
+    -> pybind11::bytes {
+  auto counter = detail::serialize::CountingBuffer();
+  {
+    std::ostream os(&counter);
+    auto discarded = detail::serialize::OutOfBand(
+        out_of_band != nullptr ? out_of_band->min_size() : 0);
+    if (out_of_band != nullptr) {
+      discarded.attach(os);
+    }
+    object.getstate(os);
+  }
+  auto* bytes = PyBytes_FromStringAndSize(
+      nullptr, static_cast<Py_ssize_t>(counter.size()));
+  if (bytes == nullptr) {
+    throw pybind11::error_already_set();
+  }
+  auto result = pybind11::reinterpret_steal<pybind11::bytes>(bytes);
+  FixedBuffer buffer(PyBytes_AS_STRING(bytes), counter.size());
+  std::ostream os(&buffer);
+  if (out_of_band != nullptr) {
+    out_of_band->attach(os);
+  }
+  object.getstate(os);
+  return result;
+}
+
+/// @brief Contiguous view of the memory of a Python object supporting the
+/// buffer protocol.
+class BufferView {
+ public:
+  /// @brief Constructor.
+  ///
+  /// @param[in] object The object to view.
+  explicit BufferView(const pybind11::handle& object) {
+    if (PyObject_GetBuffer(object.ptr(), &view_, PyBUF_C_CONTIGUOUS) != 0) {
+      throw pybind11::error_already_set();
+    }
+  }
+
+  /// @brief Destructor.
+  ~BufferView() { PyBuffer_Release(&view_); }
+
+  BufferView(const BufferView&) = delete;
+  auto operator=(const BufferView&) -> BufferView& = delete;
+
+  /// @brief Get the viewed memory area.
+  inline auto buffer() const -> detail::serialize::OutOfBand::Buffer {
+    return {static_cast<const char*>(view_.buf),
+            static_cast<size_t>(view_.len)};
+  }
+
+  /// @brief Check if the viewed memory area is read-only.
+  inline auto readonly() const noexcept -> bool { return view_.readonly != 0; }
+
+ private:
+  /// The view of the memory.
+  Py_buffer view_{};
+};
+
+/// @brief Implement `__reduce_ex__` for a serializable object.
+///
+/// With the pickle protocol 5, the large arrays of the object are exported
+/// as `pickle.PickleBuffer` objects referencing the memory of the object, so
+/// that they can be transferred out-of-band, without copy. The other
+/// protocols use the default reduction, calling `__getstate__`.
+///
+/// @tparam T The type of the object, providing a `getstate(std::ostream&)`
+/// method.
+/// @param[in] self The Python object to reduce.
+/// @param[in] protocol The pickle protocol.
+/// @return The reduction of the object.
+template <typename T>
+auto reduce_ex(const pybind11::object& self, const int protocol)
+    -> pybind11::object {
+  auto builtins = pybind11::module::import("builtins");
+  if (protocol < 5) {
+    return builtins.attr("object").attr("__reduce_ex__")(self, protocol);
+  }
+  auto out_of_band = detail::serialize::OutOfBand();
+  auto state = pybind11::list();
+  state.append(getstate(self.cast<const T&>(), &out_of_band));
+  auto pickle_buffer = pybind11::module::import("pickle").attr("PickleBuffer");
+  for (const auto& item : out_of_band.buffers()) {
+    // The array keeps the object alive while the buffer is referenced.
+    auto array = pybind11::array(pybind11::dtype("uint8"),
+                                 {static_cast<pybind11::ssize_t>(item.second)},
+                                 {static_cast<pybind11::ssize_t>(1)},
+                                 item.first, self);
+    array.attr("flags").attr("writeable") = false;
+    state.append(pickle_buffer(array));
+  }
+  return pybind11::make_tuple(
+      pybind11::module::import("copyreg").attr("__newobj__"),
+      pybind11::make_tuple(self.get_type()), pybind11::tuple(state));
+}
+
+/// @brief Restore an object from its pickled state.
+///
+/// The state is either the bytes returned by getstate(), or the tuple built
+/// by reduce_ex() holding the state and the arrays stored out-of-band. If the
+/// received buffers are read-only, such as those of a mapped file, the object
+/// borrows them and keeps them alive; otherwise, they are copied into the
+/// object.
+///
+/// @tparam T The type of the object, providing a static
+/// `setstate(std::istream&)` method.
+/// @param[in] state The pickled state.
+/// @return The object restored.
+template <typename T>
+auto setstate(const pybind11::object& state) -> T {
+  if (!pybind11::isinstance<pybind11::tuple>(state)) {
+    char* data = nullptr;
+    pybind11::ssize_t length = 0;
+    if (PyBytes_AsStringAndSize(state.ptr(), &data, &length) != 0) {
+      throw pybind11::error_already_set();
+    }
+    return T::setstate(string_view(data, static_cast<size_t>(length)));
+  }
+  auto items = state.cast<pybind11::tuple>();
+  if (items.size() == 0) {
+    throw std::invalid_argument("invalid tidal model state");
+  }
+  char* data = nullptr;
+  pybind11::ssize_t length = 0;
+  if (PyBytes_AsStringAndSize(items[0].ptr(), &data, &length) != 0) {
+    throw pybind11::error_already_set();
+  }
+  using Views = std::vector<std::unique_ptr<BufferView>>;
+  auto views = std::unique_ptr<Views>(new Views());
+  auto buffers = std::vector<detail::serialize::OutOfBand::Buffer>();
+  auto readonly = true;
+  for (size_t ix = 1; ix < items.size(); ++ix) {
+    views->emplace_back(new BufferView(items[ix]));
+    buffers.push_back(views->back()->buffer());
+    readonly = readonly && views->back()->readonly();
+  }
+  auto owner = std::shared_ptr<const void>();
+  if (readonly && !buffers.empty()) {
+    // The views may be released by a thread that does not hold the GIL.
+    owner.reset(views.release(), [](const Views* item) {
+      pybind11::gil_scoped_acquire gil;
+      delete item;
+    });
+  }
+  auto out_of_band =
+      detail::serialize::OutOfBand(std::move(buffers), std::move(owner));
+  detail::isviewstream ss(string_view(data, static_cast<size_t>(length)));
+  out_of_band.attach(ss);
+  return T::setstate(ss);
+}
+
+}  // namespace python
+}  // namespace fes
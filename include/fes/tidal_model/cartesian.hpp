@@ -5,9 +5,12 @@
 /// @file include/fes/tidal_model/cartesian.hpp
 /// @brief Cartesian tidal model
 #pragma once
+#include <istream>
 #include <limits>
 #include <memory>
+#include <ostream>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -15,6 +18,7 @@
 #include "fes/axis.hpp"
 #include "fes/detail/grid.hpp"
 #include "fes/detail/isviewstream.hpp"
+#include "fes/detail/nearest_cell_table.hpp"
 #include "fes/detail/serialize.hpp"
 #include "fes/string_view.hpp"
 
@@ -33,10 +37,15 @@ class Cartesian : public AbstractTidalModel<T> {
   /// @param[in] lat The latitude axis.
   /// @param[in] tide_type The tide type handled by the model.
   /// @param[in] row_major Whether the data is stored in longitude-major order.
+  /// @param[in] max_distance The maximum distance, in meters, allowed to
+  /// extrapolate the wave model from the nearest defined grid cells. By
+  /// default, extrapolation is disabled, all points surrounded by undefined
+  /// cells will be considered undefined.
   Cartesian(Axis lon, Axis lat, const TideType tide_type,
-            const bool row_major = true)
+            const bool row_major = true, const double max_distance = 0)
       : AbstractTidalModel<T>(tide_type),
         row_major_(row_major),
+        max_distance_(max_distance),
         lon_(std::move(lon)),
         lat_(std::move(lat)) {}
 
@@ -49,6 +58,9 @@ class Cartesian : public AbstractTidalModel<T> {
     if (wave.size() != lon_.size() * lat_.size()) {
       throw std::invalid_argument("wave size does not match expected size");
     }
+    if (max_distance_ > 0) {
+      update_nearest_cells(wave);
+    }
     this->data_.emplace(ident, std::move(wave));
   }
 
@@ -85,25 +97,141 @@ class Cartesian : public AbstractTidalModel<T> {
   /// @return The latitude axis.
   constexpr auto lat() const noexcept -> const Axis& { return lat_; }
 
+  /// Whether the data is stored in longitude-major order.
+  constexpr auto row_major() const noexcept -> bool { return row_major_; }
+
+  /// Get the maximum distance, in meters, allowed to extrapolate the wave
+  /// model.
+  ///
+  /// @return The maximum distance allowed to extrapolate the wave model.
+  constexpr auto max_distance() const noexcept -> double {
+    return max_distance_;
+  }
+
+  /// Get the table of the nearest defined cells used to extrapolate the wave
+  /// model (empty if the extrapolation is disabled).
+  constexpr auto nearest_cells() const noexcept
+      -> const detail::NearestCellTable& {
+    return nearest_cells_;
+  }
+
   /// Serialize the tidal model.
   ///
   auto getstate() const -> std::string;
 
+  /// Serialize the tidal model to a stream, without building its state in
+  /// memory.
+  ///
+  /// @param[in,out] os The stream receiving the state (the bytes returned by
+  /// getstate()).
+  auto getstate(std::ostream& os) const -> void;
+
   /// Deserialize the tidal model.
   ///
   /// @param[in] data The serialized tidal model.
   /// @return The tidal model.
   static auto setstate(const string_view& data) -> Cartesian<T>;
 
+  /// Deserialize the tidal model from a stream.
+  ///
+  /// The grids of the constituents are read directly from the stream.
+  ///
+  /// @param[in,out] is The stream providing the serialized tidal model.
+  /// @return The tidal model.
+  static auto setstate(std::istream& is) -> Cartesian<T>;
+
  private:
   /// Whether the data is stored in longitude-major order.
   bool row_major_;
+  /// The maximum distance allowed to extrapolate the wave model.
+  double max_distance_;
   /// Longitude axis.
   Axis lon_;
   /// Latitude axis.
   Axis lat_;
+  /// Nearest defined cell of the undefined cells located at less than
+  /// max_distance_ from the defined cells. Empty if extrapolation is disabled.
+  detail::NearestCellTable nearest_cells_{};
+
+  /// Update the table of the nearest defined cells with the undefined values
+  /// of a new tidal constituent.
+  ///
+  /// @param[in] wave The tidal constituent added to the model.
+  auto update_nearest_cells(const Vector<std::complex<T>>& wave) -> void;
+
+  /// Extrapolate the tidal model at a given point by replacing the undefined
+  /// grid corners surrounding the point by their nearest defined cells.
+  ///
+  /// @param[in] i1 The first longitude index surrounding the point.
+  /// @param[in] i2 The second longitude index surrounding the point.
+  /// @param[in] j1 The first latitude index surrounding the point.
+  /// @param[in] j2 The second latitude index surrounding the point.
+  /// @param[in] wxy The bilinear weights of the point.
+  /// @param[out] quality The number of grid cells used to extrapolate,
+  /// negated, or kUndefined if no defined cell is close enough.
+  /// @param[inout] acc The accelerator to use.
+  auto extrapolate(int64_t i1, int64_t i2, int64_t j1, int64_t j2,
+                   const std::tuple<double, double, double, double>& wxy,
+                   Quality& quality, Accelerator* acc) const -> void;
 };
 
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Cartesian<T>::update_nearest_cells(const Vector<std::complex<T>>& wave)
+    -> void {
+  auto is_defined = [](const std::complex<T>& value) -> bool {
+    return !std::isnan(value.real()) && !std::isnan(value.imag());
+  };
+  auto valid = Vector<bool>(wave.size());
+  auto rebuild = nearest_cells_.empty();
+  for (Eigen::Index ix = 0; ix < wave.size(); ++ix) {
+    valid(ix) = is_defined(wave(ix)) &&
+                (nearest_cells_.empty() || nearest_cells_.is_valid(ix));
+    // The table is rebuilt only if the new constituent is undefined where the
+    // previous ones are defined.
+    rebuild |=
+        !valid(ix) && !nearest_cells_.empty() && nearest_cells_.is_valid(ix);
+  }
+  if (rebuild) {
+    nearest_cells_ = detail::NearestCellTable(lon_, lat_, valid, row_major_,
+                                              max_distance_);
+  }
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Cartesian<T>::extrapolate(
+    const int64_t i1, const int64_t i2, const int64_t j1, const int64_t j2,
+    const std::tuple<double, double, double, double>& wxy, Quality& quality,
+    Accelerator* acc) const -> void {
+  acc->clear();
+  auto n = int64_t{0};
+  auto grid = detail::Grid<std::complex<T>>(
+      nullptr, static_cast<size_t>(lon_.size()),
+      static_cast<size_t>(lat_.size()), row_major_);
+
+  // Value of a grid corner, or of its nearest defined cell if the corner is
+  // undefined.
+  auto corner = [&](const int64_t x, const int64_t y) -> std::complex<double> {
+    auto index = nearest_cells_(grid.index(x, y));
+    return index == -1 ? detail::math::construct_nan<std::complex<double>>()
+                       : static_cast<std::complex<double>>(grid.data()[index]);
+  };
+
+  for (const auto& item : this->data_) {
+    grid.data(item.second.data());
+    auto value = detail::math::bilinear_interpolation<std::complex<double>>(
+        std::get<0>(wxy), std::get<1>(wxy), std::get<2>(wxy), std::get<3>(wxy),
+        corner(i1, j1), corner(i1, j2), corner(i2, j1), corner(i2, j2), n);
+    if (std::isnan(value.real()) || std::isnan(value.imag())) {
+      quality = kUndefined;
+      return;
+    }
+    acc->emplace_back(item.first, value);
+  }
+  quality = static_cast<Quality>(-n);
+}
+
 // /////////////////////////////////////////////////////////////////////////////
 template <typename T>
 auto Cartesian<T>::interpolate(const geometry::Point& point, Quality& quality,
@@ -158,7 +286,14 @@ auto Cartesian<T>::interpolate(const geometry::Point& point, Quality& quality,
     // The computed value lies within the grid boundaries, but it is NaN (not a
     // number).
     if (std::isnan(value.real()) || std::isnan(value.imag())) {
-      return reset_values_to_undefined();
+      if (nearest_cells_.empty()) {
+        return reset_values_to_undefined();
+      }
+      // The point is surrounded by undefined cells, but the extrapolation is
+      // enabled: we use the nearest defined cells.
+      extrapolate(i1, i2, j1, j2, wxy, quality, acc);
+      return quality == kUndefined ? reset_values_to_undefined()
+                                   : acc->values();
     }
     acc->emplace_back(item.first, value);
   }
@@ -172,28 +307,42 @@ template <typename T>
 auto Cartesian<T>::getstate() const -> std::string {
   auto ss = std::stringstream();
   ss.exceptions(std::stringstream::failbit);
-  detail::serialize::write_data(ss, row_major_);
-  detail::serialize::write_string(ss, lon_.getstate());
-  detail::serialize::write_string(ss, lat_.getstate());
-  detail::serialize::write_data(ss, this->tide_type_);
-  detail::serialize::write_constituent_map(ss, this->data_);
+  getstate(ss);
   return ss.str();
 }
 
+template <typename T>
+auto Cartesian<T>::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_data(os, row_major_);
+  detail::serialize::write_object(os, lon_);
+  detail::serialize::write_object(os, lat_);
+  detail::serialize::write_data(os, this->tide_type_);
+  detail::serialize::write_constituent_map(os, this->data_);
+  detail::serialize::write_data(os, max_distance_);
+  detail::serialize::write_matrix(os, nearest_cells_.nearest());
+}
+
 template <typename T>
 auto Cartesian<T>::setstate(const string_view& data) -> Cartesian<T> {
   detail::isviewstream ss(data);
-  ss.exceptions(std::stringstream::failbit);
+  return Cartesian<T>::setstate(ss);
+}
+
+template <typename T>
+auto Cartesian<T>::setstate(std::istream& is) -> Cartesian<T> {
   try {
-    auto row_major = detail::serialize::read_data<bool>(ss);
-    auto lon = Axis::setstate(detail::serialize::read_string(ss));
-    auto lat = Axis::setstate(detail::serialize::read_string(ss));
-    auto tide_type = detail::serialize::read_data<TideType>(ss);
+    auto row_major = detail::serialize::read_data<bool>(is);
+    auto lon = detail::serialize::read_object<Axis>(is);
+    auto lat = detail::serialize::read_object<Axis>(is);
+    auto tide_type = detail::serialize::read_data<TideType>(is);
     auto model =
         Cartesian<T>(std::move(lon), std::move(lat), tide_type, row_major);
     model.data_ =
         detail::serialize::read_constituent_map<Constituent, std::complex<T>>(
-            ss);
+            is);
+    model.max_distance_ = detail::serialize::read_data<double>(is);
+    model.nearest_cells_ = detail::NearestCellTable(
+        detail::serialize::read_matrix<int32_t, Eigen::Dynamic, 1>(is));
     return model;
   } catch (const std::exception&) {
     throw std::invalid_argument("invalid tidal model state");
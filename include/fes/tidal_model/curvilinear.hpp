@@ -0,0 +1,447 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/tidal_model/curvilinear.hpp
+/// @brief Curvilinear tidal model
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "fes/abstract_tidal_model.hpp"
+#include "fes/detail/isviewstream.hpp"
+#include "fes/detail/math.hpp"
+#include "fes/detail/region_lookup.hpp"
+#include "fes/detail/serialize.hpp"
+#include "fes/eigen.hpp"
+#include "fes/string_view.hpp"
+
+namespace fes {
+namespace tidal_model {
+
+/// @brief A class representing an accelerator for curvilinear tidal models.
+///
+/// This class is used to accelerate the interpolation of curvilinear tidal
+/// models by caching the grid cell selected for the last point, from which
+/// the cell containing the next point is searched by walking through the
+/// neighboring cells.
+class CurvilinearAccelerator : public Accelerator {
+ public:
+  /// Default constructor.
+  /// @param[in] formulae The formulae used to calculate the astronomic angle.
+  /// @param[in] time_tolerance The time in seconds during which astronomical
+  /// angles are considered constant. The default value is 0 seconds, indicating
+  /// that astronomical angles do not remain constant with time.
+  /// @param[in] n_constituents The number of tidal constituents handled by the
+  /// tidal model.
+  CurvilinearAccelerator(const angle::Formulae& formulae,
+                         const double time_tolerance,
+                         const size_t n_constituents)
+      : Accelerator(formulae, time_tolerance, n_constituents) {}
+
+  /// Default destructor.
+  virtual ~CurvilinearAccelerator() = default;
+
+  /// Set the selected cell.
+  ///
+  /// @param[in] i The first index of the lower-left corner of the cell.
+  /// @param[in] j The second index of the lower-left corner of the cell.
+  constexpr auto set(const int64_t i, const int64_t j) noexcept -> void {
+    i_ = i;
+    j_ = j;
+  }
+
+  /// True if a cell is cached.
+  constexpr auto has_cell() const noexcept -> bool { return i_ != -1; }
+
+  /// Get the first index of the selected cell.
+  constexpr auto i() const noexcept -> int64_t { return i_; }
+
+  /// Get the second index of the selected cell.
+  constexpr auto j() const noexcept -> int64_t { return j_; }
+
+ private:
+  /// The first index of the selected cell (-1 if no cell is selected).
+  int64_t i_{-1};
+  /// The second index of the selected cell.
+  int64_t j_{-1};
+};
+
+/// @brief %Curvilinear tidal model.
+///
+/// The wave models are defined on a structured grid whose node coordinates
+/// are given by two-dimensional longitude and latitude arrays, such as the
+/// tripolar grids of ocean models. The values are interpolated with a
+/// bilinear interpolation in the index space of the grid cell containing the
+/// point. The cell is located using the cell cached by the accelerator and a
+/// walk through the neighboring cells, or, failing that, the candidate cells
+/// listed by a coarse lookup raster built once.
+///
+/// The node (i, j) of the grid is stored at the position i * ny + j of the
+/// wave vectors, ny being the number of columns of the coordinate arrays
+/// (i.e. the order of a C-contiguous array).
+///
+/// @tparam T The type of the tidal model.
+template <typename T>
+class Curvilinear : public AbstractTidalModel<T> {
+ public:
+  /// Build a curvilinear tidal model from the coordinates of its nodes.
+  ///
+  /// @param[in] lon The longitudes of the grid nodes, in degrees.
+  /// @param[in] lat The latitudes of the grid nodes, in degrees.
+  /// @param[in] tide_type The tide type handled by the model.
+  /// @param[in] resolution The size, in degrees, of the cells of the lookup
+  /// raster used to locate the grid cells. If zero, the resolution is
+  /// derived from the mean size of the grid cells.
+  Curvilinear(Matrix<double> lon, Matrix<double> lat,
+              const TideType tide_type, const double resolution = 0)
+      : AbstractTidalModel<T>(tide_type),
+        lon_(std::move(lon)),
+        lat_(std::move(lat)) {
+    if (lon_.rows() != lat_.rows() || lon_.cols() != lat_.cols()) {
+      throw std::invalid_argument(
+          "longitude and latitude must have the same shape");
+    }
+    if (lon_.rows() < 2 || lon_.cols() < 2) {
+      throw std::invalid_argument("the grid must contain at least 2x2 nodes");
+    }
+    initialize(resolution);
+  }
+
+  /// Create a new instance of the CurvilinearAccelerator class to speed up the
+  /// interpolation.
+  ///
+  /// @param[in] formulae The formulae used to calculate the astronomic angle.
+  /// @param[in] time_tolerance The time in seconds during which astronomical
+  /// angles are considered constant. The default value is 0 seconds, indicating
+  /// that astronomical angles do not remain constant with time.
+  /// @return A pointer to the newly created CurvilinearAccelerator instance.
+  auto accelerator(const angle::Formulae& formulae,
+                   const double time_tolerance) const -> Accelerator* override {
+    return new CurvilinearAccelerator(formulae, time_tolerance,
+                                      this->data_.size());
+  }
+
+  /// Add a tidal constituent to the model.
+  ///
+  /// @param[in] ident The tidal constituent identifier.
+  /// @param[in] wave The tidal constituent modelled.
+  inline auto add_constituent(const Constituent ident,
+                              Vector<std::complex<T>> wave) -> void override {
+    if (wave.size() != lon_.size()) {
+      throw std::invalid_argument("wave size does not match expected size");
+    }
+    this->data_.emplace(ident, std::move(wave));
+  }
+
+  /// Interpolate the tidal constituents at a given point.
+  ///
+  /// @param[in] point The point to interpolate at.
+  /// @param[out] quality The number of grid nodes used to interpolate, or
+  /// kUndefined if the point is outside the grid or surrounded by undefined
+  /// values.
+  /// @param[inout] acc The accelerator to use.
+  /// @return The interpolated tidal constituents.
+  auto interpolate(const geometry::Point& point, Quality& quality,
+                   Accelerator* acc) const -> const ConstituentValues& override;
+
+  /// Get the longitudes of the grid nodes.
+  constexpr auto lon() const noexcept -> const Matrix<double>& { return lon_; }
+
+  /// Get the latitudes of the grid nodes.
+  constexpr auto lat() const noexcept -> const Matrix<double>& { return lat_; }
+
+  /// Get the size, in degrees, of the cells of the lookup raster.
+  constexpr auto resolution() const noexcept -> double {
+    return lookup_.resolution();
+  }
+
+  /// Serialize the tidal model.
+  ///
+  /// @return The serialized tidal model.
+  auto getstate() const -> std::string;
+
+  /// Deserialize the tidal model.
+  ///
+  /// @param[in] data The serialized tidal model.
+  /// @return The deserialized tidal model.
+  static auto setstate(const string_view& data) -> Curvilinear<T>;
+
+ private:
+  /// Maximum number of cells crossed when walking from the cached cell.
+  static constexpr int kMaxWalkSteps = 8;
+
+  /// Longitudes of the grid nodes.
+  Matrix<double> lon_;
+  /// Latitudes of the grid nodes.
+  Matrix<double> lat_;
+  /// Raster listing the grid cells covering each of its cells.
+  detail::RegionLookup lookup_{};
+
+  /// Build the lookup raster.
+  ///
+  /// @param[in] resolution The size of the raster cells, in degrees, or zero
+  /// to derive it from the size of the grid cells.
+  auto initialize(double resolution) -> void;
+
+  /// Computes the coordinates of a point in the index space of a grid cell.
+  ///
+  /// @param[in] point The point to locate.
+  /// @param[in] i The first index of the lower-left corner of the cell.
+  /// @param[in] j The second index of the lower-left corner of the cell.
+  /// @param[out] s The coordinate of the point along the first dimension.
+  /// @param[out] t The coordinate of the point along the second dimension.
+  /// @return False if the coordinates cannot be computed (degenerate cell) or
+  /// if the Newton iterations did not converge.
+  auto inverse_bilinear(const geometry::Point& point, int64_t i, int64_t j,
+                        double& s, double& t) const -> bool;
+
+  /// Search the grid cell containing a point.
+  ///
+  /// @param[in] point The point to locate.
+  /// @param[out] s The coordinate of the point along the first dimension.
+  /// @param[out] t The coordinate of the point along the second dimension.
+  /// @param[inout] acc The accelerator holding the last cell selected.
+  /// @return True if a cell containing the point was found.
+  auto locate(const geometry::Point& point, double& s, double& t,
+              CurvilinearAccelerator* acc) const -> bool;
+};
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Curvilinear<T>::initialize(double resolution) -> void {
+  const auto ni = lon_.rows() - 1;
+  const auto nj = lon_.cols() - 1;
+  auto extents = Eigen::Matrix<double, -1, 4>(ni * nj, 4);
+  auto size = 0.0;
+  auto count = int64_t(0);
+  for (int64_t i = 0; i < ni; ++i) {
+    for (int64_t j = 0; j < nj; ++j) {
+      // Longitudes of the corners, unwrapped around the first corner.
+      const auto x0 = lon_(i, j);
+      auto x = Eigen::Vector4d(
+          x0, detail::math::normalize_angle(lon_(i + 1, j), x0 - 180),
+          detail::math::normalize_angle(lon_(i + 1, j + 1), x0 - 180),
+          detail::math::normalize_angle(lon_(i, j + 1), x0 - 180));
+      auto y = Eigen::Vector4d(lat_(i, j), lat_(i + 1, j), lat_(i + 1, j + 1),
+                               lat_(i, j + 1));
+      auto row = extents.row(i * nj + j);
+      row << x.minCoeff(), y.minCoeff(), x.maxCoeff(), y.maxCoeff();
+      if (row.allFinite()) {
+        size += std::max(row(2) - row(0), row(3) - row(1));
+        ++count;
+      }
+    }
+  }
+  if (resolution == 0) {
+    // About four grid cells per raster cell, without exceeding a raster of
+    // 1440x720 cells.
+    resolution = count == 0 ? 1.0
+                            : std::min(std::max(2 * size / count, 0.25), 10.0);
+  }
+  lookup_ = detail::RegionLookup(extents, resolution);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Curvilinear<T>::inverse_bilinear(const geometry::Point& point,
+                                      const int64_t i, const int64_t j,
+                                      double& s, double& t) const -> bool {
+  // Longitudes of the corners, expressed around the point.
+  const auto x_min = point.lon() - 180;
+  const auto x00 = detail::math::normalize_angle(lon_(i, j), x_min);
+  const auto x10 = detail::math::normalize_angle(lon_(i + 1, j), x_min);
+  const auto x11 = detail::math::normalize_angle(lon_(i + 1, j + 1), x_min);
+  const auto x01 = detail::math::normalize_angle(lon_(i, j + 1), x_min);
+  const auto y00 = lat_(i, j);
+  const auto y10 = lat_(i + 1, j);
+  const auto y11 = lat_(i + 1, j + 1);
+  const auto y01 = lat_(i, j + 1);
+
+  // Difference between the position of (s, t) in the cell and the point.
+  auto residual = [&](double& fx, double& fy) -> void {
+    fx = (1 - s) * (1 - t) * x00 + s * (1 - t) * x10 + s * t * x11 +
+         (1 - s) * t * x01 - point.lon();
+    fy = (1 - s) * (1 - t) * y00 + s * (1 - t) * y10 + s * t * y11 +
+         (1 - s) * t * y01 - point.lat();
+  };
+
+  // Newton iterations, starting from the center of the cell.
+  s = 0.5;
+  t = 0.5;
+  auto fx = 0.0;
+  auto fy = 0.0;
+  for (int iteration = 0; iteration < 16; ++iteration) {
+    residual(fx, fy);
+    const auto dxds = (1 - t) * (x10 - x00) + t * (x11 - x01);
+    const auto dyds = (1 - t) * (y10 - y00) + t * (y11 - y01);
+    const auto dxdt = (1 - s) * (x01 - x00) + s * (x11 - x10);
+    const auto dydt = (1 - s) * (y01 - y00) + s * (y11 - y10);
+    const auto det = dxds * dydt - dxdt * dyds;
+    if (!std::isfinite(det) || det == 0) {
+      return false;
+    }
+    const auto ds = (fx * dydt - fy * dxdt) / det;
+    const auto dt = (fy * dxds - fx * dyds) / det;
+    s -= ds;
+    t -= dt;
+    if (std::abs(ds) < 1e-12 && std::abs(dt) < 1e-12) {
+      return true;
+    }
+  }
+  // The iterations did not converge: the coordinates are only used if they
+  // locate the point.
+  residual(fx, fy);
+  return std::abs(fx) < 1e-9 && std::abs(fy) < 1e-9;
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Curvilinear<T>::locate(const geometry::Point& point, double& s, double& t,
+                            CurvilinearAccelerator* acc) const -> bool {
+  constexpr auto epsilon = 1e-9;
+  const auto ni = lon_.rows() - 1;
+  const auto nj = lon_.cols() - 1;
+  auto is_inside = [&]() -> bool {
+    return s >= -epsilon && s <= 1 + epsilon && t >= -epsilon &&
+           t <= 1 + epsilon;
+  };
+
+  // Walk from the cell selected for the previous point, in the direction
+  // given by the coordinates of the point in the index space of the cell.
+  if (acc->has_cell()) {
+    auto i = acc->i();
+    auto j = acc->j();
+    for (int step = 0; step < kMaxWalkSteps; ++step) {
+      if (!inverse_bilinear(point, i, j, s, t)) {
+        break;
+      }
+      if (is_inside()) {
+        acc->set(i, j);
+        return true;
+      }
+      const auto next_i =
+          std::min(std::max(i + (s < 0 ? -1 : s > 1 ? 1 : 0), int64_t(0)),
+                   ni - 1);
+      const auto next_j =
+          std::min(std::max(j + (t < 0 ? -1 : t > 1 ? 1 : 0), int64_t(0)),
+                   nj - 1);
+      if (next_i == i && next_j == j) {
+        break;
+      }
+      i = next_i;
+      j = next_j;
+    }
+  }
+
+  // Test the candidate cells listed by the lookup raster.
+  auto range = lookup_.candidates(point.lon(), point.lat());
+  for (auto it = range.first; it != range.second; ++it) {
+    const auto i = *it / nj;
+    const auto j = *it % nj;
+    if (inverse_bilinear(point, i, j, s, t) && is_inside()) {
+      acc->set(i, j);
+      return true;
+    }
+  }
+  return false;
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Curvilinear<T>::interpolate(const geometry::Point& point,
+                                 Quality& quality, Accelerator* acc) const
+    -> const ConstituentValues& {
+  auto* curvilinear_acc = reinterpret_cast<CurvilinearAccelerator*>(acc);
+
+  // Remove all previous values interpolated.
+  acc->clear();
+
+  auto reset_values_to_undefined = [&]() -> const ConstituentValues& {
+    constexpr auto undefined_value =
+        std::complex<double>(std::numeric_limits<double>::quiet_NaN(),
+                             std::numeric_limits<double>::quiet_NaN());
+
+    for (const auto& item : this->data_) {
+      acc->emplace_back(item.first, undefined_value);
+    }
+    quality = kUndefined;
+    return acc->values();
+  };
+
+  auto s = 0.0;
+  auto t = 0.0;
+  if (!locate(point, s, t, curvilinear_acc)) {
+    return reset_values_to_undefined();
+  }
+  s = std::min(std::max(s, 0.0), 1.0);
+  t = std::min(std::max(t, 0.0), 1.0);
+
+  const auto nj = lon_.cols();
+  const auto i00 = curvilinear_acc->i() * nj + curvilinear_acc->j();
+  const auto i01 = i00 + 1;
+  const auto i10 = i00 + nj;
+  const auto i11 = i10 + 1;
+  auto n = int64_t{0};
+
+  for (const auto& item : this->data_) {
+    const auto& wave = item.second;
+    auto value = detail::math::bilinear_interpolation<std::complex<double>>(
+        1 - s, s, 1 - t, t, wave(i00), wave(i01), wave(i10), wave(i11), n);
+    // The point lies within the grid, but the surrounding values are NaN.
+    if (std::isnan(value.real()) || std::isnan(value.imag())) {
+      return reset_values_to_undefined();
+    }
+    acc->emplace_back(item.first, value);
+  }
+  // n represents the number of valid grid nodes used in the bilinear
+  // interpolation.
+  quality = static_cast<Quality>(n);
+  return acc->values();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Curvilinear<T>::getstate() const -> std::string {
+  auto ss = std::stringstream();
+  ss.exceptions(std::stringstream::failbit);
+  detail::serialize::write_data(ss, this->tide_type_);
+  detail::serialize::write_data(ss, lookup_.resolution());
+  detail::serialize::write_matrix(ss, lon_);
+  detail::serialize::write_matrix(ss, lat_);
+  detail::serialize::write_constituent_map(ss, this->data_);
+  return ss.str();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto Curvilinear<T>::setstate(const string_view& data) -> Curvilinear<T> {
+  detail::isviewstream ss(data);
+  ss.exceptions(std::stringstream::failbit);
+  try {
+    auto tide_type = detail::serialize::read_data<TideType>(ss);
+    auto resolution = detail::serialize::read_data<double>(ss);
+    auto lon =
+        detail::serialize::read_matrix<double, Eigen::Dynamic, Eigen::Dynamic>(
+            ss);
+    auto lat =
+        detail::serialize::read_matrix<double, Eigen::Dynamic, Eigen::Dynamic>(
+            ss);
+    auto model = Curvilinear<T>(std::move(lon), std::move(lat), tide_type,
+                                resolution);
+    model.data_ =
+        detail::serialize::read_constituent_map<Constituent, std::complex<T>>(
+            ss);
+    return model;
+  } catch (const std::exception&) {
+    throw std::invalid_argument("invalid tidal model state");
+  }
+}
+
+}  // namespace tidal_model
+}  // namespace fes
@@ -0,0 +1,217 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/tidal_model/interpolation_plan.hpp
+/// @brief Interpolation plan shared by the Cartesian models of a grid.
+#pragma once
+#include <Eigen/Core>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "fes/abstract_tidal_model.hpp"
+#include "fes/axis.hpp"
+#include "fes/detail/thread.hpp"
+#include "fes/eigen.hpp"
+#include "fes/tidal_model/cartesian.hpp"
+
+namespace fes {
+namespace tidal_model {
+
+/// @brief Bilinear interpolation plan of a set of points on a Cartesian grid.
+///
+/// The plan stores, for each point, the positions of the four grid nodes
+/// surrounding it and their bilinear weights. It is built once from the axes
+/// of the grid and applied to any number of Cartesian models defined on this
+/// grid: the interpolation is then reduced to a gather of the node values
+/// and a weighted sum, without searching the axes again.
+class InterpolationPlan {
+ public:
+  /// Number of grid nodes used to interpolate a point.
+  static constexpr int kNodes = 4;
+
+  /// Positions of the grid nodes, one row per point.
+  using Indices =
+      Eigen::Matrix<int64_t, Eigen::Dynamic, kNodes, Eigen::RowMajor>;
+  /// Weights of the grid nodes, one row per point.
+  using Weights =
+      Eigen::Matrix<double, Eigen::Dynamic, kNodes, Eigen::RowMajor>;
+
+  /// Build the interpolation plan of a set of points.
+  ///
+  /// @param[in] lon The longitude axis of the grid.
+  /// @param[in] lat The latitude axis of the grid.
+  /// @param[in] row_major Whether the grid values are stored in
+  /// longitude-major order.
+  /// @param[in] lon_points The longitudes of the points, in degrees.
+  /// @param[in] lat_points The latitudes of the points, in degrees.
+  /// @param[in] num_threads The number of threads to use. If 0, all CPUs are
+  /// used.
+  InterpolationPlan(Axis lon, Axis lat, bool row_major,
+                    const Eigen::Ref<const Eigen::VectorXd>& lon_points,
+                    const Eigen::Ref<const Eigen::VectorXd>& lat_points,
+                    size_t num_threads = 0);
+
+  /// Build the interpolation plan of a set of points on the grid of a model.
+  ///
+  /// @param[in] model The Cartesian model defining the grid.
+  /// @param[in] lon_points The longitudes of the points, in degrees.
+  /// @param[in] lat_points The latitudes of the points, in degrees.
+  /// @param[in] num_threads The number of threads to use. If 0, all CPUs are
+  /// used.
+  template <typename T>
+  InterpolationPlan(const Cartesian<T>& model,
+                    const Eigen::Ref<const Eigen::VectorXd>& lon_points,
+                    const Eigen::Ref<const Eigen::VectorXd>& lat_points,
+                    const size_t num_threads = 0)
+      : InterpolationPlan(model.lon(), model.lat(), model.row_major(),
+                          lon_points, lat_points, num_threads) {}
+
+  /// Get the number of points of the plan.
+  inline auto size() const noexcept -> int64_t { return indices_.rows(); }
+
+  /// Get the positions of the grid nodes surrounding each point (-1 if the
+  /// point is outside the grid).
+  constexpr auto indices() const noexcept -> const Indices& {
+    return indices_;
+  }
+
+  /// Get the bilinear weights of the grid nodes surrounding each point.
+  constexpr auto weights() const noexcept -> const Weights& { return weights_; }
+
+  /// Interpolate the tidal constituents of a model at the points of the plan.
+  ///
+  /// The result is identical to the one of Cartesian::interpolate, including
+  /// the extrapolation if enabled by the model.
+  ///
+  /// @param[in] model The Cartesian model to interpolate. It must be defined
+  /// on the grid used to build the plan.
+  /// @param[in] num_threads The number of threads to use. If 0, all CPUs are
+  /// used.
+  /// @return The interpolated tidal constituents and the quality flag of each
+  /// point. The constituents of the undefined points are set to NaN.
+  template <typename T>
+  auto apply(const Cartesian<T>& model, size_t num_threads = 0) const
+      -> std::tuple<std::map<Constituent, Eigen::VectorXcd>, Vector<Quality>>;
+
+ private:
+  /// Longitude axis of the grid.
+  Axis lon_;
+  /// Latitude axis of the grid.
+  Axis lat_;
+  /// Whether the grid values are stored in longitude-major order.
+  bool row_major_;
+  /// Positions of the grid nodes surrounding each point.
+  Indices indices_;
+  /// Bilinear weights of the grid nodes surrounding each point.
+  Weights weights_;
+};
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto InterpolationPlan::apply(const Cartesian<T>& model,
+                              const size_t num_threads) const
+    -> std::tuple<std::map<Constituent, Eigen::VectorXcd>, Vector<Quality>> {
+  if (!(model.lon() == lon_ && model.lat() == lat_ &&
+        model.row_major() == row_major_)) {
+    throw std::invalid_argument(
+        "the interpolation plan was not built for the grid of this model");
+  }
+  constexpr auto undefined_value =
+      std::complex<double>(std::numeric_limits<double>::quiet_NaN(),
+                           std::numeric_limits<double>::quiet_NaN());
+  const auto& nearest_cells = model.nearest_cells();
+
+  // Pairs of (constituent values on the grid, interpolated values).
+  auto values = std::map<Constituent, Eigen::VectorXcd>();
+  auto waves = std::vector<std::pair<const std::complex<T>*,
+                                     std::complex<double>*>>();
+  for (const auto& item : model.data()) {
+    auto& result = values[item.first];
+    result.resize(size());
+    waves.emplace_back(item.second.data(), result.data());
+  }
+  auto qualities = Vector<Quality>(size());
+  if (waves.empty()) {
+    qualities.setConstant(kUndefined);
+    return std::make_tuple(std::move(values), std::move(qualities));
+  }
+
+  // Weighted sum of the defined node values, the undefined nodes being
+  // replaced by their nearest defined cell if the model extrapolates.
+  auto interpolate = [&](const std::complex<T>* wave, const int64_t ix,
+                         const bool extrapolate,
+                         int64_t& n) -> std::complex<double> {
+    auto result = std::complex<double>(0);
+    auto sum_w = 0.0;
+    n = 0;
+    for (int node = 0; node < kNodes; ++node) {
+      auto index = indices_(ix, node);
+      if (extrapolate) {
+        index = nearest_cells(index);
+        if (index == -1) {
+          continue;
+        }
+      }
+      const auto z = static_cast<std::complex<double>>(wave[index]);
+      if (!std::isnan(z.real()) && !std::isnan(z.imag())) {
+        result += z * weights_(ix, node);
+        sum_w += weights_(ix, node);
+        ++n;
+      }
+    }
+    return sum_w != 0 ? result / sum_w : undefined_value;
+  };
+
+  auto worker = [&](const int64_t start, const int64_t end) -> void {
+    auto n = int64_t(0);
+    // Points outside the grid are undefined, the others are interpolated
+    // unless a constituent is undefined.
+    for (auto ix = start; ix < end; ++ix) {
+      qualities[ix] = indices_(ix, 0) == -1 ? kUndefined : Quality(1);
+    }
+    for (const auto& item : waves) {
+      for (auto ix = start; ix < end; ++ix) {
+        if (qualities[ix] == kUndefined) {
+          continue;
+        }
+        const auto value = interpolate(item.first, ix, false, n);
+        item.second[ix] = value;
+        qualities[ix] =
+            std::isnan(value.real()) ? kUndefined : static_cast<Quality>(n);
+      }
+    }
+    for (auto ix = start; ix < end; ++ix) {
+      if (qualities[ix] != kUndefined) {
+        continue;
+      }
+      // The point is surrounded by undefined cells: extrapolate it if
+      // possible.
+      if (indices_(ix, 0) != -1 && !nearest_cells.empty()) {
+        auto defined = true;
+        for (const auto& item : waves) {
+          item.second[ix] = interpolate(item.first, ix, true, n);
+          defined &= !std::isnan(item.second[ix].real());
+        }
+        if (defined) {
+          qualities[ix] = static_cast<Quality>(-n);
+          continue;
+        }
+      }
+      for (const auto& item : waves) {
+        item.second[ix] = undefined_value;
+      }
+    }
+  };
+  detail::parallel_for(worker, size(), num_threads);
+  return std::make_tuple(std::move(values), std::move(qualities));
+}
+
+}  // namespace tidal_model
+}  // namespace fes
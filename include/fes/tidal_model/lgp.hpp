@@ -7,20 +7,27 @@
 #pragma once
 #include <Eigen/Core>
 #include <algorithm>
+#include <array>
 #include <boost/optional.hpp>
+#include <complex>
 #include <cstdint>
+#include <istream>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
-#include <set>
+#include <ostream>
 #include <sstream>
-#include <unordered_map>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "fes/abstract_tidal_model.hpp"
 #include "fes/detail/isviewstream.hpp"
+#include "fes/detail/prefetch.hpp"
 #include "fes/detail/serialize.hpp"
+#include "fes/detail/thread.hpp"
 #include "fes/eigen.hpp"
 #include "fes/geometry/box.hpp"
 #include "fes/mesh/index.hpp"
@@ -57,6 +64,25 @@ class LGPAccelerator : public Accelerator {
     selected_ = triangle;
   }
 
+  /// Search the triangle containing a point and cache it, without allocating
+  /// a new query result.
+  ///
+  /// If a triangle is cached, the point is first searched by walking through
+  /// the mesh from this triangle, the R-Tree being queried only if the walk
+  /// fails.
+  ///
+  /// @param[in] index The mesh index.
+  /// @param[in] point The point to locate.
+  /// @param[in] max_distance The maximum distance to the nearest triangle.
+  auto search(const mesh::Index& index, const geometry::Point& point,
+              const double max_distance) -> void {
+    if (selected_.is_inside() &&
+        index.walk(point, selected_.index, selected_)) {
+      return;
+    }
+    index.search(point, max_distance, selected_);
+  }
+
   /// Reset the point of the selected triangle.
   auto reset(const geometry::Point& point) -> void { selected_.point = point; }
 
@@ -77,6 +103,20 @@ class LGPAccelerator : public Accelerator {
     return selected_.is_inside() && selected_.triangle.covered_by(point);
   }
 
+  /// Check if a point is in the cache, using the reference transforms of the
+  /// mesh triangles if they are precomputed.
+  ///
+  /// @param[in] index The mesh index.
+  /// @param[in] point The point to check.
+  /// @return True if the point is in the cache, false otherwise.
+  inline auto in_cache(const mesh::Index& index,
+                       const geometry::Point& point) const -> bool {
+    if (!index.has_reference_transforms()) {
+      return in_cache(point);
+    }
+    return selected_.is_inside() && index.covered_by(selected_.index, point);
+  }
+
  private:
   /// The selected triangle for the accelerator.
   mesh::TriangleQueryResult selected_{};
@@ -95,6 +135,30 @@ class LGP : public fes::AbstractTidalModel<T> {
   /// %LGP codes.
   using codes_t = Eigen::Matrix<int, Eigen::Dynamic, N * 3>;
 
+  /// Local index of the %LGP codes located outside the selected bounding box.
+  static constexpr int kUnselected = -1;
+
+  /// Number of points located before their wave values are gathered by
+  /// interpolate_batch.
+  static constexpr int64_t kBatchSize = 64;
+
+  /// Number of points between the point whose wave values are gathered by
+  /// interpolate_batch and the point whose wave values are prefetched.
+  static constexpr int64_t kPrefetchDistance = 4;
+
+  /// Values interpolated by interpolate_batch: one row per point, one column
+  /// per tidal constituent.
+  using BatchValues = Eigen::Matrix<std::complex<double>, Eigen::Dynamic,
+                                    Eigen::Dynamic, Eigen::RowMajor>;
+
+  /// Tidal constituents handled by the model.
+  using Constituents = typename AbstractTidalModel<T>::Constituents;
+
+  /// Read-only view of the values of a tidal constituent, strided if the
+  /// layout is interleaved.
+  using ConstituentView = Eigen::Map<const Vector<std::complex<T>>, 0,
+                                     Eigen::InnerStride<Eigen::Dynamic>>;
+
   /// Build a new %LGP tidal model.
   ///
   /// @param[in] index The mesh index.
@@ -129,7 +193,50 @@ class LGP : public fes::AbstractTidalModel<T> {
           std::to_string(wave.size()) + " values, expected " +
           std::to_string(expected_data_size_) + " values");
     }
-    this->data_.emplace(ident, std::move(wave));
+    if (!interleaved()) {
+      this->data_.emplace(ident, std::move(wave));
+      return;
+    }
+    // Only the identifier is kept in the map, the values being stored in a
+    // new column of the node-major table.
+    auto inserted =
+        this->data_.emplace(ident, Vector<std::complex<T>>()).first;
+    insert_column(std::distance(this->data_.begin(), inserted), wave);
+  }
+
+  /// @brief Store the values of all the tidal constituents of each %LGP node
+  /// contiguously.
+  ///
+  /// The interpolation of a point inside a triangle then reads 3N contiguous
+  /// rows of values, one per %LGP node, instead of 3N scattered values per
+  /// tidal constituent. The node-major table replaces the vectors of the
+  /// loaded constituents, which are released: data() then only lists the
+  /// constituents, whose values are read by values(). A constituent added
+  /// afterwards
+  /// is inserted as a new column of the table, which copies the table once:
+  /// the constituents should be loaded before calling this method.
+  auto interleave() -> void;
+
+  /// Check if the values of the tidal constituents are stored in node-major
+  /// order.
+  constexpr auto interleaved() const noexcept -> bool { return interleaved_; }
+
+  /// @brief Get the values of a tidal constituent.
+  ///
+  /// Unlike data(), whose vectors are empty if the layout is interleaved, the
+  /// view reads the values of either layout without copying them. It is
+  /// invalidated when a constituent is added or the model is cleared.
+  ///
+  /// @param[in] ident The tidal constituent.
+  /// @return The values of the constituent for each %LGP node.
+  /// @throw std::invalid_argument if the constituent is not handled by the
+  /// model.
+  auto values(Constituent ident) const -> ConstituentView;
+
+  /// Clear all tidal constituents.
+  auto clear() -> void override {
+    AbstractTidalModel<T>::clear();
+    node_values_ = node_values_t(expected_data_size_, 0);
   }
 
   /// @brief Create a new instance of the LGPAccelerator class to speed up the
@@ -159,6 +266,26 @@ class LGP : public fes::AbstractTidalModel<T> {
   auto interpolate(const geometry::Point& point, Quality& quality,
                    Accelerator* acc) const -> const ConstituentValues& override;
 
+  /// @brief Interpolate the wave models loaded at a set of points.
+  ///
+  /// The points are processed in batches of kBatchSize: the triangles
+  /// containing the points of a batch are first located and their Lagrange
+  /// coefficients computed, then the wave values are gathered, those of the
+  /// following points being prefetched while the current point is
+  /// interpolated. The results are identical to those of interpolate.
+  ///
+  /// @param[in] lon The longitudes of the points, in degrees.
+  /// @param[in] lat The latitudes of the points, in degrees.
+  /// @param[in] num_threads The number of threads to use. If 0, all CPUs are
+  /// used.
+  /// @return The interpolated values, one column per tidal constituent in the
+  /// order of data(), and the quality flag of each point. The values of the
+  /// undefined points are set to NaN.
+  auto interpolate_batch(const Eigen::Ref<const Eigen::VectorXd>& lon,
+                         const Eigen::Ref<const Eigen::VectorXd>& lat,
+                         size_t num_threads = 0) const
+      -> std::tuple<BatchValues, Vector<Quality>>;
+
   /// Get the mesh index.
   ///
   /// @return The mesh index.
@@ -171,25 +298,20 @@ class LGP : public fes::AbstractTidalModel<T> {
   /// @return A string representation of the state of the tidal model.
   auto getstate() const -> std::string;
 
+  /// Write the state of the tidal model to a stream, without building it in
+  /// memory.
+  ///
+  /// @param[in,out] os The stream receiving the state (the bytes returned by
+  /// getstate()).
+  auto getstate(std::ostream& os) const -> void;
+
   /// Retrieve the indices for wave model values that intersect the specified
   /// bounding box.
   ///
-  /// @return A vector containing the selected indices. If no bounding box is
-  /// set, an empty vector is returned.
-  inline auto selected_indices() const -> Vector<int64_t> {
-    if (selected_indices_.empty()) {
-      return Vector<int64_t>();
-    }
-
-    const auto size = selected_indices_.size();
-    Vector<int64_t> result(size);
-
-    // Extract the keys (original indices) from the map
-    auto* ptr = result.data();
-    std::for_each(selected_indices_.begin(), selected_indices_.end(),
-                  [&ptr](const auto& item) { *ptr++ = item.first; });
-    std::sort(result.data(), result.data() + size);
-    return result;
+  /// @return A vector containing the selected indices, sorted in ascending
+  /// order. If no bounding box is set, an empty vector is returned.
+  constexpr auto selected_indices() const noexcept -> const Vector<int64_t>& {
+    return selected_indices_;
   }
 
  protected:
@@ -205,20 +327,46 @@ class LGP : public fes::AbstractTidalModel<T> {
 
   /// @brief Set the state of the tidal model.
   ///
-  /// @param[in] data The serialized tidal model.
+  /// @param[in,out] is The stream providing the serialized tidal model.
   /// @note As this class is abstract, this method must be overloaded by the
   /// derived classes to define the state of the tidal model.
-  auto setstate_instance(const string_view& data);
+  auto setstate_instance(std::istream& is) -> void;
+
+  /// @brief Extract the part of the model covering a bounding box into
+  /// another model.
+  ///
+  /// @param[in] bbox The bounding box to extract.
+  /// @param[out] result The model receiving the extracted part.
+  auto subset_instance(const std::tuple<double, double, double, double>& bbox,
+                       LGP<T, N>& result) const -> void;
 
  private:
+  /// Read-only %LGP codes of the triangles.
+  using shared_codes_t = detail::SharedMatrix<int, Eigen::Dynamic, N * 3>;
+
+  /// %LGP codes of a triangle.
+  using codes_row_t = typename shared_codes_t::ConstRowXpr;
+
+  /// Values of the tidal constituents stored in node-major order.
+  using node_values_t = Eigen::Matrix<std::complex<T>, Eigen::Dynamic,
+                                      Eigen::Dynamic, Eigen::RowMajor>;
+
   /// @brief Initialize selected indices based on bounding box.
   ///
+  /// The %LGP codes are replaced by their position in the selected indices, or
+  /// by kUnselected if they are outside the bounding box, so that the wave
+  /// values are read without looking up the codes during the interpolation.
+  ///
   /// @param[in] bbox The bounding box to consider when selecting LGP codes.
+  /// @param[in,out] codes The %LGP codes of the triangles.
   auto initialize_selected_indices(
-      const std::tuple<double, double, double, double>& bbox) -> void;
+      const std::tuple<double, double, double, double>& bbox, codes_t& codes)
+      -> void;
 
   /// @brief Validate and calculate expected data size from LGP codes.
-  auto calculate_expected_data_size() -> void;
+  ///
+  /// @param[in] codes The %LGP codes of the triangles.
+  auto calculate_expected_data_size(const codes_t& codes) -> void;
 
   /// @brief Process a single vertex for extrapolation.
   ///
@@ -253,7 +401,7 @@ class LGP : public fes::AbstractTidalModel<T> {
   /// @param[inout] acc Accelerator to store results.
   /// @return True if interpolation was successful, false otherwise.
   auto handle_vertex_interpolation(int vertex_id,
-                                   const typename codes_t::ConstRowXpr& codes,
+                                   const codes_row_t& codes,
                                    LGPAccelerator* acc) const -> bool;
 
   /// @brief Perform LGP interpolation within a triangle.
@@ -263,10 +411,30 @@ class LGP : public fes::AbstractTidalModel<T> {
   /// @param[inout] acc Accelerator to store results.
   /// @param[inout] quality Quality indicator.
   auto perform_lgp_interpolation(const Eigen::Matrix<double, N * 3, 1>& beta,
-                                 const typename codes_t::ConstRowXpr& codes,
+                                 const codes_row_t& codes,
                                  LGPAccelerator* acc, Quality& quality) const
       -> void;
 
+  /// @brief Insert the values of a constituent in the node-major table.
+  ///
+  /// @param[in] column The position of the constituent in the data map.
+  /// @param[in] wave The values of the constituent.
+  auto insert_column(Eigen::Index column, const Vector<std::complex<T>>& wave)
+      -> void;
+
+  /// @brief Get the value of a constituent at a %LGP node.
+  ///
+  /// @param[in] wave The values of the constituent in the data map, empty if
+  /// the layout is interleaved.
+  /// @param[in] column The position of the constituent in the data map.
+  /// @param[in] code The %LGP node.
+  /// @return The value of the constituent.
+  inline auto node_value(const detail::SharedVector<std::complex<T>>& wave,
+                         const Eigen::Index column, const int64_t code) const
+      -> std::complex<T> {
+    return interleaved() ? node_values_(code, column) : wave(code);
+  }
+
  private:
   /// Expected data size for each data set
   int expected_data_size_{};
@@ -274,21 +442,37 @@ class LGP : public fes::AbstractTidalModel<T> {
   /// Index used to find the nearest triangle
   std::shared_ptr<mesh::Index> index_{};
 
-  /// Indices that intersect the bounding box. If no bounding box is provided,
-  /// this map will be empty.
-  std::unordered_map<int64_t, int64_t> selected_indices_{};
+  /// Indices that intersect the bounding box, sorted in ascending order. If no
+  /// bounding box is provided, this vector will be empty.
+  Vector<int64_t> selected_indices_{};
 
   /// The maximum distance allowed to extrapolate the wave model.
   double max_distance_{};
 
-  /// %LGP codes for each triangles in the index
-  codes_t codes_{};
+  /// True if the values of the tidal constituents are stored in node-major
+  /// order.
+  bool interleaved_{false};
+
+  /// Values of the tidal constituents stored in node-major order: one row per
+  /// %LGP node, one column per constituent in the order of the data map. If
+  /// the layout is interleaved, this table is the only storage of the values
+  /// and the data map only lists the constituents, with empty vectors. Empty
+  /// if the layout is not interleaved.
+  detail::SharedMatrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic,
+                       Eigen::RowMajor>
+      node_values_{};
+
+  /// %LGP codes for each triangles in the index. If a bounding box is
+  /// provided, the codes are the positions of the wave values in the selected
+  /// indices.
+  shared_codes_t codes_{};
 
   /// Extrapolate the wave model at the given point using the nearest vertices
   /// from the mesh index.
-  auto extrapolate(const geometry::Point& point, Quality& quality,
-                   const std::vector<mesh::VertexAttribute>& nearest_vertices,
-                   LGPAccelerator* acc) const -> void;
+  auto extrapolate(
+      const geometry::Point& point, Quality& quality,
+      const mesh::TriangleQueryResult::VertexList& nearest_vertices,
+      LGPAccelerator* acc) const -> void;
 };
 
 /// @brief %LGP1 tidal model.
@@ -308,8 +492,38 @@ class LGP1 : public LGP<T, 1> {
   /// @param[in] data The serialized tidal model.
   /// @return The tidal model.
   static auto setstate(const string_view& data) -> LGP1<T> {
+    detail::isviewstream ss(data);
+    return LGP1<T>::setstate(ss);
+  }
+
+  /// @brief Deserialize the tidal model from a stream.
+  ///
+  /// The mesh and the wave values are read directly from the stream, without
+  /// loading the whole serialized state in memory.
+  ///
+  /// @param[in,out] is The stream providing the serialized tidal model.
+  /// @return The tidal model.
+  static auto setstate(std::istream& is) -> LGP1<T> {
     auto model = LGP1<T>();
-    model.setstate_instance(data);
+    model.setstate_instance(is);
+    return model;
+  }
+
+  /// @brief Extract the part of the model covering a bounding box into a
+  /// standalone model.
+  ///
+  /// The triangles intersecting the bounding box are copied with their
+  /// vertices, %LGP codes and wave values, renumbered densely, into a new
+  /// model with its own mesh index. The points located inside the bounding box
+  /// and inside the mesh are interpolated as by this model.
+  ///
+  /// @param[in] bbox The bounding box to extract: minimum longitude, minimum
+  /// latitude, maximum longitude and maximum latitude.
+  /// @return The extracted model.
+  auto subset(const std::tuple<double, double, double, double>& bbox) const
+      -> LGP1<T> {
+    auto model = LGP1<T>();
+    this->subset_instance(bbox, model);
     return model;
   }
 
@@ -326,12 +540,12 @@ class LGP1 : public LGP<T, 1> {
 
   /// @brief Set the state of the tidal model.
   ///
-  /// @param[in] data The serialized tidal model.
+  /// @param[in,out] is The stream providing the serialized tidal model.
   /// @note As the `setstate_instance` method is protected, this method must be
   /// overloaded by the derived classes to define the state of the tidal model.
-  auto setstate_instance(const string_view& data) -> void {
+  auto setstate_instance(std::istream& is) -> void {
     try {
-      LGP<T, 1>::setstate_instance(data);
+      LGP<T, 1>::setstate_instance(is);
     } catch (const std::exception& e) {
       throw std::runtime_error("invalid LGP1 tidal model state");
     }
@@ -355,8 +569,38 @@ class LGP2 : public LGP<T, 2> {
   /// @param[in] data The serialized tidal model.
   /// @return The tidal model.
   static auto setstate(const string_view& data) -> LGP2<T> {
+    detail::isviewstream ss(data);
+    return LGP2<T>::setstate(ss);
+  }
+
+  /// @brief Deserialize the tidal model from a stream.
+  ///
+  /// The mesh and the wave values are read directly from the stream, without
+  /// loading the whole serialized state in memory.
+  ///
+  /// @param[in,out] is The stream providing the serialized tidal model.
+  /// @return The tidal model.
+  static auto setstate(std::istream& is) -> LGP2<T> {
+    auto model = LGP2<T>();
+    model.setstate_instance(is);
+    return model;
+  }
+
+  /// @brief Extract the part of the model covering a bounding box into a
+  /// standalone model.
+  ///
+  /// The triangles intersecting the bounding box are copied with their
+  /// vertices, %LGP codes and wave values, renumbered densely, into a new
+  /// model with its own mesh index. The points located inside the bounding box
+  /// and inside the mesh are interpolated as by this model.
+  ///
+  /// @param[in] bbox The bounding box to extract: minimum longitude, minimum
+  /// latitude, maximum longitude and maximum latitude.
+  /// @return The extracted model.
+  auto subset(const std::tuple<double, double, double, double>& bbox) const
+      -> LGP2<T> {
     auto model = LGP2<T>();
-    model.setstate_instance(data);
+    this->subset_instance(bbox, model);
     return model;
   }
 
@@ -386,12 +630,12 @@ class LGP2 : public LGP<T, 2> {
 
   /// @brief Set the state of the tidal model.
   ///
-  /// @param[in] data The serialized tidal model.
+  /// @param[in,out] is The stream providing the serialized tidal model.
   /// @note As the `setstate_instance` method is protected, this method must be
   /// overloaded by the derived classes to define the state of the tidal model.
-  auto setstate_instance(const string_view& data) -> void {
+  auto setstate_instance(std::istream& is) -> void {
     try {
-      LGP<T, 2>::setstate_instance(data);
+      LGP<T, 2>::setstate_instance(is);
     } catch (const std::exception& e) {
       throw std::runtime_error("invalid LGP2 tidal model state");
     }
@@ -401,7 +645,8 @@ class LGP2 : public LGP<T, 2> {
 // /////////////////////////////////////////////////////////////////////////////
 template <typename T, int N>
 auto LGP<T, N>::initialize_selected_indices(
-    const std::tuple<double, double, double, double>& bbox) -> void {
+    const std::tuple<double, double, double, double>& bbox, codes_t& codes)
+    -> void {
   // Get the selected triangles that intersect the bounding box
   const auto selected_triangles = index_->selected_triangles(
       geometry::Box{geometry::Point{std::get<0>(bbox), std::get<1>(bbox)},
@@ -409,29 +654,202 @@ auto LGP<T, N>::initialize_selected_indices(
 
   // A LGP code could be used by multiple triangles, we need to store the
   // selected indices to avoid duplicates.
-  std::set<int64_t> selected_indices;
+  auto selected_indices = std::vector<int64_t>();
+  selected_indices.reserve(selected_triangles.size() * N * 3);
   for (const auto& ix : selected_triangles) {
-    const auto& codes = codes_.row(ix);
     for (auto iy = 0; iy < N * 3; ++iy) {
-      selected_indices.insert(codes(iy));
+      selected_indices.push_back(codes(ix, iy));
+    }
+  }
+  std::sort(selected_indices.begin(), selected_indices.end());
+  selected_indices.erase(
+      std::unique(selected_indices.begin(), selected_indices.end()),
+      selected_indices.end());
+  selected_indices_ = Eigen::Map<const Vector<int64_t>>(
+      selected_indices.data(),
+      static_cast<Eigen::Index>(selected_indices.size()));
+
+  // Finally, the LGP codes are replaced by their position in the selected
+  // indices.
+  Vector<int> positions =
+      Vector<int>::Constant(expected_data_size_, int{kUnselected});
+  for (Eigen::Index ix = 0; ix < selected_indices_.size(); ++ix) {
+    positions(selected_indices_(ix)) = static_cast<int>(ix);
+  }
+  std::for_each(codes.data(), codes.data() + codes.size(),
+                [&positions](int& code) { code = positions(code); });
+  expected_data_size_ = static_cast<int>(selected_indices_.size());
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T, int N>
+auto LGP<T, N>::subset_instance(
+    const std::tuple<double, double, double, double>& bbox,
+    LGP<T, N>& result) const -> void {
+  // The triangles intersecting the box whose values are loaded.
+  auto selected_triangles = std::vector<int64_t>();
+  for (const auto& ix : index_->selected_triangles(
+           geometry::Box{geometry::Point{std::get<0>(bbox), std::get<1>(bbox)},
+                         geometry::Point{std::get<2>(bbox),
+                                         std::get<3>(bbox)}})) {
+    if ((codes_.row(ix).array() != int{kUnselected}).all()) {
+      selected_triangles.push_back(ix);
+    }
+  }
+  if (selected_triangles.empty()) {
+    throw std::invalid_argument("no triangle intersects the bounding box");
+  }
+  const auto n_triangles = static_cast<Eigen::Index>(selected_triangles.size());
+
+  // The vertices and the LGP codes used by the selected triangles are
+  // numbered densely, in their original order.
+  Vector<int32_t> vertex_positions = Vector<int32_t>::Constant(
+      static_cast<Eigen::Index>(index_->n_positions()), -1);
+  Vector<int> code_positions =
+      Vector<int>::Constant(expected_data_size_, int{kUnselected});
+  for (const auto& triangle : selected_triangles) {
+    for (auto jx = 0; jx < 3; ++jx) {
+      vertex_positions(index_->triangles()(triangle, jx)) = 0;
+    }
+    for (auto jx = 0; jx < N * 3; ++jx) {
+      code_positions(codes_(triangle, jx)) = 0;
+    }
+  }
+  auto vertices = std::vector<int32_t>();
+  for (Eigen::Index ix = 0; ix < vertex_positions.size(); ++ix) {
+    if (vertex_positions(ix) != -1) {
+      vertex_positions(ix) = static_cast<int32_t>(vertices.size());
+      vertices.push_back(static_cast<int32_t>(ix));
+    }
+  }
+  auto nodes = std::vector<int>();
+  for (Eigen::Index ix = 0; ix < code_positions.size(); ++ix) {
+    if (code_positions(ix) != kUnselected) {
+      code_positions(ix) = static_cast<int>(nodes.size());
+      nodes.push_back(static_cast<int>(ix));
+    }
+  }
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>(n_triangles, 3);
+  auto codes = codes_t(n_triangles, N * 3);
+  for (Eigen::Index ix = 0; ix < n_triangles; ++ix) {
+    const auto triangle = selected_triangles[ix];
+    for (auto jx = 0; jx < 3; ++jx) {
+      triangles(ix, jx) = vertex_positions(index_->triangles()(triangle, jx));
     }
+    for (auto jx = 0; jx < N * 3; ++jx) {
+      codes(ix, jx) = code_positions(codes_(triangle, jx));
+    }
+  }
+
+  auto lon = Eigen::VectorXd(static_cast<Eigen::Index>(vertices.size()));
+  auto lat = Eigen::VectorXd(static_cast<Eigen::Index>(vertices.size()));
+  for (size_t ix = 0; ix < vertices.size(); ++ix) {
+    lon(ix) = index_->lon()(vertices[ix]);
+    lat(ix) = index_->lat()(vertices[ix]);
+  }
+  auto index = std::make_shared<mesh::Index>(
+      std::move(lon), std::move(lat), std::move(triangles), index_->type(),
+      index_->bucket_grid().resolution());
+  if (index_->has_reference_transforms()) {
+    index->build_reference_transforms();
+  }
+  if (index_->has_coastal_band()) {
+    index->build_coastal_band(index_->coastal_band().max_distance(),
+                              index_->coastal_band().resolution());
+  }
+
+  // The selected indices of the extracted model give the position of its
+  // values in the wave models read by this one.
+  const auto n_nodes = static_cast<Eigen::Index>(nodes.size());
+  result.selected_indices_.resize(n_nodes);
+  for (Eigen::Index ix = 0; ix < n_nodes; ++ix) {
+    result.selected_indices_(ix) = selected_indices_.size() != 0
+                                       ? selected_indices_(nodes[ix])
+                                       : nodes[ix];
+  }
+  result.clear();
+  if (interleaved()) {
+    auto node_values = node_values_t(n_nodes, node_values_.cols());
+    for (Eigen::Index ix = 0; ix < n_nodes; ++ix) {
+      node_values.row(ix) = node_values_.row(nodes[ix]);
+    }
+    result.node_values_ = std::move(node_values);
+  }
+  for (const auto& item : this->data_) {
+    auto wave = Vector<std::complex<T>>(interleaved() ? 0 : n_nodes);
+    for (Eigen::Index ix = 0; ix < wave.size(); ++ix) {
+      wave(ix) = item.second(nodes[ix]);
+    }
+    result.data_.emplace(item.first, std::move(wave));
+  }
+  result.interleaved_ = interleaved_;
+  result.dynamic_ = this->dynamic_;
+  result.tide_type_ = this->tide_type_;
+  result.expected_data_size_ = static_cast<int>(n_nodes);
+  result.index_ = std::move(index);
+  result.max_distance_ = max_distance_;
+  result.codes_ = std::move(codes);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T, int N>
+auto LGP<T, N>::interleave() -> void {
+  if (interleaved_) {
+    return;
+  }
+  interleaved_ = true;
+  auto node_values = node_values_t(
+      expected_data_size_, static_cast<Eigen::Index>(this->data_.size()));
+  auto column = Eigen::Index(0);
+  for (auto& item : this->data_) {
+    node_values.col(column++) = item.second;
+    item.second = Vector<std::complex<T>>();
+  }
+  node_values_ = std::move(node_values);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T, int N>
+auto LGP<T, N>::insert_column(const Eigen::Index column,
+                              const Vector<std::complex<T>>& wave) -> void {
+  const auto cols = node_values_.cols();
+  if (cols + 1 != static_cast<Eigen::Index>(this->data_.size())) {
+    // The constituent was already loaded.
+    return;
   }
+  auto node_values = node_values_t(expected_data_size_, cols + 1);
+  node_values.leftCols(column) = node_values_.leftCols(column);
+  node_values.col(column) = wave;
+  node_values.rightCols(cols - column) = node_values_.rightCols(cols - column);
+  node_values_ = std::move(node_values);
+}
 
-  // Finally, we store the selected indices in a map to get the index of each
-  // LGP code.
-  int64_t index = 0;
-  for (const auto& ix : selected_indices) {
-    selected_indices_[ix] = index++;
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T, int N>
+auto LGP<T, N>::values(const Constituent ident) const -> ConstituentView {
+  const auto it = this->data_.find(ident);
+  if (it == this->data_.end()) {
+    throw std::invalid_argument("the tidal constituent " +
+                                std::string(constituents::name(ident)) +
+                                " is not handled by the model");
+  }
+  if (!interleaved()) {
+    return ConstituentView(it->second.data(), it->second.size(),
+                           Eigen::InnerStride<Eigen::Dynamic>(1));
   }
+  const auto column = std::distance(this->data_.begin(), it);
+  return ConstituentView(
+      node_values_.data() + column, node_values_.rows(),
+      Eigen::InnerStride<Eigen::Dynamic>(node_values_.cols()));
 }
 
 // /////////////////////////////////////////////////////////////////////////////
 template <typename T, int N>
-auto LGP<T, N>::calculate_expected_data_size() -> void {
+auto LGP<T, N>::calculate_expected_data_size(const codes_t& codes) -> void {
   // Determine the first and last LGP codes for each triangle
   auto min_index = std::numeric_limits<int>::max();
   auto max_index = std::numeric_limits<int>::min();
-  std::for_each(codes_.data(), codes_.data() + codes_.size(),
+  std::for_each(codes.data(), codes.data() + codes.size(),
                 [&min_index, &max_index](const auto& code) {
                   min_index = std::min(min_index, code);
                   max_index = std::max(max_index, code);
@@ -442,9 +860,7 @@ auto LGP<T, N>::calculate_expected_data_size() -> void {
   }
 
   // Store the expected data size to interpolate
-  expected_data_size_ = selected_indices_.empty()
-                            ? max_index + 1
-                            : static_cast<int>(selected_indices_.size());
+  expected_data_size_ = max_index + 1;
 }
 
 // /////////////////////////////////////////////////////////////////////////////
@@ -455,24 +871,24 @@ LGP<T, N>::LGP(
     const boost::optional<std::tuple<double, double, double, double>>& bbox)
     : AbstractTidalModel<T>(tide_type),
       index_(std::move(index)),
-      max_distance_(max_distance),
-      codes_(std::move(codes)) {
+      max_distance_(max_distance) {
   // The number of triangles in the index must match the number of LGP codes
   // provided.
-  if (index_->n_triangles() != static_cast<size_t>(codes_.rows())) {
+  if (index_->n_triangles() != static_cast<size_t>(codes.rows())) {
     throw std::invalid_argument(
         "index and codes must have the same number of triangles: " +
         std::to_string(index_->n_triangles()) +
-        " != " + std::to_string(codes_.rows()));
+        " != " + std::to_string(codes.rows()));
   }
 
+  // Calculate expected data size based on LGP codes
+  calculate_expected_data_size(codes);
+
   // Initialize selected indices if bounding box is provided
   if (bbox) {
-    initialize_selected_indices(*bbox);
+    initialize_selected_indices(*bbox, codes);
   }
-
-  // Calculate expected data size based on LGP codes
-  calculate_expected_data_size();
+  codes_ = std::move(codes);
 }
 
 // /////////////////////////////////////////////////////////////////////////////
@@ -493,26 +909,17 @@ auto LGP<T, N>::process_vertex_for_extrapolation(
     std::vector<int64_t>& selected_indices, int64_t& valid_count) const
     -> bool {
   const auto& code = codes_.row(vertex.triangle_index);
-  const auto& vertex_indices = index_->triangles().row(vertex.triangle_index);
-  const auto lon = index_->lon()(vertex_indices(vertex.vertex_id));
-  const auto lat = index_->lat()(vertex_indices(vertex.vertex_id));
-  const auto ecef = transform_to_ecef(geometry::Point(lon, lat));
-
-  if (!selected_indices_.empty()) {
-    // If the selected indices are provided, we only consider the LGP
-    // codes that are in the selected indices.
-    auto it = selected_indices_.find(code(N * vertex.vertex_id));
-    if (it == selected_indices_.end()) {
-      return false;
-    }
-    known_points.row(valid_count) = ecef;
-    selected_indices.push_back(it->second);
-  } else {
-    // If no selected indices are provided, we consider all the LGP codes
-    // for the vertex.
-    known_points.row(valid_count) = ecef;
-    selected_indices.push_back(code(N * vertex.vertex_id));
+
+  // If a bounding box is provided, we only consider the LGP codes that are in
+  // the selected indices.
+  const auto ix = code(N * vertex.vertex_id);
+  if (ix == kUnselected) {
+    return false;
   }
+  // The ECEF coordinates of the vertices are stored by the index.
+  known_points.row(valid_count) = index_->ecef().row(
+      index_->triangles()(vertex.triangle_index, vertex.vertex_id));
+  selected_indices.push_back(ix);
 
   valid_count++;
   return true;
@@ -525,6 +932,7 @@ auto LGP<T, N>::inverse_distance_weighting(
     const Eigen::Matrix<double, -1, 3>& known_points,
     const std::vector<int64_t>& selected_indices, int64_t valid_count,
     LGPAccelerator* acc) const -> void {
+  auto column = Eigen::Index(0);
   for (const auto& item : this->data_) {
     const auto& wave = item.second;
     std::complex<double> sum_of_weights(0, 0);
@@ -532,7 +940,8 @@ auto LGP<T, N>::inverse_distance_weighting(
 
     for (auto i = 0; i < valid_count; ++i) {
       auto distance = (known_points.row(i) - query_point).norm();
-      auto value = static_cast<std::complex<double>>(wave(selected_indices[i]));
+      auto value = static_cast<std::complex<double>>(
+          node_value(wave, column, selected_indices[i]));
       auto weight =
           std::complex<double>(1 / detail::math::pow<2, double>(distance), 0);
 
@@ -540,6 +949,7 @@ auto LGP<T, N>::inverse_distance_weighting(
       sum_of_weighted_values += weight * value;
     }
     acc->emplace_back(item.first, sum_of_weighted_values / sum_of_weights);
+    ++column;
   }
 }
 
@@ -547,7 +957,7 @@ auto LGP<T, N>::inverse_distance_weighting(
 template <typename T, int N>
 auto LGP<T, N>::extrapolate(
     const geometry::Point& point, Quality& quality,
-    const std::vector<mesh::VertexAttribute>& nearest_vertices,
+    const mesh::TriangleQueryResult::VertexList& nearest_vertices,
     LGPAccelerator* acc) const -> void {
   const auto n = nearest_vertices.size();
   assert(n > 0);
@@ -587,28 +997,18 @@ auto LGP<T, N>::extrapolate(
 // /////////////////////////////////////////////////////////////////////////////
 template <typename T, int N>
 auto LGP<T, N>::handle_vertex_interpolation(
-    int vertex_id, const typename codes_t::ConstRowXpr& codes,
+    int vertex_id, const codes_row_t& codes,
     LGPAccelerator* acc) const -> bool {
+  // If a bounding box is provided, the LGP code of the vertex may be outside
+  // the selected indices.
   const auto ix = codes(vertex_id * N);
-  if (selected_indices_.empty()) {
-    // First case: no bounding box is provided, we directly use the LGP codes
-    // for the vertex.
-    for (const auto& item : this->data_) {
-      const auto value = item.second(ix);
-      acc->emplace_back(item.first, static_cast<std::complex<T>>(value));
-    }
-  } else {
-    // Second case: a bounding box is provided, we need to check if the LGP
-    // code for the vertex is in the selected indices.
-    auto it = selected_indices_.find(ix);
-    if (it == selected_indices_.end()) {
-      return false;
-    }
-
-    for (const auto& item : this->data_) {
-      const auto value = item.second(it->second);
-      acc->emplace_back(item.first, static_cast<std::complex<T>>(value));
-    }
+  if (ix == kUnselected) {
+    return false;
+  }
+  auto column = Eigen::Index(0);
+  for (const auto& item : this->data_) {
+    const auto value = node_value(item.second, column++, ix);
+    acc->emplace_back(item.first, static_cast<std::complex<T>>(value));
   }
   return true;
 }
@@ -617,37 +1017,40 @@ auto LGP<T, N>::handle_vertex_interpolation(
 template <typename T, int N>
 auto LGP<T, N>::perform_lgp_interpolation(
     const Eigen::Matrix<double, N * 3, 1>& beta,
-    const typename codes_t::ConstRowXpr& codes, LGPAccelerator* acc,
+    const codes_row_t& codes, LGPAccelerator* acc,
     Quality& quality) const -> void {
-  if (selected_indices_.empty()) {
-    // First case: no bounding box is provided, we interpolate all the LGP codes
+  // If the input coordinates are outside the bounding box, some LGP codes are
+  // not in the selected indices. In this case, we return NaN.
+  for (auto ix = 0; ix < N * 3; ++ix) {
+    if (codes(ix) == kUnselected) {
+      quality = kUndefined;
+      return;
+    }
+  }
+  if (interleaved()) {
+    // The values of all the constituents of a node are contiguous: the 3N
+    // rows used by the triangle are loaded once for all the constituents.
+    auto rows = std::array<const std::complex<T>*, N * 3>{};
+    for (auto ix = 0; ix < N * 3; ++ix) {
+      rows[ix] = node_values_.row(codes(ix)).data();
+    }
+    auto column = Eigen::Index(0);
     for (const auto& item : this->data_) {
-      const auto& wave = item.second;
       auto dot = std::complex<double>(0, 0);
-
-      // Read the values for each LGP code
       for (auto ix = 0; ix < N * 3; ++ix) {
-        dot += beta(ix) * static_cast<std::complex<double>>(wave(codes(ix)));
+        dot += beta(ix) * static_cast<std::complex<double>>(rows[ix][column]);
       }
       acc->emplace_back(item.first, dot);
+      ++column;
     }
   } else {
-    // Second case: a bounding box is provided, we interpolate the selected LGP
-    // codes
     for (const auto& item : this->data_) {
       const auto& wave = item.second;
       auto dot = std::complex<double>(0, 0);
 
+      // Read the values for each LGP code
       for (auto ix = 0; ix < N * 3; ++ix) {
-        const auto it = selected_indices_.find(codes(ix));
-        if (it == selected_indices_.end()) {
-          // If the input coordinates are outside the bounding box, the
-          // LGP codes will not be found in the selected indices. In this case,
-          // we return NaN.
-          quality = kUndefined;
-          return;
-        }
-        dot += beta(ix) * static_cast<std::complex<double>>(wave(it->second));
+        dot += beta(ix) * static_cast<std::complex<double>>(wave(codes(ix)));
       }
       acc->emplace_back(item.first, dot);
     }
@@ -679,8 +1082,9 @@ auto LGP<T, N>::interpolate(const geometry::Point& point, Quality& quality,
 
   // Reset the accelerator if the point is not in the cache, otherwise update
   // the point in use.
-  lgp_acc->in_cache(point) ? lgp_acc->reset(point)
-                           : lgp_acc->set(index_->search(point, max_distance_));
+  lgp_acc->in_cache(*index_, point)
+      ? lgp_acc->reset(point)
+      : lgp_acc->search(*index_, point, max_distance_);
 
   // Remove all the data from the previous interpolation
   lgp_acc->clear();
@@ -721,8 +1125,11 @@ auto LGP<T, N>::interpolate(const geometry::Point& point, Quality& quality,
   }
 
   // Calculate ξ and η for the given point
-  const auto xy =
-      query_result.triangle.reference_right_angled(query_result.point);
+  const auto xy = index_->has_reference_transforms()
+                      ? index_->reference_right_angled(query_result.index,
+                                                       query_result.point)
+                      : query_result.triangle.reference_right_angled(
+                            query_result.point);
 
   // Calculate the beta coefficients for the given point
   const auto beta = calculate_beta(std::get<0>(xy), std::get<1>(xy));
@@ -738,32 +1145,229 @@ auto LGP<T, N>::interpolate(const geometry::Point& point, Quality& quality,
   return lgp_acc->values();
 }
 
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T, int N>
+auto LGP<T, N>::interpolate_batch(const Eigen::Ref<const Eigen::VectorXd>& lon,
+                                  const Eigen::Ref<const Eigen::VectorXd>& lat,
+                                  const size_t num_threads) const
+    -> std::tuple<BatchValues, Vector<Quality>> {
+  if (lon.size() != lat.size()) {
+    throw std::invalid_argument("lon and lat must have the same size");
+  }
+  constexpr auto undefined_value =
+      std::complex<double>(std::numeric_limits<double>::quiet_NaN(),
+                           std::numeric_limits<double>::quiet_NaN());
+  auto values = BatchValues(lon.size(),
+                            static_cast<Eigen::Index>(this->data_.size()));
+  auto qualities = Vector<Quality>(lon.size());
+  auto waves = std::vector<const std::complex<T>*>();
+  for (const auto& item : this->data_) {
+    waves.push_back(item.second.data());
+  }
+
+  auto worker = [&](const int64_t start, const int64_t end) -> void {
+    auto acc = LGPAccelerator(angle::Formulae::kSchuremanOrder1, 0.0,
+                              this->data_.size());
+    // Triangle containing each point of the batch, -1 if the point is not
+    // interpolated from the wave values of a triangle.
+    auto triangles = std::array<int64_t, kBatchSize>{};
+    // Vertex of the triangle on which each point lies, -1 if none.
+    auto vertices = std::array<int, kBatchSize>{};
+    // Lagrange coefficients of each point of the batch.
+    auto betas = Eigen::Matrix<double, N * 3, kBatchSize>();
+
+    // Load the wave values used to interpolate a point of the batch.
+    auto prefetch = [&](const int64_t ix) -> void {
+      if (triangles[ix] == -1) {
+        return;
+      }
+      const auto& codes = codes_.row(triangles[ix]);
+      for (auto jx = 0; jx < N * 3; ++jx) {
+        const auto code = codes(jx);
+        if (code == kUnselected) {
+          continue;
+        }
+        if (interleaved()) {
+          detail::prefetch(node_values_.row(code).data());
+        } else {
+          for (const auto* wave : waves) {
+            detail::prefetch(wave + code);
+          }
+        }
+      }
+    };
+
+    for (auto first = start; first < end; first += kBatchSize) {
+      const auto size = std::min(int64_t{kBatchSize}, end - first);
+
+      // Locate the points of the batch.
+      for (auto ix = int64_t(0); ix < size; ++ix) {
+        const auto item = first + ix;
+        const auto point = geometry::Point(lon[item], lat[item]);
+        triangles[ix] = -1;
+        acc.in_cache(*index_, point)
+            ? acc.reset(point)
+            : acc.search(*index_, point, max_distance_);
+        const auto& query_result = acc.get();
+        auto quality = kUndefined;
+        if (query_result.is_inside()) {
+          const auto& codes = codes_.row(query_result.index);
+          vertices[ix] = query_result.triangle.is_vertex(query_result.point);
+          if (vertices[ix] != -1) {
+            quality = codes(vertices[ix] * N) == kUnselected
+                          ? kUndefined
+                          : static_cast<Quality>(N * 3);
+          } else if ((codes.array() != int{kUnselected}).all()) {
+            const auto xy =
+                index_->has_reference_transforms()
+                    ? index_->reference_right_angled(query_result.index,
+                                                     query_result.point)
+                    : query_result.triangle.reference_right_angled(
+                          query_result.point);
+            betas.col(ix) = calculate_beta(std::get<0>(xy), std::get<1>(xy));
+            quality = static_cast<Quality>(N * 3);
+          }
+          if (quality != kUndefined) {
+            triangles[ix] = query_result.index;
+          }
+        } else if (query_result.is_valid()) {
+          // The few extrapolated points are processed immediately.
+          acc.clear();
+          extrapolate(point, quality, query_result.nearest_vertices, &acc);
+          if (quality != kUndefined) {
+            auto column = Eigen::Index(0);
+            for (const auto& value : acc.values()) {
+              values(item, column++) = value.second;
+            }
+          }
+        }
+        qualities[item] = quality;
+        if (quality == kUndefined) {
+          values.row(item).setConstant(undefined_value);
+        }
+      }
+
+      // Gather the wave values of the triangles.
+      const auto lead = std::min(int64_t{kPrefetchDistance}, size);
+      for (auto ix = int64_t(0); ix < lead; ++ix) {
+        prefetch(ix);
+      }
+      for (auto ix = int64_t(0); ix < size; ++ix) {
+        if (ix + kPrefetchDistance < size) {
+          prefetch(ix + kPrefetchDistance);
+        }
+        if (triangles[ix] == -1) {
+          continue;
+        }
+        const auto item = first + ix;
+        const auto& codes = codes_.row(triangles[ix]);
+        if (vertices[ix] != -1) {
+          const auto code = codes(vertices[ix] * N);
+          for (Eigen::Index column = 0; column < values.cols(); ++column) {
+            values(item, column) = interleaved()
+                                       ? node_values_(code, column)
+                                       : waves[column][code];
+          }
+          continue;
+        }
+        const auto& beta = betas.col(ix);
+        if (interleaved()) {
+          auto rows = std::array<const std::complex<T>*, N * 3>{};
+          for (auto jx = 0; jx < N * 3; ++jx) {
+            rows[jx] = node_values_.row(codes(jx)).data();
+          }
+          for (Eigen::Index column = 0; column < values.cols(); ++column) {
+            auto dot = std::complex<double>(0, 0);
+            for (auto jx = 0; jx < N * 3; ++jx) {
+              dot += beta(jx) *
+                     static_cast<std::complex<double>>(rows[jx][column]);
+            }
+            values(item, column) = dot;
+          }
+        } else {
+          for (size_t column = 0; column < waves.size(); ++column) {
+            auto dot = std::complex<double>(0, 0);
+            for (auto jx = 0; jx < N * 3; ++jx) {
+              dot += beta(jx) * static_cast<std::complex<double>>(
+                                    waves[column][codes(jx)]);
+            }
+            values(item, static_cast<Eigen::Index>(column)) = dot;
+          }
+        }
+      }
+    }
+  };
+  detail::parallel_for(worker, static_cast<size_t>(lon.size()), num_threads);
+  return std::make_tuple(std::move(values), std::move(qualities));
+}
+
 template <typename T, int N>
 auto LGP<T, N>::getstate() const -> std::string {
   auto ss = std::stringstream();
   ss.exceptions(std::stringstream::failbit);
-  detail::serialize::write_data(ss, this->tide_type_);
-  detail::serialize::write_string(ss, index_->getstate());
-  detail::serialize::write_data(ss, max_distance_);
-  detail::serialize::write_matrix<int, Eigen::Dynamic, N * 3>(ss, codes_);
-  detail::serialize::write_constituent_map(ss, this->data_);
-  detail::serialize::write_unordered_map(ss, this->selected_indices_);
+  getstate(ss);
   return ss.str();
 }
 
+// /////////////////////////////////////////////////////////////////////////////
 template <typename T, int N>
-auto LGP<T, N>::setstate_instance(const string_view& data) {
-  detail::isviewstream ss(data);
-  ss.exceptions(std::stringstream::failbit);
-  this->tide_type_ = detail::serialize::read_data<TideType>(ss);
+auto LGP<T, N>::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_data(os, this->tide_type_);
+  detail::serialize::write_data(os, expected_data_size_);
+  // The index is written in place, its size being computed beforehand.
+  detail::serialize::write_object(os, *index_);
+  detail::serialize::write_data(os, max_distance_);
+  detail::serialize::write_matrix(os, codes_);
+  detail::serialize::write_constituent_map(os, this->data_);
+  detail::serialize::write_matrix(os, this->selected_indices_);
+  detail::serialize::write_data(os, interleaved());
+  if (interleaved()) {
+    detail::serialize::write_matrix(os, node_values_);
+  }
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T, int N>
+auto LGP<T, N>::setstate_instance(std::istream& is) -> void {
+  this->tide_type_ = detail::serialize::read_data<TideType>(is);
+  this->expected_data_size_ = detail::serialize::read_data<int>(is);
   this->index_ = std::make_shared<mesh::Index>(
-      mesh::Index::setstate(detail::serialize::read_string(ss)));
-  this->max_distance_ = detail::serialize::read_data<double>(ss);
-  this->codes_ = detail::serialize::read_matrix<int, Eigen::Dynamic, N * 3>(ss);
+      detail::serialize::read_object<mesh::Index>(is));
+  this->max_distance_ = detail::serialize::read_data<double>(is);
+  this->codes_ =
+      detail::serialize::read_shared_matrix<int, Eigen::Dynamic, N * 3>(is);
   this->data_ =
-      detail::serialize::read_constituent_map<Constituent, std::complex<T>>(ss);
+      detail::serialize::read_constituent_map<Constituent, std::complex<T>>(is);
   this->selected_indices_ =
-      detail::serialize::read_unordered_map<int64_t, int64_t>(ss);
+      detail::serialize::read_matrix<int64_t, Eigen::Dynamic, 1>(is);
+  // The values of an interleaved model are only stored in the node-major
+  // table.
+  this->interleaved_ = detail::serialize::read_data<bool>(is);
+  if (this->interleaved_) {
+    this->node_values_ = detail::serialize::read_shared_matrix<
+        std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(is);
+    if (this->node_values_.rows() != this->expected_data_size_ ||
+        this->node_values_.cols() !=
+            static_cast<Eigen::Index>(this->data_.size())) {
+      throw std::invalid_argument("invalid node-major table");
+    }
+  }
+  // The codes are used as positions in the wave values without bounds
+  // checking.
+  if (this->expected_data_size_ < 0 ||
+      this->index_->n_triangles() != static_cast<size_t>(this->codes_.rows()) ||
+      !detail::serialize::in_range(this->codes_, kUnselected,
+                                   this->expected_data_size_) ||
+      (this->selected_indices_.size() != 0 &&
+       this->selected_indices_.size() != this->expected_data_size_)) {
+    throw std::invalid_argument("invalid LGP codes");
+  }
+  const auto size = this->interleaved_ ? 0 : this->expected_data_size_;
+  for (const auto& item : this->data_) {
+    if (item.second.size() != size) {
+      throw std::invalid_argument("invalid wave values");
+    }
+  }
 }
 
 }  // namespace tidal_model
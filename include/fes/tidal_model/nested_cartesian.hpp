@@ -0,0 +1,321 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+/// @file include/fes/tidal_model/nested_cartesian.hpp
+/// @brief Nested multi-resolution Cartesian tidal model
+#pragma once
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "fes/abstract_tidal_model.hpp"
+#include "fes/axis.hpp"
+#include "fes/detail/grid.hpp"
+#include "fes/detail/isviewstream.hpp"
+#include "fes/detail/region_lookup.hpp"
+#include "fes/detail/serialize.hpp"
+#include "fes/string_view.hpp"
+#include "fes/tidal_model/cartesian.hpp"
+
+namespace fes {
+namespace tidal_model {
+
+/// @brief %Nested Cartesian tidal model.
+///
+/// The model combines several Cartesian grids of different resolutions, for
+/// example a global grid and high-resolution regional grids. The grids are
+/// ordered by decreasing priority (from the finest to the coarsest): a point
+/// is interpolated on the first grid covering it where the wave model is
+/// defined, the following grids being used as fallbacks. A coarse global
+/// raster, built once, gives for each of its cells the grids to consider, so
+/// that the dispatch of a point does not depend on the number of grids.
+///
+/// The values of the tidal constituents of all grids are stored end to end in
+/// a single vector per constituent, in the order of the grids.
+///
+/// @tparam T The type of the tidal model.
+template <typename T>
+class NestedCartesian : public AbstractTidalModel<T> {
+ public:
+  /// Properties of a grid of the model.
+  struct Grid {
+    /// Longitude axis.
+    Axis lon;
+    /// Latitude axis.
+    Axis lat;
+    /// Whether the data is stored in longitude-major order.
+    bool row_major;
+    /// Position of the first value of the grid in the constituent vectors.
+    Eigen::Index offset;
+  };
+
+  /// Build a nested model from Cartesian models.
+  ///
+  /// @param[in] models The Cartesian models, ordered from the finest to the
+  /// coarsest. All models must handle the same tide type and the same tidal
+  /// constituents. Their extrapolation settings are not used: the coarser
+  /// grids provide the values where the finer ones are undefined.
+  /// @param[in] resolution The size, in degrees, of the cells of the raster
+  /// used to dispatch the points to the grids.
+  explicit NestedCartesian(
+      const std::vector<std::shared_ptr<Cartesian<T>>>& models,
+      double resolution = 1.0);
+
+  /// Returns the accelerator used to speed up the interpolation.
+  ///
+  /// @param[in] formulae The formulae used to calculate the astronomic angle.
+  /// @param[in] time_tolerance The time in seconds during which astronomical
+  /// angles are considered constant. The default value is 0 seconds, indicating
+  /// that astronomical angles do not remain constant with time.
+  /// @return The accelerator.
+  constexpr auto accelerator(const angle::Formulae& formulae,
+                             const double time_tolerance) const
+      -> Accelerator* override {
+    return new Accelerator(formulae, time_tolerance, this->data_.size());
+  }
+
+  /// Add a tidal constituent to the model.
+  ///
+  /// @param[in] ident The tidal constituent identifier.
+  /// @param[in] wave The tidal constituent modelled on all grids, stored end
+  /// to end in the order of the grids.
+  inline auto add_constituent(const Constituent ident,
+                              Vector<std::complex<T>> wave) -> void override {
+    if (wave.size() != size_) {
+      throw std::invalid_argument("wave size does not match expected size");
+    }
+    this->data_.emplace(ident, std::move(wave));
+  }
+
+  /// Interpolate the tidal constituents at a given point.
+  ///
+  /// @param[in] point The point to interpolate at.
+  /// @param[out] quality The number of grid corners used to interpolate, or
+  /// kUndefined if no grid defines the wave model at this point.
+  /// @param[inout] acc The accelerator to use.
+  /// @return The interpolated tidal constituents.
+  auto interpolate(const geometry::Point& point, Quality& quality,
+                   Accelerator* acc) const -> const ConstituentValues& override;
+
+  /// Get the grids of the model, ordered from the finest to the coarsest.
+  constexpr auto grids() const noexcept -> const std::vector<Grid>& {
+    return grids_;
+  }
+
+  /// Get the size, in degrees, of the cells of the dispatch raster.
+  constexpr auto resolution() const noexcept -> double {
+    return lookup_.resolution();
+  }
+
+  /// Serialize the tidal model.
+  ///
+  /// @return The serialized tidal model.
+  auto getstate() const -> std::string;
+
+  /// Deserialize the tidal model.
+  ///
+  /// @param[in] data The serialized tidal model.
+  /// @return The deserialized tidal model.
+  static auto setstate(const string_view& data) -> NestedCartesian<T>;
+
+ private:
+  /// Grids of the model.
+  std::vector<Grid> grids_{};
+  /// Total number of values of the grids.
+  Eigen::Index size_{};
+  /// Raster dispatching the points to the grids.
+  detail::RegionLookup lookup_{};
+
+  /// Default constructor used by the deserialization.
+  explicit NestedCartesian(TideType tide_type)
+      : AbstractTidalModel<T>(tide_type) {}
+
+  /// Compute the offsets of the grids and build the dispatch raster.
+  ///
+  /// @param[in] resolution The size of the raster cells, in degrees.
+  auto initialize(double resolution) -> void;
+
+  /// Interpolate the tidal constituents on a grid.
+  ///
+  /// @param[in] grid The grid to use.
+  /// @param[in] point The point to interpolate at.
+  /// @param[out] quality The number of grid corners used to interpolate.
+  /// @param[inout] acc The accelerator to use.
+  /// @return True if all the tidal constituents are defined at this point.
+  auto interpolate_grid(const Grid& grid, const geometry::Point& point,
+                        Quality& quality, Accelerator* acc) const -> bool;
+};
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+NestedCartesian<T>::NestedCartesian(
+    const std::vector<std::shared_ptr<Cartesian<T>>>& models,
+    const double resolution) {
+  if (models.empty()) {
+    throw std::invalid_argument("at least one model is required");
+  }
+  const auto& first = *models.front();
+  this->tide_type_ = first.tide_type();
+  this->dynamic_ = first.dynamic();
+
+  for (const auto& item : models) {
+    if (item->tide_type() != this->tide_type_) {
+      throw std::invalid_argument("the models must handle the same tide type");
+    }
+    if (item->identifiers() != first.identifiers()) {
+      throw std::invalid_argument(
+          "the models must handle the same tidal constituents");
+    }
+    grids_.push_back({item->lon(), item->lat(), item->row_major(), 0});
+  }
+  initialize(resolution);
+
+  for (const auto& item : first.data()) {
+    auto wave = Vector<std::complex<T>>(size_);
+    for (size_t ix = 0; ix < models.size(); ++ix) {
+      const auto& values = models[ix]->data().at(item.first);
+      wave.segment(grids_[ix].offset, values.size()) = values;
+    }
+    this->data_.emplace(item.first, std::move(wave));
+  }
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto NestedCartesian<T>::initialize(const double resolution) -> void {
+  auto axes = std::vector<std::pair<const Axis*, const Axis*>>();
+  axes.reserve(grids_.size());
+  size_ = 0;
+  for (auto& item : grids_) {
+    item.offset = size_;
+    size_ += item.lon.size() * item.lat.size();
+    axes.emplace_back(&item.lon, &item.lat);
+  }
+  lookup_ = detail::RegionLookup(axes, resolution);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto NestedCartesian<T>::interpolate_grid(const Grid& grid,
+                                          const geometry::Point& point,
+                                          Quality& quality,
+                                          Accelerator* acc) const -> bool {
+  acc->clear();
+  // The longitude axes of the regional grids are not circular: the longitude
+  // must be expressed in the same range as the axis.
+  const auto lon = detail::math::normalize_angle(point.lon(),
+                                                 grid.lon.min_value());
+  auto lon_index = grid.lon.find_indices(lon);
+  auto lat_index = grid.lat.find_indices(point.lat());
+  if (!lon_index || !lat_index) {
+    return false;
+  }
+
+  int64_t i1;
+  int64_t i2;
+  int64_t j1;
+  int64_t j2;
+  std::tie(i1, i2) = *lon_index;
+  std::tie(j1, j2) = *lat_index;
+  const auto x1 = grid.lon(i1);
+  const auto x2 = grid.lon(i2);
+  const auto y1 = grid.lat(j1);
+  const auto y2 = grid.lat(j2);
+  auto n = int64_t{0};
+
+  auto wxy = detail::math::bilinear_weights(
+      detail::math::normalize_angle(lon, x1), point.lat(), x1, y1,
+      detail::math::normalize_angle(x2, x1), y2);
+
+  auto values = detail::Grid<std::complex<T>>(
+      nullptr, static_cast<size_t>(grid.lon.size()),
+      static_cast<size_t>(grid.lat.size()), grid.row_major);
+  for (const auto& item : this->data_) {
+    values.data(item.second.data() + grid.offset);
+    auto value = detail::math::bilinear_interpolation<std::complex<double>>(
+        std::get<0>(wxy), std::get<1>(wxy), std::get<2>(wxy), std::get<3>(wxy),
+        values(i1, j1), values(i1, j2), values(i2, j1), values(i2, j2), n);
+    if (std::isnan(value.real()) || std::isnan(value.imag())) {
+      return false;
+    }
+    acc->emplace_back(item.first, value);
+  }
+  quality = static_cast<Quality>(n);
+  return true;
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto NestedCartesian<T>::interpolate(const geometry::Point& point,
+                                     Quality& quality, Accelerator* acc) const
+    -> const ConstituentValues& {
+  // The candidate grids are sorted by decreasing priority: the first one
+  // defining the wave model at this point is used.
+  auto range = lookup_.candidates(point.lon(), point.lat());
+  for (auto it = range.first; it != range.second; ++it) {
+    if (interpolate_grid(grids_[*it], point, quality, acc)) {
+      return acc->values();
+    }
+  }
+
+  // No grid defines the wave model at this point.
+  constexpr auto undefined_value =
+      std::complex<double>(std::numeric_limits<double>::quiet_NaN(),
+                           std::numeric_limits<double>::quiet_NaN());
+  acc->clear();
+  for (const auto& item : this->data_) {
+    acc->emplace_back(item.first, undefined_value);
+  }
+  quality = kUndefined;
+  return acc->values();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto NestedCartesian<T>::getstate() const -> std::string {
+  auto ss = std::stringstream();
+  ss.exceptions(std::stringstream::failbit);
+  detail::serialize::write_data(ss, this->tide_type_);
+  detail::serialize::write_data(ss, lookup_.resolution());
+  detail::serialize::write_data(ss, grids_.size());
+  for (const auto& item : grids_) {
+    detail::serialize::write_data(ss, item.row_major);
+    detail::serialize::write_string(ss, item.lon.getstate());
+    detail::serialize::write_string(ss, item.lat.getstate());
+  }
+  detail::serialize::write_constituent_map(ss, this->data_);
+  return ss.str();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+template <typename T>
+auto NestedCartesian<T>::setstate(const string_view& data)
+    -> NestedCartesian<T> {
+  detail::isviewstream ss(data);
+  ss.exceptions(std::stringstream::failbit);
+  try {
+    auto model = NestedCartesian<T>(detail::serialize::read_data<TideType>(ss));
+    auto resolution = detail::serialize::read_data<double>(ss);
+    auto size = detail::serialize::read_data<size_t>(ss);
+    for (size_t ix = 0; ix < size; ++ix) {
+      auto row_major = detail::serialize::read_data<bool>(ss);
+      auto lon = Axis::setstate(detail::serialize::read_string(ss));
+      auto lat = Axis::setstate(detail::serialize::read_string(ss));
+      model.grids_.push_back({std::move(lon), std::move(lat), row_major, 0});
+    }
+    model.initialize(resolution);
+    model.data_ =
+        detail::serialize::read_constituent_map<Constituent, std::complex<T>>(
+            ss);
+    return model;
+  } catch (const std::exception&) {
+    throw std::invalid_argument("invalid tidal model state");
+  }
+}
+
+}  // namespace tidal_model
+}  // namespace fes
@@ -62,8 +62,8 @@ static auto build_wave_table(const AbstractTidalModel<T>* const tidal_model)
   auto result = wave::Table();
 
   // Add the constituents provided by the model.
-  for (const auto& item : tidal_model->data()) {
-    auto& wave = result[item.first];
+  for (const auto& item : tidal_model->identifiers()) {
+    auto& wave = result[item];
     wave->dynamic(true);
     wave->admittance(false);
   }
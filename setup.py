@@ -164,11 +164,12 @@ class BuildExt(setuptools.command.build_ext.build_ext):
                      ('generator=', None, 'Selected CMake generator'),
                      ('mkl=', None, 'Using MKL as BLAS library'),
                      ('iers=', None, 'Use IERS 2010 constants'),
+                     ('netcdf=', None, 'Enable the native NetCDF loader'),
                      ('reconfigure', None,
                       'Forces CMake to reconfigure this project')]
 
     boolean_options = setuptools.command.build_ext.build_ext.boolean_options
-    boolean_options += ['mkl', 'iers']
+    boolean_options += ['mkl', 'iers', 'netcdf']
 
     def initialize_options(self) -> None:
         """Set default values for all the options that this command
@@ -179,6 +180,7 @@ class BuildExt(setuptools.command.build_ext.build_ext):
         self.generator = None
         self.iers = None
         self.mkl = None
+        self.netcdf = None
         self.reconfigure = None
 
     def run(self) -> None:
@@ -220,6 +222,9 @@ class BuildExt(setuptools.command.build_ext.build_ext):
         if self.iers:
             result.append('-DFES_USE_IERS_CONSTANTS=ON')
 
+        if self.netcdf:
+            result.append('-DFES_ENABLE_NETCDF=ON')
+
         if self.mkl:
             self.set_mklroot()
 
@@ -4,6 +4,9 @@
 // BSD-style license that can be found in the LICENSE file.
 #include "fes/axis.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "fes/detail/isviewstream.hpp"
 #include "fes/detail/math.hpp"
 #include "fes/detail/serialize.hpp"
@@ -74,8 +77,13 @@ auto Axis::initialize(const Eigen::Ref<const Eigen::VectorXd>& values,
   // interval.
   auto increment = Axis::is_evenly_spaced(values);
   if (!increment) {
-    throw std::invalid_argument(
-        "the axis values must be evenly spaced from each other.");
+    auto n = values.size() - 1;
+    auto delta = (values.tail(n) - values.head(n)).eval();
+    if (!(delta.array() > 0).all() && !(delta.array() < 0).all()) {
+      throw std::invalid_argument(
+          "the axis values must be strictly monotonic.");
+    }
+    points_ = values;
   }
   auto stop = values[values.size() - 1];
 
@@ -86,10 +94,93 @@ auto Axis::initialize(const Eigen::Ref<const Eigen::VectorXd>& values,
   is_ascending_ = size_ < 2 ? true : (*this)(0) < (*this)(1);
 
   if (is_circular_) {
-    is_circular_ =
-        detail::math::is_same(static_cast<double>(std::fabs(step_ * size_)),
-                              detail::math::circle_degrees<double>(), epsilon);
+    if (is_regular()) {
+      is_circular_ = detail::math::is_same(
+          static_cast<double>(std::fabs(step_ * size_)),
+          detail::math::circle_degrees<double>(), epsilon);
+    } else {
+      // The gap between the last and the first value, across the circle, must
+      // not be larger than the largest step of the axis.
+      auto gap =
+          detail::math::circle_degrees<double>() - std::fabs(stop - start_);
+      auto max_step = std::fabs(step_);
+      for (Eigen::Index ix = 1; ix < values.size(); ++ix) {
+        max_step = std::max(max_step, std::fabs(values[ix] - values[ix - 1]));
+      }
+      is_circular_ = gap > epsilon && gap <= max_step + epsilon;
+    }
+  }
+  if (!is_regular()) {
+    build_buckets();
+  }
+}
+
+auto Axis::build_buckets() -> void {
+  auto first = sorted_value(0);
+  auto range = sorted_value(size_ - 1) - first;
+  auto min_step = range;
+  for (int64_t ix = 1; ix < size_; ++ix) {
+    min_step = std::min(min_step, sorted_value(ix) - sorted_value(ix - 1));
+  }
+  // With buckets not wider than the smallest step, each bucket contains at
+  // most one axis value. The number of buckets is bounded to avoid a huge
+  // table for axes mixing very small and very large steps.
+  auto count = std::min(
+      std::max(static_cast<int64_t>(std::ceil(range / min_step)), size_),
+      size_ * 16);
+  bucket_scale_ = static_cast<double>(count) / range;
+  buckets_.resize(count);
+
+  auto rank = int64_t(0);
+  for (int64_t ix = 0; ix < count; ++ix) {
+    auto lower = first + static_cast<double>(ix) / bucket_scale_;
+    while (rank + 1 < size_ && sorted_value(rank + 1) <= lower) {
+      ++rank;
+    }
+    buckets_[ix] = rank;
+  }
+}
+
+auto Axis::find_irregular_index(const double coordinate,
+                                const bool bounded) const noexcept -> int64_t {
+  auto to_index = [this](const int64_t rank) -> int64_t {
+    return is_ascending_ ? rank : size_ - 1 - rank;
+  };
+  auto first = sorted_value(0);
+  auto last = sorted_value(size_ - 1);
+
+  // As for an evenly spaced axis, the coordinates located less than half a
+  // step away from the axis limits are associated with the first or last
+  // value.
+  if (coordinate < first) {
+    if (first - coordinate > (sorted_value(1) - first) * 0.5) {
+      return bounded ? to_index(0) : -1;
+    }
+    return to_index(0);
+  }
+  if (coordinate > last) {
+    auto half_step = is_circular_
+                         ? (circle_ - (last - first)) * 0.5
+                         : (last - sorted_value(size_ - 2)) * 0.5;
+    if (coordinate - last > half_step) {
+      return bounded ? to_index(size_ - 1) : -1;
+    }
+    return to_index(size_ - 1);
+  }
+
+  auto bucket =
+      std::min(static_cast<int64_t>((coordinate - first) * bucket_scale_),
+               static_cast<int64_t>(buckets_.size() - 1));
+  auto rank = buckets_[bucket];
+  while (rank + 1 < size_ && sorted_value(rank + 1) <= coordinate) {
+    ++rank;
   }
+  // Selects the closest value of the two framing the coordinate.
+  if (rank + 1 < size_ &&
+      sorted_value(rank + 1) - coordinate <= coordinate - sorted_value(rank)) {
+    ++rank;
+  }
+  return to_index(rank);
 }
 
 auto Axis::find_indices(double coordinate) const
@@ -141,28 +232,45 @@ auto Axis::find_indices(double coordinate) const
 auto Axis::getstate() const -> std::string {
   auto ss = std::stringstream();
   ss.exceptions(std::stringstream::failbit);
-  detail::serialize::write_data(ss, is_circular_);
-  detail::serialize::write_data(ss, circle_);
-  detail::serialize::write_data(ss, is_ascending_);
-  detail::serialize::write_data(ss, start_);
-  detail::serialize::write_data(ss, size_);
-  detail::serialize::write_data(ss, step_);
+  getstate(ss);
   return ss.str();
 }
 
+auto Axis::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_data(os, is_circular_);
+  detail::serialize::write_data(os, circle_);
+  detail::serialize::write_data(os, is_ascending_);
+  detail::serialize::write_data(os, start_);
+  detail::serialize::write_data(os, size_);
+  detail::serialize::write_data(os, step_);
+  detail::serialize::write_matrix(os, points_);
+}
+
 auto Axis::setstate(const string_view& data) -> Axis {
   detail::isviewstream ss(data);
   ss.exceptions(std::stringstream::failbit);
+  return setstate(ss);
+}
+
+auto Axis::setstate(std::istream& is) -> Axis {
   try {
     auto result = Axis();
-    result.is_circular_ = detail::serialize::read_data<bool>(ss);
-    result.circle_ = detail::serialize::read_data<double>(ss);
-    result.is_ascending_ = detail::serialize::read_data<bool>(ss);
-    result.start_ = detail::serialize::read_data<double>(ss);
-    result.size_ = detail::serialize::read_data<int64_t>(ss);
-    result.step_ = detail::serialize::read_data<double>(ss);
+    result.is_circular_ = detail::serialize::read_data<bool>(is);
+    result.circle_ = detail::serialize::read_data<double>(is);
+    result.is_ascending_ = detail::serialize::read_data<bool>(is);
+    result.start_ = detail::serialize::read_data<double>(is);
+    result.size_ = detail::serialize::read_data<int64_t>(is);
+    result.step_ = detail::serialize::read_data<double>(is);
+    result.points_ =
+        detail::serialize::read_matrix<double, Eigen::Dynamic, 1>(is);
+    if (!result.is_regular()) {
+      if (result.points_.size() != result.size_) {
+        throw std::invalid_argument("invalid axis state");
+      }
+      result.build_buckets();
+    }
     return result;
-  } catch (const std::ios_base::failure&) {
+  } catch (const std::runtime_error&) {
     throw std::invalid_argument("invalid axis state");
   }
 }
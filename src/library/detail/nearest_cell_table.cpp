@@ -0,0 +1,159 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/detail/nearest_cell_table.hpp"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "fes/detail/grid.hpp"
+#include "fes/detail/math.hpp"
+#include "fes/geometry/point.hpp"
+
+namespace fes {
+namespace detail {
+
+/// Cell of the grid waiting to propagate its nearest defined cell.
+struct PendingCell {
+  /// Distance between the cell and its nearest defined cell.
+  double distance;
+  /// Longitude index of the cell.
+  int64_t x;
+  /// Latitude index of the cell.
+  int64_t y;
+
+  /// Order the cells by increasing distance.
+  constexpr auto operator>(const PendingCell& other) const noexcept -> bool {
+    return distance > other.distance;
+  }
+};
+
+NearestCellTable::NearestCellTable(const Axis& lon, const Axis& lat,
+                                   const Eigen::Ref<const Vector<bool>>& valid,
+                                   const bool row_major,
+                                   const double max_distance) {
+  const auto nx = lon.size();
+  const auto ny = lat.size();
+  if (valid.size() != nx * ny) {
+    throw std::invalid_argument("mask size does not match expected size");
+  }
+  if (nx * ny > std::numeric_limits<int32_t>::max()) {
+    throw std::invalid_argument(
+        "the grid is too large to build the extrapolation table");
+  }
+
+  // ECEF coordinates of the grid nodes, split into the latitude dependent
+  // part (distance to the Earth's axis and height) and the longitude
+  // dependent part (direction cosines).
+  auto axis_distance = Eigen::VectorXd(ny);
+  auto height = Eigen::VectorXd(ny);
+  for (int64_t iy = 0; iy < ny; ++iy) {
+    auto ecef = static_cast<geometry::EarthCenteredEarthFixed>(
+        geometry::Point(0, lat(iy)));
+    axis_distance(iy) = ecef.x();
+    height(iy) = ecef.z();
+  }
+  auto cos_lon = Eigen::VectorXd(nx);
+  auto sin_lon = Eigen::VectorXd(nx);
+  for (int64_t ix = 0; ix < nx; ++ix) {
+    std::tie(sin_lon(ix), cos_lon(ix)) = math::sincosd(lon(ix));
+  }
+  auto distance = [&](const int64_t x0, const int64_t y0, const int64_t x1,
+                      const int64_t y1) -> double {
+    return std::sqrt(
+        math::pow<2>(axis_distance(y0) * cos_lon(x0) -
+                     axis_distance(y1) * cos_lon(x1)) +
+        math::pow<2>(axis_distance(y0) * sin_lon(x0) -
+                     axis_distance(y1) * sin_lon(x1)) +
+        math::pow<2>(height(y0) - height(y1)));
+  };
+
+  auto grid = Grid<bool>(valid.data(), nx, ny, row_major);
+  auto is_circular = lon.is_circular();
+
+  // Returns the longitude index of a neighbor, or -1 if it is outside the
+  // grid.
+  auto neighbor_x = [&](const int64_t ix, const int64_t dx) -> int64_t {
+    auto result = ix + dx;
+    if (result < 0 || result >= nx) {
+      return is_circular ? math::remainder(result, nx) : -1;
+    }
+    return result;
+  };
+
+  nearest_ = Vector<int32_t>::Constant(nx * ny, -1);
+  auto cell_distance =
+      std::vector<double>(nx * ny, std::numeric_limits<double>::max());
+  auto queue = std::priority_queue<PendingCell, std::vector<PendingCell>,
+                                   std::greater<PendingCell>>();
+
+  // The defined cells are their own nearest cell. Those bordering an
+  // undefined cell seed the propagation.
+  for (int64_t ix = 0; ix < nx; ++ix) {
+    for (int64_t iy = 0; iy < ny; ++iy) {
+      if (!grid(ix, iy)) {
+        continue;
+      }
+      const auto index = grid.index(ix, iy);
+      nearest_(index) = static_cast<int32_t>(index);
+      cell_distance[index] = 0;
+
+      auto is_coast = false;
+      for (int64_t dx = -1; dx <= 1 && !is_coast; ++dx) {
+        const auto jx = neighbor_x(ix, dx);
+        for (int64_t jy = iy - 1; jx != -1 && jy <= iy + 1; ++jy) {
+          if (jy >= 0 && jy < ny && !grid(jx, jy)) {
+            is_coast = true;
+            break;
+          }
+        }
+      }
+      if (is_coast) {
+        queue.push({0, ix, iy});
+      }
+    }
+  }
+
+  // Propagates, in increasing order of distance, the nearest defined cell to
+  // the undefined neighbors.
+  while (!queue.empty()) {
+    const auto cell = queue.top();
+    queue.pop();
+    const auto index = grid.index(cell.x, cell.y);
+    if (cell.distance > cell_distance[index]) {
+      continue;
+    }
+    const auto source = nearest_(index);
+    const auto sx = row_major ? source / ny : source % nx;
+    const auto sy = row_major ? source % ny : source / nx;
+
+    for (int64_t dx = -1; dx <= 1; ++dx) {
+      const auto jx = neighbor_x(cell.x, dx);
+      if (jx == -1) {
+        continue;
+      }
+      for (int64_t jy = cell.y - 1; jy <= cell.y + 1; ++jy) {
+        if (jy < 0 || jy >= ny || grid(jx, jy)) {
+          continue;
+        }
+        const auto item = grid.index(jx, jy);
+        const auto item_distance = distance(jx, jy, sx, sy);
+        if (item_distance <= max_distance &&
+            item_distance < cell_distance[item]) {
+          cell_distance[item] = item_distance;
+          nearest_(item) = source;
+          queue.push({item_distance, jx, jy});
+        }
+      }
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace fes
@@ -0,0 +1,122 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/detail/region_lookup.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "fes/detail/math.hpp"
+
+namespace fes {
+namespace detail {
+
+RegionLookup::RegionLookup(
+    const Eigen::Ref<const Eigen::Matrix<double, -1, 4>>& extents,
+    const double resolution)
+    : resolution_(resolution) {
+  if (!(resolution > 0) || resolution > 180) {
+    throw std::invalid_argument(
+        "the resolution must be in the range ]0, 180] degrees");
+  }
+  if (extents.rows() > std::numeric_limits<int32_t>::max()) {
+    throw std::invalid_argument("too many regions to index");
+  }
+  nx_ = static_cast<int64_t>(
+      std::ceil(math::circle_degrees<double>() / resolution));
+  ny_ = static_cast<int64_t>(std::ceil(180 / resolution));
+
+  // Calls the given function for each raster cell covered by a region.
+  auto for_each_cell = [&](const Eigen::Index ix, const auto& function) {
+    auto extent = extents.row(ix);
+    if (!extent.allFinite()) {
+      return;
+    }
+    auto x0 = int64_t(0);
+    auto width = nx_;
+    if (extent(2) - extent(0) < math::circle_degrees<double>()) {
+      x0 = column(extent(0));
+      width = std::min(nx_, math::remainder(column(extent(2)) - x0, nx_) + 1);
+    }
+    const auto y0 = row(extent(1));
+    const auto y1 = row(extent(3));
+    for (int64_t jx = 0; jx < width; ++jx) {
+      const auto x = (x0 + jx) % nx_;
+      for (auto y = y0; y <= y1; ++y) {
+        function(y * nx_ + x);
+      }
+    }
+  };
+
+  // First pass: count the regions covering each cell.
+  offsets_ = Vector<int32_t>::Zero(nx_ * ny_ + 1);
+  for (Eigen::Index ix = 0; ix < extents.rows(); ++ix) {
+    for_each_cell(ix, [&](const int64_t cell) { ++offsets_[cell + 1]; });
+  }
+  for (Eigen::Index ix = 0; ix < nx_ * ny_; ++ix) {
+    if (offsets_[ix + 1] > std::numeric_limits<int32_t>::max() - offsets_[ix]) {
+      throw std::invalid_argument(
+          "the resolution is too fine for the number of regions to index");
+    }
+    offsets_[ix + 1] += offsets_[ix];
+  }
+
+  // Second pass: store the regions, sorted by increasing index.
+  regions_ = Vector<int32_t>(offsets_[nx_ * ny_]);
+  auto position = Vector<int32_t>(offsets_.head(nx_ * ny_));
+  for (Eigen::Index ix = 0; ix < extents.rows(); ++ix) {
+    for_each_cell(ix, [&](const int64_t cell) {
+      regions_[position[cell]++] = static_cast<int32_t>(ix);
+    });
+  }
+}
+
+RegionLookup::RegionLookup(
+    const std::vector<std::pair<const Axis*, const Axis*>>& grids,
+    const double resolution)
+    : RegionLookup(RegionLookup::extents(grids), resolution) {}
+
+auto RegionLookup::extents(
+    const std::vector<std::pair<const Axis*, const Axis*>>& grids)
+    -> Eigen::Matrix<double, -1, 4> {
+  auto result =
+      Eigen::Matrix<double, -1, 4>(static_cast<Eigen::Index>(grids.size()), 4);
+  for (size_t ix = 0; ix < grids.size(); ++ix) {
+    const auto& lon = *grids[ix].first;
+    const auto& lat = *grids[ix].second;
+    auto x0 = lon.min_value();
+    auto x1 = lon.max_value();
+    if (lon.is_circular()) {
+      x1 = x0 + math::circle_degrees<double>();
+    }
+    result.row(ix) << x0, lat.min_value(), x1, lat.max_value();
+  }
+  return result;
+}
+
+auto RegionLookup::column(const double lon) const noexcept -> int64_t {
+  const auto x = static_cast<int64_t>(
+      (math::normalize_angle(lon, -180.0) + 180) / resolution_);
+  return std::min(std::max(x, int64_t(0)), nx_ - 1);
+}
+
+auto RegionLookup::row(const double lat) const noexcept -> int64_t {
+  const auto y = static_cast<int64_t>(std::floor((lat + 90) / resolution_));
+  return std::min(std::max(y, int64_t(0)), ny_ - 1);
+}
+
+auto RegionLookup::candidates(const double lon, const double lat) const noexcept
+    -> std::pair<const int32_t*, const int32_t*> {
+  if (offsets_.size() == 0 || !std::isfinite(lon) || !std::isfinite(lat)) {
+    return {nullptr, nullptr};
+  }
+  const auto cell = row(lat) * nx_ + column(lon);
+  return {regions_.data() + offsets_[cell],
+          regions_.data() + offsets_[cell + 1]};
+}
+
+}  // namespace detail
+}  // namespace fes
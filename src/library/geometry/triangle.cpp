@@ -14,33 +14,18 @@ constexpr auto shift(const double value, const double center) -> double {
   return detail::math::normalize_angle(result, center - 180.0);
 }
 
-inline auto shift(const Point& point, const Triangle& triangle) -> Triangle {
-  const auto& v1 = triangle.v1();
-  const auto& v2 = triangle.v2();
-  const auto& v3 = triangle.v3();
-  const auto lon1 = shift(v1.lon(), point.lon());
-  const auto lon2 = shift(v2.lon(), lon1);
-  const auto lon3 = shift(v3.lon(), lon2);
-
-  return {Point(lon1, v1.lat()), Point(lon2, v2.lat()), Point(lon3, v3.lat())};
-}
-
-auto Triangle::reference_right_angled(const Point& point) const
+/// Compute the angles of the reference right-angled triangle of the vertices
+/// v1, v2 and v3, the longitudes being shifted around the point.
+static auto reference_right_angled(const Point& point, const Point& v1,
+                                   const Point& v2, const Point& v3)
     -> std::tuple<double, double> {
-  auto const vertices = shift(point, *this).outer();
-  auto iter = vertices.begin();
-
-  // Read lon/lat of the first vertex of the triangle
-  const auto t1 = iter->lon();
-  const auto p1 = iter->lat();
-
-  // Read lon/lat of the second vertex of the triangle
-  const auto t2 = (++iter)->lon();
-  const auto p2 = iter->lat();
-
-  // Read lon/lat of the third vertex of the triangle
-  const auto t3 = (++iter)->lon();
-  const auto p3 = iter->lat();
+  // Read lon/lat of the vertices of the triangle
+  const auto t1 = shift(v1.lon(), point.lon());
+  const auto p1 = v1.lat();
+  const auto t2 = shift(v2.lon(), t1);
+  const auto p2 = v2.lat();
+  const auto t3 = shift(v3.lon(), t2);
+  const auto p3 = v3.lat();
 
   const auto ctx = t2 - t1;
   const auto cty = t3 - t1;
@@ -63,5 +48,15 @@ auto Triangle::reference_right_angled(const Point& point) const
   return {x, y};
 }
 
+auto Triangle::reference_right_angled(const Point& point) const
+    -> std::tuple<double, double> {
+  return geometry::reference_right_angled(point, v1(), v2(), v3());
+}
+
+auto StaticTriangle::reference_right_angled(const Point& point) const
+    -> std::tuple<double, double> {
+  return geometry::reference_right_angled(point, v1(), v2(), v3());
+}
+
 }  // namespace geometry
 }  // namespace fes
@@ -0,0 +1,223 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/bucket_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+
+#include "fes/detail/isviewstream.hpp"
+#include "fes/detail/math.hpp"
+#include "fes/detail/serialize.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// Number of buckets of a row of the grid, proportional to the cosine of the
+/// latitude of its center.
+static auto row_size(const int64_t row, const double resolution) -> int64_t {
+  const auto center = -90 + (static_cast<double>(row) + 0.5) * resolution;
+  const auto width = detail::math::circle_degrees<double>() *
+                     std::cos(detail::math::radians(std::min(center, 90.0)));
+  return std::max(static_cast<int64_t>(std::ceil(width / resolution)),
+                  int64_t(1));
+}
+
+BucketGrid::BucketGrid(
+    const Eigen::Ref<const Eigen::VectorXd>& lon,
+    const Eigen::Ref<const Eigen::VectorXd>& lat,
+    const Eigen::Ref<const Eigen::Matrix<int32_t, -1, 3>>& triangles,
+    double resolution) {
+  if (!(resolution >= 0) || resolution > 180) {
+    throw std::invalid_argument(
+        "the resolution must be in the range [0, 180] degrees");
+  }
+  const auto n = triangles.rows();
+  if (n == 0) {
+    return;
+  }
+
+  // Bounding box of each triangle. The longitudes are expressed relative to
+  // the first vertex to handle the triangles crossing the antimeridian.
+  auto boxes = Eigen::Matrix<double, -1, 4>(n, 4);
+  auto mean_size = 0.0;
+  auto min_lat = 90.0;
+  auto max_lat = -90.0;
+  for (Eigen::Index ix = 0; ix < n; ++ix) {
+    const auto x0 = lon(triangles(ix, 0));
+    auto box = boxes.row(ix);
+    box << x0, 90, x0, -90;
+    for (auto jx = 0; jx < 3; ++jx) {
+      const auto x = detail::math::normalize_angle(lon(triangles(ix, jx)),
+                                                   x0 - 180.0);
+      const auto y = lat(triangles(ix, jx));
+      box(0) = std::min(box(0), x);
+      box(1) = std::min(box(1), y);
+      box(2) = std::max(box(2), x);
+      box(3) = std::max(box(3), y);
+    }
+    const auto cos_lat =
+        std::cos(detail::math::radians((box(1) + box(3)) * 0.5));
+    mean_size += std::max(box(3) - box(1), (box(2) - box(0)) * cos_lat);
+    min_lat = std::min(min_lat, box(1));
+    max_lat = std::max(max_lat, box(3));
+  }
+  mean_size /= static_cast<double>(n);
+
+  // By default, a bucket is about twice the mean size of the triangles.
+  resolution_ = resolution != 0 ? resolution
+                : mean_size > 0 ? std::min(2 * mean_size, 180.0)
+                                : 1.0;
+
+  // Only the rows covering the mesh contain buckets. The resolution is
+  // coarsened until the number of buckets is reasonable.
+  const auto max_buckets =
+      std::max(kMaxBucketsPerTriangle * n, int64_t{kMinBuckets});
+  while (true) {
+    ny_ = static_cast<int64_t>(std::ceil(180 / resolution_));
+    auto columns = Vector<int64_t>::Zero(ny_ + 1).eval();
+    const auto first = row(min_lat);
+    const auto last = row(max_lat);
+    for (auto jx = int64_t(0); jx < ny_; ++jx) {
+      columns[jx + 1] =
+          columns[jx] +
+          (jx >= first && jx <= last ? row_size(jx, resolution_) : 0);
+    }
+    columns_ = std::move(columns);
+    if (size() <= max_buckets || resolution_ >= 180) {
+      break;
+    }
+    const auto excess =
+        static_cast<double>(size()) / static_cast<double>(max_buckets);
+    resolution_ = std::min(resolution_ * std::sqrt(excess) * 1.01, 180.0);
+  }
+
+  // Calls the given function for each bucket covered by a triangle.
+  auto for_each_bucket = [&](const Eigen::Index ix, const auto& function) {
+    auto box = boxes.row(ix);
+    const auto y0 = row(box(1));
+    const auto y1 = row(box(3));
+    for (auto y = y0; y <= y1; ++y) {
+      const auto nx = columns_[y + 1] - columns_[y];
+      auto x0 = int64_t(0);
+      auto width = nx;
+      if (box(2) - box(0) < detail::math::circle_degrees<double>()) {
+        x0 = column(box(0), y);
+        width = std::min(
+            nx, detail::math::remainder(column(box(2), y) - x0, nx) + 1);
+      }
+      for (int64_t jx = 0; jx < width; ++jx) {
+        function(columns_[y] + (x0 + jx) % nx);
+      }
+    }
+  };
+
+  // First pass: count the triangles listed in each bucket.
+  auto offsets = Vector<int64_t>::Zero(size() + 1).eval();
+  for (Eigen::Index ix = 0; ix < n; ++ix) {
+    for_each_bucket(ix, [&](const int64_t bucket) { ++offsets[bucket + 1]; });
+  }
+  for (Eigen::Index ix = 0; ix < size(); ++ix) {
+    offsets[ix + 1] += offsets[ix];
+  }
+
+  // Second pass: store the triangles, sorted by increasing index.
+  auto bucket_triangles = Vector<int32_t>(offsets[size()]);
+  auto position = Vector<int64_t>(offsets.head(size()));
+  for (Eigen::Index ix = 0; ix < n; ++ix) {
+    for_each_bucket(ix, [&](const int64_t bucket) {
+      bucket_triangles[position[bucket]++] = static_cast<int32_t>(ix);
+    });
+  }
+  offsets_ = std::move(offsets);
+  triangles_ = std::move(bucket_triangles);
+}
+
+auto BucketGrid::row(const double lat) const noexcept -> int64_t {
+  const auto y = static_cast<int64_t>(std::floor((lat + 90) / resolution_));
+  return std::min(std::max(y, int64_t(0)), ny_ - 1);
+}
+
+auto BucketGrid::column(const double lon, const int64_t row) const noexcept
+    -> int64_t {
+  const auto nx = columns_[row + 1] - columns_[row];
+  const auto x = static_cast<int64_t>(
+      std::floor((detail::math::normalize_angle(lon, -180.0) + 180) *
+                 static_cast<double>(nx) /
+                 detail::math::circle_degrees<double>()));
+  return std::min(std::max(x, int64_t(0)), nx - 1);
+}
+
+auto BucketGrid::candidates(const double lon, const double lat) const noexcept
+    -> std::pair<const int32_t*, const int32_t*> {
+  if (empty() || !std::isfinite(lon) || !std::isfinite(lat)) {
+    return {nullptr, nullptr};
+  }
+  const auto y = row(lat);
+  if (columns_[y + 1] == columns_[y]) {
+    return {nullptr, nullptr};
+  }
+  const auto bucket = columns_[y] + column(lon, y);
+  return {triangles_.data() + offsets_[bucket],
+          triangles_.data() + offsets_[bucket + 1]};
+}
+
+auto BucketGrid::getstate() const -> std::string {
+  auto ss = std::stringstream();
+  ss.exceptions(std::stringstream::failbit);
+  getstate(ss);
+  return ss.str();
+}
+
+auto BucketGrid::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_data(os, resolution_);
+  detail::serialize::write_data(os, ny_);
+  detail::serialize::write_matrix(os, columns_);
+  detail::serialize::write_matrix(os, offsets_);
+  detail::serialize::write_matrix(os, triangles_);
+}
+
+auto BucketGrid::setstate(const string_view& data) -> BucketGrid {
+  detail::isviewstream ss(data);
+  ss.exceptions(std::stringstream::failbit);
+  return setstate(ss);
+}
+
+auto BucketGrid::setstate(std::istream& is) -> BucketGrid {
+  try {
+    auto result = BucketGrid();
+    result.resolution_ = detail::serialize::read_data<double>(is);
+    result.ny_ = detail::serialize::read_data<int64_t>(is);
+    result.columns_ =
+        detail::serialize::read_shared_matrix<int64_t, -1, 1>(is);
+    result.offsets_ =
+        detail::serialize::read_shared_matrix<int64_t, -1, 1>(is);
+    result.triangles_ =
+        detail::serialize::read_shared_matrix<int32_t, -1, 1>(is);
+    // The buckets of the rows and the triangles of the buckets are stored in
+    // compressed sparse row layouts. An empty grid has no arrays.
+    const auto valid =
+        result.columns_.size() == 0
+            ? result.offsets_.size() == 0 && result.triangles_.size() == 0
+            : result.ny_ > 0 && result.resolution_ > 0 &&
+                  result.columns_.size() == result.ny_ + 1 &&
+                  detail::serialize::is_offsets(result.columns_,
+                                                result.size()) &&
+                  detail::serialize::is_offsets(result.offsets_,
+                                                result.triangles_.size()) &&
+                  result.offsets_.size() == result.size() + 1;
+    if (!valid) {
+      throw std::invalid_argument("inconsistent grid state");
+    }
+    return result;
+  } catch (const std::exception&) {
+    throw std::invalid_argument("invalid grid state");
+  }
+}
+
+}  // namespace mesh
+}  // namespace fes
@@ -0,0 +1,327 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/coastal_band.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "fes/detail/isviewstream.hpp"
+#include "fes/detail/math.hpp"
+#include "fes/detail/serialize.hpp"
+#include "fes/geometry/ecef.hpp"
+#include "fes/geometry/point.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// Lower bound of the length of one degree of latitude, or of longitude at
+/// the equator, in meters.
+constexpr double kMinDegreeLength = 110000;
+
+/// Upper bound of the length of one degree of latitude, or of longitude at
+/// the equator, in meters.
+constexpr double kMaxDegreeLength = 111700;
+
+/// Columns of a row of the global grid covered by the band.
+struct Span {
+  /// The row.
+  int64_t row;
+  /// The first column.
+  int64_t first;
+  /// The last column (included).
+  int64_t last;
+};
+
+/// Sort the spans and merge those overlapping.
+///
+/// @return The number of cells covered by the spans.
+static auto merge(std::vector<Span>& spans) -> int64_t {
+  std::sort(spans.begin(), spans.end(), [](const Span& lhs, const Span& rhs) {
+    return std::tie(lhs.row, lhs.first) < std::tie(rhs.row, rhs.first);
+  });
+  auto size = size_t(0);
+  for (const auto& item : spans) {
+    if (size != 0 && spans[size - 1].row == item.row &&
+        item.first <= spans[size - 1].last + 1) {
+      spans[size - 1].last = std::max(spans[size - 1].last, item.last);
+    } else {
+      spans[size++] = item;
+    }
+  }
+  spans.resize(size);
+  auto result = int64_t(0);
+  for (const auto& item : spans) {
+    result += item.last - item.first + 1;
+  }
+  return result;
+}
+
+CoastalBand::CoastalBand(
+    const Eigen::Ref<const Eigen::VectorXd>& lon,
+    const Eigen::Ref<const Eigen::VectorXd>& lat,
+    const Eigen::Ref<const Eigen::Matrix<double, -1, 3>>& ecef,
+    const Eigen::Ref<const Vector<int32_t>>& boundary, const PackedRTree& rtree,
+    const size_t neighbors, const double max_distance, const double margin,
+    const double resolution)
+    : max_distance_(max_distance),
+      neighbors_(static_cast<int64_t>(
+          std::min(neighbors, size_t{PackedRTree::kMaxNeighbors}))) {
+  if (!(max_distance > 0)) {
+    throw std::invalid_argument("the extrapolation distance must be positive");
+  }
+  if (!(resolution >= 0) || resolution > 180) {
+    throw std::invalid_argument(
+        "the resolution must be in the range [0, 180] degrees");
+  }
+  if (neighbors == 0) {
+    throw std::invalid_argument("the number of neighbors must be positive");
+  }
+  if (boundary.size() == 0 || rtree.empty()) {
+    return;
+  }
+
+  // By default, a cell is as wide as the mean distance between a boundary
+  // vertex and its nearest vertex.
+  resolution_ = resolution;
+  if (resolution == 0) {
+    auto spacing = 0.0;
+    auto nearest = PackedRTree::Neighbors{};
+    for (Eigen::Index ix = 0; ix < boundary.size(); ++ix) {
+      rtree.nearest(ecef.row(boundary(ix)).transpose(), 2, nearest);
+      spacing += nearest.back().first;
+    }
+    spacing /= static_cast<double>(boundary.size());
+    resolution_ = std::min(std::max(spacing / kMaxDegreeLength, 1e-3), 1.0);
+  }
+
+  // Select the cells located within the extrapolation distance of the
+  // boundary, as spans of columns. Returns false if the band has more than
+  // kMaxCells cells.
+  auto spans = std::vector<Span>();
+  auto select = [&]() -> bool {
+    nx_ = static_cast<int64_t>(
+        std::ceil(detail::math::circle_degrees<double>() / resolution_));
+    const auto ny = static_cast<int64_t>(std::ceil(180 / resolution_));
+    const auto half_diagonal =
+        resolution_ * kMaxDegreeLength * std::sqrt(0.5);
+    const auto radius =
+        (max_distance + margin + half_diagonal) / kMinDegreeLength;
+    spans.clear();
+    for (Eigen::Index ix = 0; ix < boundary.size(); ++ix) {
+      const auto x = lon(boundary(ix));
+      const auto y = lat(boundary(ix));
+      const auto y0 = std::max(y - radius, -90.0);
+      const auto y1 = std::min(y + radius, 90.0);
+      const auto cos_lat = std::cos(detail::math::radians(
+          std::min(std::max(std::abs(y0), std::abs(y1)), 90.0)));
+      const auto width = cos_lat * 180 > radius ? radius / cos_lat : 180.0;
+      const auto first_row = cell(x, y0) / nx_;
+      const auto last_row = std::min(cell(x, y1) / nx_, ny - 1);
+      const auto first_column = cell(x - width, y) % nx_;
+      const auto columns =
+          width >= 180 ? nx_
+                       : std::min(nx_, detail::math::remainder(
+                                           cell(x + width, y) % nx_ -
+                                               first_column,
+                                           nx_) +
+                                           1);
+      if ((last_row - first_row + 1) * columns > kMaxCells) {
+        return false;
+      }
+      for (auto row = first_row; row <= last_row; ++row) {
+        const auto last_column = first_column + columns - 1;
+        spans.push_back({row, first_column, std::min(last_column, nx_ - 1)});
+        if (last_column >= nx_) {
+          spans.push_back({row, 0, last_column - nx_});
+        }
+      }
+      // The merged spans are disjoint: there are fewer spans than cells.
+      if (spans.size() >= static_cast<size_t>(2 * kMaxCells) &&
+          merge(spans) > kMaxCells) {
+        return false;
+      }
+    }
+    return merge(spans) <= kMaxCells;
+  };
+  while (!select()) {
+    if (resolution != 0) {
+      throw std::invalid_argument(
+          "the coastal band has too many cells, the resolution must be "
+          "increased");
+    }
+    resolution_ *= 2;
+  }
+
+  // Stencil of each cell: the vertices that may be among the nearest
+  // vertices of a point of the cell (plus one meter for the rounding errors).
+  const auto reach = 2 * resolution_ * kMaxDegreeLength * std::sqrt(0.5) + 1;
+  auto selected = std::vector<int64_t>();
+  auto offsets = std::vector<int64_t>{0};
+  auto vertices = std::vector<int32_t>();
+  auto points = std::vector<double>();
+  auto nearest = PackedRTree::Neighbors{};
+  auto stencil = std::vector<int32_t>();
+  for (const auto& span : spans) {
+    // Latitude of the center of the row, clipped to the pole.
+    const auto y0 = static_cast<double>(span.row) * resolution_ - 90;
+    const auto y = (y0 + std::min(y0 + resolution_, 90.0)) / 2;
+    for (auto column = span.first; column <= span.last; ++column) {
+      const auto center = static_cast<geometry::EarthCenteredEarthFixed>(
+          geometry::Point(
+              (static_cast<double>(column) + 0.5) * resolution_ - 180, y));
+      const auto point = Eigen::Vector3d(center.x(), center.y(), center.z());
+      rtree.nearest(point, static_cast<size_t>(neighbors_), nearest);
+      // If the tree has fewer vertices than the neighbors searched, all its
+      // vertices are the nearest.
+      const auto radius = nearest.size() < static_cast<size_t>(neighbors_)
+                              ? std::numeric_limits<double>::max()
+                              : nearest.back().first + reach;
+      stencil.clear();
+      rtree.query(Eigen::Vector3d((point.array() - radius).matrix()),
+                  Eigen::Vector3d((point.array() + radius).matrix()),
+                  [&](const int32_t vertex) {
+                    if ((ecef.row(vertex).transpose() - point).norm() <=
+                        radius) {
+                      stencil.push_back(vertex);
+                    }
+                  });
+      if (stencil.size() > static_cast<size_t>(kMaxVertices)) {
+        continue;
+      }
+      std::sort(stencil.begin(), stencil.end());
+      for (const auto vertex : stencil) {
+        vertices.push_back(vertex);
+        points.insert(points.end(), {ecef(vertex, 0), ecef(vertex, 1),
+                                     ecef(vertex, 2)});
+      }
+      selected.push_back(span.row * nx_ + column);
+      offsets.push_back(static_cast<int64_t>(vertices.size()));
+    }
+  }
+  cells_ = Vector<int64_t>(Eigen::Map<const Vector<int64_t>>(
+      selected.data(), static_cast<Eigen::Index>(selected.size())));
+  offsets_ = Vector<int64_t>(Eigen::Map<const Vector<int64_t>>(
+      offsets.data(), static_cast<Eigen::Index>(offsets.size())));
+  vertices_ = Vector<int32_t>(Eigen::Map<const Vector<int32_t>>(
+      vertices.data(), static_cast<Eigen::Index>(vertices.size())));
+  points_ = Eigen::Matrix<double, 3, -1>(
+      Eigen::Map<const Eigen::Matrix<double, 3, -1>>(
+          points.data(), 3, static_cast<Eigen::Index>(vertices.size())));
+}
+
+auto CoastalBand::cell(const double lon, const double lat) const noexcept
+    -> int64_t {
+  const auto ny = static_cast<int64_t>(std::ceil(180 / resolution_));
+  const auto x = static_cast<int64_t>(std::floor(
+      (detail::math::normalize_angle(lon, -180.0) + 180) / resolution_));
+  const auto y = static_cast<int64_t>(std::floor((lat + 90) / resolution_));
+  return std::min(std::max(y, int64_t(0)), ny - 1) * nx_ +
+         std::min(std::max(x, int64_t(0)), nx_ - 1);
+}
+
+auto CoastalBand::nearest(const double lon, const double lat,
+                          const Eigen::Vector3d& point, const size_t k,
+                          PackedRTree::Neighbors& neighbors) const -> bool {
+  neighbors.clear();
+  if (empty() || k == 0 || k > static_cast<size_t>(neighbors_) ||
+      !std::isfinite(lon) || !std::isfinite(lat)) {
+    return false;
+  }
+  const auto key = cell(lon, lat);
+  const auto* first = cells_.data();
+  const auto* last = cells_.data() + cells_.size();
+  const auto* it = std::lower_bound(first, last, key);
+  if (it == last || *it != key) {
+    return false;
+  }
+  const auto jx = std::distance(first, it);
+  for (auto ix = offsets_[jx]; ix < offsets_[jx + 1]; ++ix) {
+    PackedRTree::insert((points_.col(ix) - point).squaredNorm(), vertices_[ix],
+                        k, neighbors);
+  }
+  for (auto& item : neighbors) {
+    item.first = std::sqrt(item.first);
+  }
+  return true;
+}
+
+auto CoastalBand::getstate() const -> std::string {
+  auto ss = std::stringstream();
+  ss.exceptions(std::stringstream::failbit);
+  getstate(ss);
+  return ss.str();
+}
+
+auto CoastalBand::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_data(os, max_distance_);
+  detail::serialize::write_data(os, resolution_);
+  detail::serialize::write_data(os, nx_);
+  detail::serialize::write_data(os, neighbors_);
+  detail::serialize::write_matrix(os, cells_);
+  detail::serialize::write_matrix(os, offsets_);
+  detail::serialize::write_matrix(os, vertices_);
+  detail::serialize::write_matrix(os, points_);
+}
+
+auto CoastalBand::setstate(const string_view& data) -> CoastalBand {
+  detail::isviewstream ss(data);
+  ss.exceptions(std::stringstream::failbit);
+  return setstate(ss);
+}
+
+auto CoastalBand::setstate(std::istream& is) -> CoastalBand {
+  try {
+    auto result = CoastalBand();
+    result.max_distance_ = detail::serialize::read_data<double>(is);
+    result.resolution_ = detail::serialize::read_data<double>(is);
+    result.nx_ = detail::serialize::read_data<int64_t>(is);
+    result.neighbors_ = detail::serialize::read_data<int64_t>(is);
+    result.cells_ = detail::serialize::read_shared_matrix<int64_t, -1, 1>(is);
+    result.offsets_ =
+        detail::serialize::read_shared_matrix<int64_t, -1, 1>(is);
+    result.vertices_ =
+        detail::serialize::read_shared_matrix<int32_t, -1, 1>(is);
+    result.points_ = detail::serialize::read_shared_matrix<double, 3, -1>(is);
+    // The cells are sorted by their position in the global grid, and the
+    // vertices of their stencils are stored in a compressed sparse row
+    // layout. A band built without boundary has no arrays.
+    const auto& cells = result.cells_;
+    const auto* last_cell = cells.data() + cells.size();
+    const auto valid =
+        result.points_.cols() == result.vertices_.size() &&
+        (result.offsets_.size() == 0
+             ? result.empty() && result.vertices_.size() == 0
+             : result.resolution_ > 0 && result.nx_ > 0 &&
+                   result.neighbors_ > 0 &&
+                   result.neighbors_ <=
+                       static_cast<int64_t>(PackedRTree::kMaxNeighbors) &&
+                   std::adjacent_find(cells.data(), last_cell,
+                                      std::greater_equal<int64_t>()) ==
+                       last_cell &&
+                   detail::serialize::in_range(
+                       cells, 0,
+                       result.nx_ * static_cast<int64_t>(
+                                        std::ceil(180 / result.resolution_))) &&
+                   result.offsets_.size() == result.size() + 1 &&
+                   detail::serialize::is_offsets(result.offsets_,
+                                                 result.vertices_.size()));
+    if (!valid) {
+      throw std::invalid_argument("inconsistent band state");
+    }
+    return result;
+  } catch (const std::exception&) {
+    throw std::invalid_argument("invalid band state");
+  }
+}
+
+}  // namespace mesh
+}  // namespace fes
@@ -5,11 +5,14 @@
 #include "fes/mesh/index.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <exception>
+#include <iterator>
 #include <limits>
-#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -49,100 +52,328 @@ static auto sanity_check(
   }
 }
 
+/// Build the neighbors of the triangles from their shared edges.
+static auto build_neighbors(
+    const Eigen::Matrix<int32_t, Eigen::Dynamic, 3>& triangles)
+    -> Eigen::Matrix<int32_t, Eigen::Dynamic, 3> {
+  /// An edge of a triangle, opposite to one of its vertices.
+  struct Edge {
+    /// The smallest index of the edge vertices.
+    int32_t first;
+    /// The largest index of the edge vertices.
+    int32_t second;
+    /// The triangle index.
+    int32_t triangle;
+    /// The index (0, 1 or 2) of the vertex opposite to the edge.
+    int32_t vertex;
+  };
+  auto edges = std::vector<Edge>{};
+  edges.reserve(triangles.rows() * 3);
+  for (int32_t ix = 0; ix < triangles.rows(); ++ix) {
+    for (int32_t jx = 0; jx < 3; ++jx) {
+      const auto v1 = triangles(ix, (jx + 1) % 3);
+      const auto v2 = triangles(ix, (jx + 2) % 3);
+      edges.push_back({std::min(v1, v2), std::max(v1, v2), ix, jx});
+    }
+  }
+  std::sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) {
+    return std::tie(lhs.first, lhs.second, lhs.triangle) <
+           std::tie(rhs.first, rhs.second, rhs.triangle);
+  });
+
+  // Two consecutive edges joining the same vertices are shared by two
+  // triangles. Edges shared by more than two triangles (non-manifold mesh)
+  // are only connected in pairs.
+  auto result = Eigen::Matrix<int32_t, Eigen::Dynamic, 3>(triangles.rows(), 3);
+  result.setConstant(-1);
+  for (size_t ix = 1; ix < edges.size(); ++ix) {
+    const auto& lhs = edges[ix - 1];
+    const auto& rhs = edges[ix];
+    if (lhs.first == rhs.first && lhs.second == rhs.second &&
+        result(lhs.triangle, lhs.vertex) == -1) {
+      result(lhs.triangle, lhs.vertex) = rhs.triangle;
+      result(rhs.triangle, rhs.vertex) = lhs.triangle;
+    }
+  }
+  return result;
+}
+
 Index::Index(Eigen::VectorXd lon, Eigen::VectorXd lat,
-             Eigen::Matrix<int32_t, Eigen::Dynamic, 3> triangles)
-    : lon_(std::move(lon)),
-      lat_(std::move(lat)),
-      triangles_(std::move(triangles)) {
+             Eigen::Matrix<int32_t, Eigen::Dynamic, 3> triangles,
+             const IndexType type, const double resolution)
+    : type_(type) {
+  if (type != kRTree && type != kBucketGrid) {
+    throw std::invalid_argument("unknown index type");
+  }
   // Sanity checks on the input data
-  sanity_check(lon_, lat_, triangles_);
+  sanity_check(lon, lat, triangles);
 
   // Normalize the longitude to [-180, 180]
-  std::for_each(lon_.data(), lon_.data() + lon_.size(),
+  std::for_each(lon.data(), lon.data() + lon.size(),
                 [](double& lon) { lon = detail::math::normalize_angle(lon); });
 
-  // Allocate the values used to build the index.
-  auto values = std::vector<value_t>{};
-  values.reserve(triangles_.rows() * 3);
+  // ECEF coordinates of the vertices.
+  auto ecef = Eigen::Matrix<double, Eigen::Dynamic, 3>(lon.size(), 3);
+  for (Eigen::Index ix = 0; ix < lon.size(); ++ix) {
+    const auto point = static_cast<geometry::EarthCenteredEarthFixed>(
+        geometry::Point(lon(ix), lat(ix)));
+    ecef.row(ix) << point.x(), point.y(), point.z();
+  }
 
-  for (auto ix = 0; ix < triangles_.rows(); ++ix) {
-    // Get the triangle vertices
-    const Eigen::Vector3i& index = triangles_.row(ix);
+  // Triangles incident to each vertex, stored in a compressed sparse row
+  // layout.
+  auto vertex_offsets = Vector<int64_t>::Zero(lon.size() + 1).eval();
+  for (Eigen::Index ix = 0; ix < triangles.size(); ++ix) {
+    ++vertex_offsets[triangles.data()[ix] + 1];
+  }
+  for (Eigen::Index ix = 0; ix < lon.size(); ++ix) {
+    vertex_offsets[ix + 1] += vertex_offsets[ix];
+  }
+  auto vertex_triangles = Vector<int32_t>(triangles.size());
+  auto position = Vector<int64_t>(vertex_offsets.head(lon.size()));
+  for (int32_t ix = 0; ix < triangles.rows(); ++ix) {
+    for (auto jx = 0; jx < 3; ++jx) {
+      vertex_triangles[position[triangles(ix, jx)]++] = ix;
+    }
+    // Update the length of the longest edge of the mesh.
+    for (auto jx = 0; jx < 3; ++jx) {
+      const auto length = (ecef.row(triangles(ix, jx)) -
+                           ecef.row(triangles(ix, (jx + 1) % 3)))
+                              .norm();
+      max_edge_length_ = std::max(max_edge_length_, length);
+    }
+  }
 
-    // For each edge of the triangle, add the ECEF coordinates and the triangle
-    // index to the values vector.
-    for (uint8_t jx = 0; jx < 3; ++jx) {
-      auto kx = index(jx);
-      values.emplace_back(static_cast<geometry::EarthCenteredEarthFixed>(
-                              geometry::Point(lon_(kx), lat_(kx))),
-                          std::make_pair(jx, ix));
+  // The R-Tree stores each vertex used by the triangles once.
+  auto points = Eigen::Matrix<double, 3, -1>(3, lon.size());
+  auto ids = Vector<int32_t>(lon.size());
+  auto size = Eigen::Index(0);
+  for (int32_t ix = 0; ix < lon.size(); ++ix) {
+    if (vertex_offsets[ix + 1] != vertex_offsets[ix]) {
+      points.col(size) = ecef.row(ix).transpose();
+      ids[size++] = ix;
     }
   }
-  rtree_ = rtree_t{values.begin(), values.end()};
+  rtree_ = PackedRTree(points.leftCols(size), ids.head(size));
+  neighbors_ = build_neighbors(triangles);
+
+  // The arrays are shared by the copies of the index.
+  lon_ = std::move(lon);
+  lat_ = std::move(lat);
+  triangles_ = std::move(triangles);
+  ecef_ = std::move(ecef);
+  vertex_offsets_ = std::move(vertex_offsets);
+  vertex_triangles_ = std::move(vertex_triangles);
+  if (type_ == kBucketGrid) {
+    bucket_grid_ = BucketGrid(lon_, lat_, triangles_, resolution);
+  }
+}
+
+auto Index::nearest(const geometry::EarthCenteredEarthFixed& cartesian_point,
+                    const size_t max_neighbors,
+                    TriangleIndices& triangle_indices) const -> double {
+  auto neighbors = PackedRTree::Neighbors{};
+  rtree_.nearest(Eigen::Vector3d(cartesian_point.x(), cartesian_point.y(),
+                                 cartesian_point.z()),
+                 max_neighbors, neighbors);
+  incident_triangles(neighbors, triangle_indices);
+  return neighbors.empty() ? std::numeric_limits<double>::max()
+                           : neighbors.front().first;
+}
+
+auto Index::incident_triangles(const PackedRTree::Neighbors& neighbors,
+                               TriangleIndices& triangle_indices) const
+    -> void {
+  // Each triangle is kept once, the list being compacted when it is full.
+  auto compact = [&triangle_indices]() -> void {
+    std::sort(triangle_indices.begin(), triangle_indices.end());
+    triangle_indices.erase(
+        std::unique(triangle_indices.begin(), triangle_indices.end()),
+        triangle_indices.end());
+  };
+  triangle_indices.clear();
+  for (const auto& item : neighbors) {
+    auto range = incident_triangles(item.second);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (triangle_indices.size() == triangle_indices.capacity()) {
+        compact();
+        if (triangle_indices.size() == triangle_indices.capacity()) {
+          break;
+        }
+      }
+      triangle_indices.push_back(*it);
+    }
+  }
+  // Same order as a set: each triangle is visited once, by ascending index.
+  compact();
 }
 
 auto Index::search(const geometry::Point& point,
                    const double max_distance) const -> TriangleQueryResult {
-  constexpr size_t kMaxNeighbors = 11;
-  constexpr size_t kExtrapolationNeighbors = 16;
-  auto min_distance = 0.0;
-  auto triangle_indices = std::set<int>();
+  auto result = TriangleQueryResult{};
+  search(point, max_distance, result);
+  return result;
+}
+
+auto Index::search(const geometry::Point& point, const double max_distance,
+                   TriangleQueryResult& result) const -> void {
+  // Number of vertices whose incident triangles are tested.
+  constexpr size_t kMaxNeighbors = 3;
+  auto triangle_indices = TriangleIndices{};
+  result.reset(point);
+
+  // Check the triangles listed in the bucket containing the point.
+  if (type_ == kBucketGrid) {
+    auto range = bucket_grid_.candidates(point.lon(), point.lat());
+    for (auto it = range.first; it != range.second; ++it) {
+      result.triangle = build_static_triangle(*it);
+      if (result.triangle.covered_by(point)) {
+        result.index = *it;
+        return;
+      }
+    }
+  }
 
   // Query position in ECEF coordinates
   auto cartesian_point = static_cast<geometry::EarthCenteredEarthFixed>(point);
 
   // Find the nearest triangles
-  std::tie(triangle_indices, min_distance) =
-      nearest(cartesian_point, kMaxNeighbors);
+  auto min_distance = nearest(cartesian_point, kMaxNeighbors, triangle_indices);
 
   // Check for each selected triangle if the point is inside.
   for (auto& ix : triangle_indices) {
-    auto triangle = build_triangle(ix);
-    if (triangle.covered_by(point)) {
-      return {ix, point, std::move(triangle)};
+    result.triangle = build_static_triangle(ix);
+    if (result.triangle.covered_by(point)) {
+      result.index = ix;
+      return;
     }
   }
 
   if (min_distance >= max_distance) {
-    // No triangle found within the max distance, return an empty result.
-    return TriangleQueryResult{};
+    // No triangle found within the max distance, the result is empty.
+    return;
   }
 
   // The point is not inside any triangle, so search for the nearest triangle
-  // vertices to the query point.
-  //
-  // Scale the number of neighbors based on the minimum distance to the mesh.
-  // For points far from the mesh (min_distance > 10km), use more neighbors
-  // to improve extrapolation quality. The neighbor count increases linearly
-  // with distance, capped between kExtrapolationNeighbors and 128.
-  auto num_neighbors =
-      std::max(static_cast<size_t>(128),
-               std::min(kExtrapolationNeighbors,
-                        kExtrapolationNeighbors *
-                            static_cast<size_t>(min_distance / 10'000)));
-
-  std::tie(triangle_indices, min_distance) =
-      nearest(cartesian_point, num_neighbors);
-  auto nearest_vertices = std::vector<VertexAttribute>{};
-  nearest_vertices.reserve(3 * triangle_indices.size());
-
+  // vertices to the query point. The stencil of the coastal band containing
+  // the point, if any, gives the same vertices as the R-Tree.
+  const auto query = Eigen::Vector3d(cartesian_point.x(), cartesian_point.y(),
+                                     cartesian_point.z());
+  auto neighbors = PackedRTree::Neighbors{};
+  if (!coastal_band_.nearest(point.lon(), point.lat(), query,
+                             kExtrapolationNeighbors, neighbors)) {
+    rtree_.nearest(query, kExtrapolationNeighbors, neighbors);
+  }
+  incident_triangles(neighbors, triangle_indices);
   for (auto& ix : triangle_indices) {
-    filter_nearby_vertices(cartesian_point, ix, max_distance, nearest_vertices);
+    filter_nearby_vertices(cartesian_point, ix, max_distance,
+                           result.nearest_vertices);
   }
+  // If no vertices are found within the max distance, the result is empty.
+}
 
-  if (nearest_vertices.empty()) {
-    // No vertices found within the max distance, return an empty result.
-    return TriangleQueryResult{};
+auto Index::walk(const geometry::Point& point, const int32_t start,
+                 TriangleQueryResult& result) const -> bool {
+  auto current = start;
+  for (auto step = 0; step < kMaxWalkSteps; ++step) {
+    if (current < 0 || current >= triangles_.rows()) {
+      // The walk has left the mesh.
+      return false;
+    }
+    auto triangle = build_static_triangle(current);
+    if (triangle.covered_by(point)) {
+      result.reset(point);
+      result.index = current;
+      result.triangle = triangle;
+      return true;
+    }
+
+    // Barycentric coordinates of the point in the triangle.
+    double xi;
+    double eta;
+    std::tie(xi, eta) = triangle.reference_right_angled(point);
+    const double lambda[3] = {1 - xi - eta, xi, eta};
+    const auto vertex = static_cast<int>(
+        std::distance(lambda, std::min_element(lambda, lambda + 3)));
+    if (!(lambda[vertex] < 0)) {
+      // The point lies in the planar triangle, but outside the geodetic one:
+      // the walk cannot decide where to go.
+      return false;
+    }
+    current = neighbors_(current, vertex);
   }
-  return TriangleQueryResult{std::move(nearest_vertices), point};
+  return false;
+}
+
+/// Box in ECEF coordinates.
+using ecef_box_t =
+    boost::geometry::model::box<geometry::EarthCenteredEarthFixed>;
+
+/// Get the bounding box, in ECEF coordinates, of a geographic box.
+static auto ecef_envelope(const geometry::Box& bbox) -> ecef_box_t {
+  const auto lon0 = bbox.min_corner().lon();
+  auto lon1 = bbox.max_corner().lon();
+  if (lon1 < lon0) {
+    lon1 += detail::math::circle_degrees<double>();
+  }
+  const auto lat0 = bbox.min_corner().lat();
+  const auto lat1 = bbox.max_corner().lat();
+
+  // The coordinates x and y are the product of a function of the latitude,
+  // maximal at the equator, and of the cosine or sine of the longitude,
+  // extremal at the multiples of 90 degrees; z only depends on the latitude.
+  // Their extrema over the box are therefore reached at the combinations of
+  // these particular longitudes and latitudes.
+  auto lons = boost::container::static_vector<double, 7>{lon0, lon1};
+  for (auto lon = std::ceil(lon0 / 90) * 90; lon < lon1; lon += 90) {
+    lons.push_back(lon);
+  }
+  auto lats = boost::container::static_vector<double, 3>{lat0, lat1};
+  if (lat0 < 0 && lat1 > 0) {
+    lats.push_back(0);
+  }
+
+  auto result = ecef_box_t{};
+  boost::geometry::assign_inverse(result);
+  for (const auto lon : lons) {
+    for (const auto lat : lats) {
+      boost::geometry::expand(
+          result, static_cast<geometry::EarthCenteredEarthFixed>(
+                      geometry::Point(lon, lat)));
+    }
+  }
+  return result;
 }
 
 auto Index::selected_triangles(const geometry::Box& bbox) const
     -> std::vector<int64_t> {
-  auto result = std::vector<int64_t>{};
-  result.reserve(triangles_.rows());
+  // A triangle intersecting the box has a vertex whose distance to the box is
+  // at most the length of the longest edge of the mesh: the candidates are
+  // the triangles of the vertices located in the ECEF envelope of the box,
+  // inflated by this length (plus one meter for the rounding errors).
+  const auto envelope = ecef_envelope(bbox);
+  const auto margin = max_edge_length_ + 1;
+  const auto& lower = envelope.min_corner();
+  const auto& upper = envelope.max_corner();
 
-  for (int64_t ix = 0; ix < triangles_.rows(); ++ix) {
+  auto candidates = std::vector<int64_t>{};
+  rtree_.query(
+      Eigen::Vector3d(lower.x() - margin, lower.y() - margin,
+                      lower.z() - margin),
+      Eigen::Vector3d(upper.x() + margin, upper.y() + margin,
+                      upper.z() + margin),
+      [&](const int32_t vertex) -> void {
+        auto range = incident_triangles(vertex);
+        candidates.insert(candidates.end(), range.first, range.second);
+      });
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+
+  // Exact test on the candidates.
+  auto result = std::vector<int64_t>{};
+  result.reserve(candidates.size());
+  for (const auto ix : candidates) {
     if (bbox.intersects(build_triangle(static_cast<int>(ix)))) {
       result.push_back(ix);
     }
@@ -155,24 +386,138 @@ auto Index::selected_triangles(const geometry::Box& bbox) const
   return result;
 }
 
+auto Index::build_reference_transforms() -> void {
+  auto transforms = Eigen::Matrix<double, 6, -1>(6, triangles_.rows());
+  for (Eigen::Index ix = 0; ix < triangles_.rows(); ++ix) {
+    const auto v1 = triangles_(ix, 0);
+    const auto v2 = triangles_(ix, 1);
+    const auto v3 = triangles_(ix, 2);
+    // The longitudes are unwrapped from the first vertex.
+    const auto t1 = lon_(v1);
+    const auto t2 = detail::math::normalize_angle(lon_(v2), t1 - 180.0);
+    const auto t3 = detail::math::normalize_angle(lon_(v3), t2 - 180.0);
+    const auto ctx = t2 - t1;
+    const auto cty = t3 - t1;
+    const auto cpx = lat_(v2) - lat_(v1);
+    const auto cpy = lat_(v3) - lat_(v1);
+    const auto jacobian = ctx * cpy - cty * cpx;
+    auto transform = transforms.col(ix);
+    if (detail::math::is_almost_zero(jacobian)) {
+      transform << t1, lat_(v1),
+          Eigen::Vector4d::Constant(std::numeric_limits<double>::quiet_NaN());
+      continue;
+    }
+    const auto inverse = 1.0 / jacobian;
+    transform << t1, lat_(v1), cpy * inverse, -cty * inverse, -cpx * inverse,
+        ctx * inverse;
+  }
+  transforms_ = std::move(transforms);
+}
+
+auto Index::build_coastal_band(const double max_distance,
+                               const double resolution) -> void {
+  // The vertices located on the boundary of the mesh are those of the edges
+  // shared by a single triangle.
+  auto is_boundary = std::vector<bool>(static_cast<size_t>(lon_.size()));
+  for (Eigen::Index ix = 0; ix < triangles_.rows(); ++ix) {
+    for (auto jx = 0; jx < 3; ++jx) {
+      if (neighbors_(ix, jx) == -1) {
+        is_boundary[triangles_(ix, (jx + 1) % 3)] = true;
+        is_boundary[triangles_(ix, (jx + 2) % 3)] = true;
+      }
+    }
+  }
+  auto boundary = std::vector<int32_t>();
+  for (int32_t ix = 0; ix < lon_.size(); ++ix) {
+    if (is_boundary[ix]) {
+      boundary.push_back(ix);
+    }
+  }
+  coastal_band_ = CoastalBand(
+      lon_, lat_, ecef_,
+      Eigen::Map<const Vector<int32_t>>(
+          boundary.data(), static_cast<Eigen::Index>(boundary.size())),
+      rtree_, kExtrapolationNeighbors, max_distance, max_edge_length_ / 2,
+      resolution);
+}
+
 auto Index::getstate() const -> std::string {
   auto ss = std::stringstream();
   ss.exceptions(std::stringstream::failbit);
-  detail::serialize::write_matrix(ss, lon_);
-  detail::serialize::write_matrix(ss, lat_);
-  detail::serialize::write_matrix(ss, triangles_);
+  getstate(ss);
   return ss.str();
 }
 
+auto Index::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_matrix(os, lon_);
+  detail::serialize::write_matrix(os, lat_);
+  detail::serialize::write_matrix(os, triangles_);
+  detail::serialize::write_data(os, type_);
+  detail::serialize::write_matrix(os, neighbors_);
+  detail::serialize::write_matrix(os, ecef_);
+  detail::serialize::write_matrix(os, vertex_offsets_);
+  detail::serialize::write_matrix(os, vertex_triangles_);
+  detail::serialize::write_data(os, max_edge_length_);
+  detail::serialize::write_matrix(os, transforms_);
+  detail::serialize::write_object(os, rtree_);
+  detail::serialize::write_object(os, bucket_grid_);
+  detail::serialize::write_object(os, coastal_band_);
+}
+
 auto Index::setstate(const string_view& data) -> Index {
   detail::isviewstream ss(data);
-  ss.exceptions(std::stringstream::failbit);
+  return setstate(ss);
+}
+
+auto Index::setstate(std::istream& is) -> Index {
   try {
-    auto lon = detail::serialize::read_matrix<double, Eigen::Dynamic, 1>(ss);
-    auto lat = detail::serialize::read_matrix<double, Eigen::Dynamic, 1>(ss);
-    auto triangles =
-        detail::serialize::read_matrix<int32_t, Eigen::Dynamic, 3>(ss);
-    return Index(std::move(lon), std::move(lat), std::move(triangles));
+    // The search structures are restored as is, without being rebuilt.
+    auto result = Index();
+    result.lon_ =
+        detail::serialize::read_shared_matrix<double, Eigen::Dynamic, 1>(is);
+    result.lat_ =
+        detail::serialize::read_shared_matrix<double, Eigen::Dynamic, 1>(is);
+    result.triangles_ =
+        detail::serialize::read_shared_matrix<int32_t, Eigen::Dynamic, 3>(is);
+    result.type_ = detail::serialize::read_data<IndexType>(is);
+    result.neighbors_ =
+        detail::serialize::read_shared_matrix<int32_t, Eigen::Dynamic, 3>(is);
+    result.ecef_ =
+        detail::serialize::read_shared_matrix<double, Eigen::Dynamic, 3>(is);
+    result.vertex_offsets_ =
+        detail::serialize::read_shared_matrix<int64_t, Eigen::Dynamic, 1>(is);
+    result.vertex_triangles_ =
+        detail::serialize::read_shared_matrix<int32_t, Eigen::Dynamic, 1>(is);
+    result.max_edge_length_ = detail::serialize::read_data<double>(is);
+    result.transforms_ =
+        detail::serialize::read_shared_matrix<double, 6, -1>(is);
+    result.rtree_ = detail::serialize::read_object<PackedRTree>(is);
+    result.bucket_grid_ = detail::serialize::read_object<BucketGrid>(is);
+    result.coastal_band_ = detail::serialize::read_object<CoastalBand>(is);
+    const auto vertices = result.lon_.size();
+    const auto triangles = result.triangles_.rows();
+    if (result.lat_.size() != vertices || result.ecef_.rows() != vertices ||
+        result.vertex_offsets_.size() != vertices + 1 ||
+        result.neighbors_.rows() != triangles ||
+        result.vertex_triangles_.size() != 3 * triangles ||
+        (result.has_reference_transforms() &&
+         result.transforms_.cols() != triangles)) {
+      throw std::invalid_argument("inconsistent index state");
+    }
+    // The indices stored in the arrays must refer to existing vertices and
+    // triangles, as they are used without bounds checking.
+    using detail::serialize::in_range;
+    if (!in_range(result.triangles_, 0, vertices) ||
+        !in_range(result.neighbors_, -1, triangles) ||
+        !detail::serialize::is_offsets(result.vertex_offsets_,
+                                       result.vertex_triangles_.size()) ||
+        !in_range(result.vertex_triangles_, 0, triangles) ||
+        !in_range(result.rtree_.ids(), 0, vertices) ||
+        !in_range(result.bucket_grid_.triangles(), 0, triangles) ||
+        !in_range(result.coastal_band_.vertices(), 0, vertices)) {
+      throw std::invalid_argument("invalid indices in index state");
+    }
+    return result;
   } catch (const std::exception&) {
     throw std::invalid_argument("invalid index state");
   }
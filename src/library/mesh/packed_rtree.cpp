@@ -0,0 +1,207 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/packed_rtree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "fes/detail/isviewstream.hpp"
+#include "fes/detail/serialize.hpp"
+
+namespace fes {
+namespace mesh {
+
+/// Get the number of slices of a dimension used by the Sort-Tile-Recursive
+/// algorithm to distribute the given number of leaves.
+static auto slices(const int64_t leaves) -> int64_t {
+  auto result =
+      static_cast<int64_t>(std::ceil(std::cbrt(static_cast<double>(leaves))));
+  return std::max(result, int64_t(1));
+}
+
+/// Get the position of the first node of each level of a tree storing the
+/// given number of points, from the leaves to the root (number of levels + 1
+/// items).
+static auto first_nodes(const int64_t points) -> Vector<int64_t> {
+  if (points == 0) {
+    return Vector<int64_t>::Zero(1);
+  }
+  // Number of nodes of each level, from the leaves to the root.
+  auto counts = std::vector<int64_t>{(points + PackedRTree::kNodeSize - 1) /
+                                     PackedRTree::kNodeSize};
+  while (counts.back() > 1) {
+    counts.push_back((counts.back() + PackedRTree::kNodeSize - 1) /
+                     PackedRTree::kNodeSize);
+  }
+  auto result = Vector<int64_t>(static_cast<Eigen::Index>(counts.size() + 1));
+  result[0] = 0;
+  for (size_t ix = 0; ix < counts.size(); ++ix) {
+    result[ix + 1] = result[ix] + counts[ix];
+  }
+  return result;
+}
+
+PackedRTree::PackedRTree(
+    const Eigen::Ref<const Eigen::Matrix<double, 3, -1>>& points,
+    const Eigen::Ref<const Vector<int32_t>>& ids) {
+  if (points.cols() != ids.size()) {
+    throw std::invalid_argument(
+        "points and ids must have the same number of items");
+  }
+  const auto n = ids.size();
+  levels_ = first_nodes(0);
+  if (n == 0) {
+    return;
+  }
+
+  // Sort-Tile-Recursive ordering: the points are sorted by x and cut into
+  // slabs, each slab is sorted by y and cut into columns, and each column is
+  // sorted by z and cut into leaves.
+  auto order = std::vector<int64_t>(static_cast<size_t>(n));
+  std::iota(order.begin(), order.end(), int64_t(0));
+  const auto s = slices((n + kNodeSize - 1) / kNodeSize);
+  auto sort_by = [&](const int64_t dim, const int64_t step) {
+    for (auto first = int64_t(0); first < n; first += step) {
+      const auto last = std::min(first + step, n);
+      std::sort(order.begin() + first, order.begin() + last,
+                [&](const int64_t lhs, const int64_t rhs) {
+                  return points(dim, lhs) < points(dim, rhs);
+                });
+    }
+  };
+  sort_by(0, n);
+  sort_by(1, kNodeSize * s * s);
+  sort_by(2, kNodeSize * s);
+
+  auto sorted_points = Eigen::Matrix<double, 3, -1>(3, n);
+  auto sorted_ids = Vector<int32_t>(n);
+  for (auto ix = int64_t(0); ix < n; ++ix) {
+    sorted_points.col(ix) = points.col(order[ix]);
+    sorted_ids[ix] = ids[order[ix]];
+  }
+  points_ = std::move(sorted_points);
+  ids_ = std::move(sorted_ids);
+
+  levels_ = first_nodes(n);
+
+  // Bounding boxes of the leaves, then of the upper levels.
+  auto boxes = Eigen::Matrix<double, 6, -1>(6, levels_[levels_.size() - 1]);
+  for (auto level = int64_t(0); level < levels(); ++level) {
+    for (auto node = int64_t(0); node < levels_[level + 1] - levels_[level];
+         ++node) {
+      auto box = boxes.col(levels_[level] + node);
+      box.head<3>().setConstant(std::numeric_limits<double>::max());
+      box.tail<3>().setConstant(std::numeric_limits<double>::lowest());
+      const auto first = node * kNodeSize;
+      const auto last = std::min(first + kNodeSize, children(level));
+      for (auto ix = first; ix < last; ++ix) {
+        if (level == 0) {
+          box.head<3>() = box.head<3>().cwiseMin(points_.col(ix));
+          box.tail<3>() = box.tail<3>().cwiseMax(points_.col(ix));
+        } else {
+          const auto child = boxes.col(levels_[level - 1] + ix);
+          box.head<3>() = box.head<3>().cwiseMin(child.head<3>());
+          box.tail<3>() = box.tail<3>().cwiseMax(child.tail<3>());
+        }
+      }
+    }
+  }
+  boxes_ = std::move(boxes);
+}
+
+auto PackedRTree::nearest(const Eigen::Vector3d& point, const size_t k,
+                          Neighbors& neighbors) const -> void {
+  neighbors.clear();
+  if (empty() || k == 0) {
+    return;
+  }
+  nearest(levels() - 1, 0, point, std::min(k, size_t{kMaxNeighbors}),
+          neighbors);
+  for (auto& item : neighbors) {
+    item.first = std::sqrt(item.first);
+  }
+}
+
+auto PackedRTree::nearest(const int64_t level, const int64_t node,
+                          const Eigen::Vector3d& point, const size_t k,
+                          Neighbors& neighbors) const -> void {
+  const auto first = node * kNodeSize;
+  const auto last = std::min(first + kNodeSize, children(level));
+
+  if (level == 0) {
+    // Insert the points of the leaf in the sorted list of the neighbors.
+    for (auto ix = first; ix < last; ++ix) {
+      insert((points_.col(ix) - point).squaredNorm(), ids_[ix], k, neighbors);
+    }
+    return;
+  }
+
+  // Visit the children by increasing distance, skipping those farther than
+  // the k-th neighbor found so far.
+  auto candidates = std::array<std::pair<double, int64_t>, kNodeSize>{};
+  auto size = size_t(0);
+  for (auto ix = first; ix < last; ++ix) {
+    candidates[size++] = std::make_pair(distance2(level - 1, ix, point), ix);
+  }
+  std::sort(candidates.begin(), candidates.begin() + size);
+  for (size_t ix = 0; ix < size; ++ix) {
+    if (neighbors.size() == k &&
+        candidates[ix].first >= neighbors.back().first) {
+      break;
+    }
+    nearest(level - 1, candidates[ix].second, point, k, neighbors);
+  }
+}
+
+auto PackedRTree::getstate() const -> std::string {
+  auto ss = std::stringstream();
+  ss.exceptions(std::stringstream::failbit);
+  getstate(ss);
+  return ss.str();
+}
+
+auto PackedRTree::getstate(std::ostream& os) const -> void {
+  detail::serialize::write_matrix(os, points_);
+  detail::serialize::write_matrix(os, ids_);
+  detail::serialize::write_matrix(os, boxes_);
+  detail::serialize::write_matrix(os, levels_);
+}
+
+auto PackedRTree::setstate(const string_view& data) -> PackedRTree {
+  detail::isviewstream ss(data);
+  ss.exceptions(std::stringstream::failbit);
+  return setstate(ss);
+}
+
+auto PackedRTree::setstate(std::istream& is) -> PackedRTree {
+  try {
+    auto result = PackedRTree();
+    result.points_ = detail::serialize::read_shared_matrix<double, 3, -1>(is);
+    result.ids_ = detail::serialize::read_shared_matrix<int32_t, -1, 1>(is);
+    result.boxes_ = detail::serialize::read_shared_matrix<double, 6, -1>(is);
+    result.levels_ = detail::serialize::read_shared_matrix<int64_t, -1, 1>(is);
+    // The layout of the levels only depends on the number of points.
+    const auto levels = first_nodes(result.ids_.size());
+    if (result.points_.cols() != result.ids_.size() ||
+        result.levels_.size() != levels.size() ||
+        result.levels_ != levels ||
+        levels[levels.size() - 1] != result.boxes_.cols()) {
+      throw std::invalid_argument("inconsistent tree state");
+    }
+    return result;
+  } catch (const std::exception&) {
+    throw std::invalid_argument("invalid tree state");
+  }
+}
+
+}  // namespace mesh
+}  // namespace fes
@@ -0,0 +1,91 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/renumbering.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fes/detail/math.hpp"
+
+namespace fes {
+namespace mesh {
+
+auto hilbert_index(const double lon, const double lat) noexcept -> uint64_t {
+  constexpr auto kSide = uint64_t(1) << kHilbertBits;
+  auto quantize = [](const double value) -> uint64_t {
+    const auto cell = static_cast<int64_t>(std::floor(value * kSide));
+    return static_cast<uint64_t>(
+        std::min(std::max(cell, int64_t(0)), static_cast<int64_t>(kSide - 1)));
+  };
+  auto x = quantize((detail::math::normalize_angle(lon, -180.0) + 180) / 360);
+  auto y = quantize((lat + 90) / 180);
+
+  // Conversion of the cell (x, y) to its distance along the curve.
+  auto result = uint64_t(0);
+  for (auto s = kSide / 2; s > 0; s /= 2) {
+    const auto rx = static_cast<uint64_t>((x & s) != 0);
+    const auto ry = static_cast<uint64_t>((y & s) != 0);
+    result += s * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant so that the curve is continuous.
+    if (ry == 0) {
+      if (rx == 1) {
+        x = kSide - 1 - x;
+        y = kSide - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return result;
+}
+
+auto hilbert_order(const Eigen::VectorXd& lon, const Eigen::VectorXd& lat,
+                   const Eigen::Matrix<int32_t, -1, 3>& triangles)
+    -> Vector<int64_t> {
+  if (lon.size() != lat.size()) {
+    throw std::invalid_argument("lon and lat must have the same size");
+  }
+  const auto n = triangles.rows();
+  auto keys = std::vector<uint64_t>(static_cast<size_t>(n));
+  for (Eigen::Index ix = 0; ix < n; ++ix) {
+    // The longitudes are expressed relative to the first vertex to handle the
+    // triangles crossing the antimeridian.
+    const auto x0 = lon(triangles(ix, 0));
+    auto x = 0.0;
+    auto y = 0.0;
+    for (auto jx = 0; jx < 3; ++jx) {
+      const auto vertex = triangles(ix, jx);
+      if (vertex < 0 || vertex >= lon.size()) {
+        throw std::invalid_argument("vertex index out of range: " +
+                                    std::to_string(vertex));
+      }
+      x += detail::math::normalize_angle(lon(vertex), x0 - 180.0);
+      y += lat(vertex);
+    }
+    keys[ix] = hilbert_index(x / 3, y / 3);
+  }
+  auto result = Vector<int64_t>(n);
+  std::iota(result.data(), result.data() + n, int64_t(0));
+  std::stable_sort(result.data(), result.data() + n,
+                   [&keys](const int64_t lhs, const int64_t rhs) {
+                     return keys[lhs] < keys[rhs];
+                   });
+  return result;
+}
+
+auto inverse_order(const Vector<int64_t>& order) -> Vector<int64_t> {
+  auto result = Vector<int64_t>(order.size());
+  for (Eigen::Index ix = 0; ix < order.size(); ++ix) {
+    result[order[ix]] = ix;
+  }
+  return result;
+}
+
+}  // namespace mesh
+}  // namespace fes
@@ -0,0 +1,629 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/netcdf/loader.hpp"
+
+#include <netcdf.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fes/axis.hpp"
+#include "fes/detail/math.hpp"
+#include "fes/detail/thread.hpp"
+#include "fes/mesh/renumbering.hpp"
+
+namespace fes {
+namespace netcdf {
+
+/// Number of values of a variable read at once.
+constexpr size_t kChunkSize = size_t(1) << 20;
+
+/// Range of indices read along a dimension: first index and number of
+/// indices.
+using Range = std::pair<size_t, size_t>;
+
+/// The NetCDF library is not thread-safe: all the calls to the library are
+/// serialized, the values read being decoded concurrently.
+static auto library_mutex() -> std::mutex& {
+  static std::mutex mutex;
+  return mutex;
+}
+
+/// Throw an exception if a call to the NetCDF library failed.
+static auto check(const int status, const std::string& path) -> void {
+  if (status != NC_NOERR) {
+    throw std::runtime_error(path + ": " + nc_strerror(status));
+  }
+}
+
+/// Decoding of the values of a variable, following the CF conventions.
+struct Decoder {
+  /// Value of the missing data.
+  double fill_value{std::numeric_limits<double>::quiet_NaN()};
+  /// Alternative value of the missing data.
+  double missing_value{std::numeric_limits<double>::quiet_NaN()};
+  /// Scale factor applied to the values.
+  double scale_factor{1};
+  /// Offset added to the values.
+  double add_offset{0};
+  /// Whether the values are angles expressed in degrees.
+  bool degrees{false};
+
+  /// Decode a value.
+  template <typename T>
+  inline auto operator()(const double value) const noexcept -> T {
+    if (value == fill_value || value == missing_value) {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    auto result = static_cast<T>(value);
+    if (scale_factor != 1 || add_offset != 0) {
+      result = result * static_cast<T>(scale_factor) +
+               static_cast<T>(add_offset);
+    }
+    return degrees ? detail::math::radians<T>(result) : result;
+  }
+};
+
+/// Build the complex value of a wave from its amplitude and phase.
+template <typename T>
+inline auto wave_value(const T amplitude, const T phase) noexcept
+    -> std::complex<T> {
+  return {amplitude * std::cos(phase), amplitude * std::sin(phase)};
+}
+
+/// NetCDF dataset opened for reading.
+class Dataset {
+ public:
+  /// Open a dataset.
+  explicit Dataset(std::string path) : path_(std::move(path)) {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    check(nc_open(path_.c_str(), NC_NOWRITE, &ncid_), path_);
+  }
+
+  /// Close the dataset.
+  ~Dataset() {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    nc_close(ncid_);
+  }
+
+  Dataset(const Dataset&) = delete;
+  auto operator=(const Dataset&) -> Dataset& = delete;
+
+  /// Get the path to the dataset.
+  inline auto path() const noexcept -> const std::string& { return path_; }
+
+  /// Get the identifier of a variable.
+  auto variable(const std::string& name) const -> int {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    auto varid = 0;
+    auto status = nc_inq_varid(ncid_, name.c_str(), &varid);
+    if (status == NC_ENOTVAR) {
+      throw std::invalid_argument("variable not found: '" + name + "' in " +
+                                  path_);
+    }
+    check(status, path_);
+    return varid;
+  }
+
+  /// Get the type of a variable.
+  auto type(const int varid) const -> nc_type {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    auto result = nc_type{};
+    check(nc_inq_vartype(ncid_, varid, &result), path_);
+    return result;
+  }
+
+  /// Get the shape of a variable.
+  auto shape(const int varid) const -> std::vector<size_t> {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    auto ndims = 0;
+    check(nc_inq_varndims(ncid_, varid, &ndims), path_);
+    auto dimids = std::vector<int>(static_cast<size_t>(ndims));
+    check(nc_inq_vardimid(ncid_, varid, dimids.data()), path_);
+    auto result = std::vector<size_t>(dimids.size());
+    for (size_t ix = 0; ix < dimids.size(); ++ix) {
+      check(nc_inq_dimlen(ncid_, dimids[ix], &result[ix]), path_);
+    }
+    return result;
+  }
+
+  /// Get the decoder of the values of a variable.
+  auto decoder(const int varid) const -> Decoder {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    auto result = Decoder{};
+    auto type = nc_type{};
+    check(nc_inq_vartype(ncid_, varid, &type), path_);
+    if (!numeric_attribute(varid, "_FillValue", result.fill_value)) {
+      result.fill_value = default_fill_value(type);
+    }
+    numeric_attribute(varid, "missing_value", result.missing_value);
+    numeric_attribute(varid, "scale_factor", result.scale_factor);
+    numeric_attribute(varid, "add_offset", result.add_offset);
+    auto units = text_attribute(varid, "units");
+    std::transform(units.begin(), units.end(), units.begin(),
+                   [](const char item) {
+                     return static_cast<char>(
+                         std::tolower(static_cast<unsigned char>(item)));
+                   });
+    result.degrees = units == "degree" || units == "degrees" || units == "deg";
+    return result;
+  }
+
+  /// Read a hyperslab of a variable.
+  template <typename T>
+  auto read(const int varid, const std::vector<size_t>& start,
+            const std::vector<size_t>& count, T* values) const -> void {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    check(get_vara(varid, start.data(), count.data(), values), path_);
+  }
+
+ private:
+  /// Path to the dataset.
+  std::string path_;
+  /// NetCDF identifier of the dataset.
+  int ncid_{-1};
+
+  /// Read a scalar numeric attribute, if it exists.
+  auto numeric_attribute(const int varid, const char* name,
+                         double& value) const -> bool {
+    auto length = size_t(0);
+    if (nc_inq_attlen(ncid_, varid, name, &length) != NC_NOERR ||
+        length != 1) {
+      return false;
+    }
+    return nc_get_att_double(ncid_, varid, name, &value) == NC_NOERR;
+  }
+
+  /// Read a text attribute, or an empty string if it does not exist.
+  auto text_attribute(const int varid, const char* name) const
+      -> std::string {
+    auto type = nc_type{};
+    auto length = size_t(0);
+    if (nc_inq_att(ncid_, varid, name, &type, &length) != NC_NOERR) {
+      return {};
+    }
+    if (type == NC_CHAR) {
+      auto result = std::string(length, '\0');
+      check(nc_get_att_text(ncid_, varid, name, &result[0]), path_);
+      return result.substr(0, result.find('\0'));
+    }
+    if (type == NC_STRING && length == 1) {
+      char* value = nullptr;
+      check(nc_get_att_string(ncid_, varid, name, &value), path_);
+      auto result = std::string(value != nullptr ? value : "");
+      nc_free_string(1, &value);
+      return result;
+    }
+    return {};
+  }
+
+  /// Get the default fill value of a type.
+  static auto default_fill_value(const nc_type type) -> double {
+    switch (type) {
+      case NC_BYTE:
+        return NC_FILL_BYTE;
+      case NC_SHORT:
+        return NC_FILL_SHORT;
+      case NC_INT:
+        return NC_FILL_INT;
+      case NC_FLOAT:
+        return NC_FILL_FLOAT;
+      case NC_DOUBLE:
+        return NC_FILL_DOUBLE;
+      default:
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  /// Read a hyperslab of double values.
+  inline auto get_vara(const int varid, const size_t* start,
+                       const size_t* count, double* values) const -> int {
+    return nc_get_vara_double(ncid_, varid, start, count, values);
+  }
+
+  /// Read a hyperslab of integer values.
+  inline auto get_vara(const int varid, const size_t* start,
+                       const size_t* count, int* values) const -> int {
+    return nc_get_vara_int(ncid_, varid, start, count, values);
+  }
+};
+
+/// Replace the `{constituent}` fields of a pattern by a constituent name.
+static auto format(std::string pattern, const std::string& constituent)
+    -> std::string {
+  static const auto field = std::string("{constituent}");
+  for (auto pos = pattern.find(field); pos != std::string::npos;
+       pos = pattern.find(field, pos + constituent.size())) {
+    pattern.replace(pos, field.size(), constituent);
+  }
+  return pattern;
+}
+
+/// Read a one-dimensional variable.
+template <typename T>
+static auto read_vector(const Dataset& ds, const std::string& name)
+    -> Vector<T> {
+  const auto varid = ds.variable(name);
+  const auto shape = ds.shape(varid);
+  if (shape.size() != 1) {
+    throw std::invalid_argument("variable '" + name + "' of " + ds.path() +
+                                " must be one-dimensional");
+  }
+  auto result = Vector<T>(static_cast<Eigen::Index>(shape[0]));
+  ds.read(varid, {0}, shape, result.data());
+  return result;
+}
+
+/// Read a two-dimensional variable with a given number of columns.
+template <int Columns>
+static auto read_table(const Dataset& ds, const std::string& name)
+    -> Eigen::Matrix<int, Eigen::Dynamic, Columns> {
+  const auto varid = ds.variable(name);
+  const auto shape = ds.shape(varid);
+  if (shape.size() != 2 || shape[1] != static_cast<size_t>(Columns)) {
+    throw std::invalid_argument("variable '" + name + "' of " + ds.path() +
+                                " must have " + std::to_string(Columns) +
+                                " columns");
+  }
+  auto result = Eigen::Matrix<int, Eigen::Dynamic, Columns, Eigen::RowMajor>(
+      static_cast<Eigen::Index>(shape[0]), Columns);
+  ds.read(varid, {0, 0}, shape, result.data());
+  return result;
+}
+
+/// Read the amplitudes and phases of a two-dimensional grid. The ranges
+/// select the parts of each dimension read, concatenated in the result.
+template <typename T>
+static auto read_grid(const Dataset& ds, const std::string& amplitude,
+                      const std::string& phase,
+                      const std::vector<size_t>& shape,
+                      const std::vector<Range>& rows,
+                      const std::vector<Range>& columns)
+    -> Vector<std::complex<T>> {
+  const auto amp_id = ds.variable(amplitude);
+  const auto pha_id = ds.variable(phase);
+  if (ds.shape(amp_id) != shape || ds.shape(pha_id) != shape) {
+    throw std::invalid_argument("inconsistent tidal model: " + ds.path());
+  }
+  const auto amp_decoder = ds.decoder(amp_id);
+  const auto pha_decoder = ds.decoder(pha_id);
+
+  auto n_rows = size_t(0);
+  for (const auto& item : rows) {
+    n_rows += item.second;
+  }
+  auto n_columns = size_t(0);
+  for (const auto& item : columns) {
+    n_columns += item.second;
+  }
+  auto result = Vector<std::complex<T>>(
+      static_cast<Eigen::Index>(n_rows * n_columns));
+
+  // The grid is read by blocks of rows.
+  const auto block = std::max(kChunkSize / std::max(n_columns, size_t(1)),
+                              size_t(1));
+  auto amp = std::vector<double>();
+  auto pha = std::vector<double>();
+  auto row = size_t(0);
+  for (const auto& range : rows) {
+    for (size_t first = 0; first < range.second; first += block) {
+      const auto count = std::min(block, range.second - first);
+      auto column = size_t(0);
+      for (const auto& item : columns) {
+        amp.resize(count * item.second);
+        pha.resize(count * item.second);
+        ds.read(amp_id, {range.first + first, item.first},
+                {count, item.second}, amp.data());
+        ds.read(pha_id, {range.first + first, item.first},
+                {count, item.second}, pha.data());
+        for (size_t ix = 0; ix < count; ++ix) {
+          auto* values = result.data() + (row + ix) * n_columns + column;
+          for (size_t jx = 0; jx < item.second; ++jx) {
+            const auto kx = ix * item.second + jx;
+            values[jx] = wave_value(amp_decoder.operator()<T>(amp[kx]),
+                                    pha_decoder.operator()<T>(pha[kx]));
+          }
+        }
+        column += item.second;
+      }
+      row += count;
+    }
+  }
+  return result;
+}
+
+/// Ranges of indices of a longitude axis covering a bounding box.
+static auto longitude_ranges(const Axis& axis, const double x_min,
+                             const double x_max) -> std::vector<Range> {
+  const auto x0 = static_cast<size_t>(axis.find_index(x_min, true));
+  const auto x1 = static_cast<size_t>(axis.find_index(x_max, true));
+  // A box crossing the date line is split in two parts.
+  if (x0 > x1) {
+    return {{x0, static_cast<size_t>(axis.size()) - x0}, {0, x1 + 1}};
+  }
+  return {{x0, x1 - x0 + 1}};
+}
+
+/// Ranges of indices of a latitude axis covering a bounding box.
+static auto latitude_ranges(const Axis& axis, const double y_min,
+                            const double y_max) -> std::vector<Range> {
+  auto y0 = static_cast<size_t>(axis.find_index(y_min, true));
+  auto y1 = static_cast<size_t>(axis.find_index(y_max, true));
+  if (y0 > y1) {
+    std::swap(y0, y1);
+  }
+  return {{y0, y1 - y0 + 1}};
+}
+
+/// Select the values of an axis covered by ranges of indices.
+static auto select(const Eigen::VectorXd& values,
+                   const std::vector<Range>& ranges) -> Eigen::VectorXd {
+  auto size = Eigen::Index(0);
+  for (const auto& item : ranges) {
+    size += static_cast<Eigen::Index>(item.second);
+  }
+  auto result = Eigen::VectorXd(size);
+  auto position = Eigen::Index(0);
+  for (const auto& item : ranges) {
+    const auto count = static_cast<Eigen::Index>(item.second);
+    result.segment(position, count) =
+        values.segment(static_cast<Eigen::Index>(item.first), count);
+    position += count;
+  }
+  return result;
+}
+
+auto is_double_precision(const std::string& path, const std::string& variable)
+    -> bool {
+  const Dataset ds(path);
+  return ds.type(ds.variable(variable)) == NC_DOUBLE;
+}
+
+template <typename T>
+auto load_cartesian(const CartesianSettings& settings, size_t num_threads)
+    -> std::shared_ptr<tidal_model::Cartesian<T>> {
+  if (settings.paths.empty()) {
+    throw std::invalid_argument("no NetCDF files specified");
+  }
+  const auto constituents =
+      std::vector<std::pair<Constituent, std::string>>(settings.paths.begin(),
+                                                       settings.paths.end());
+
+  // The first file defines the grid of the model.
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto shape = std::vector<size_t>();
+  {
+    const Dataset ds(constituents.front().second);
+    lon = read_vector<double>(ds, settings.longitude);
+    lat = read_vector<double>(ds, settings.latitude);
+    shape = ds.shape(ds.variable(settings.amplitude));
+  }
+  if (shape.size() != 2) {
+    throw std::invalid_argument("the tidal constituents must be stored in "
+                                "two-dimensional grids");
+  }
+  const auto longitude_major = shape[0] == static_cast<size_t>(lon.size());
+
+  auto lon_ranges = std::vector<Range>{{0, static_cast<size_t>(lon.size())}};
+  auto lat_ranges = std::vector<Range>{{0, static_cast<size_t>(lat.size())}};
+  if (settings.bbox) {
+    const auto& bbox = *settings.bbox;
+    lon_ranges =
+        longitude_ranges(Axis(lon, settings.epsilon, true), std::get<0>(bbox),
+                         std::get<2>(bbox));
+    lat_ranges =
+        latitude_ranges(Axis(lat), std::get<1>(bbox), std::get<3>(bbox));
+    lon = select(lon, lon_ranges);
+    lat = select(lat, lat_ranges);
+  }
+  const auto& rows = longitude_major ? lon_ranges : lat_ranges;
+  const auto& columns = longitude_major ? lat_ranges : lon_ranges;
+
+  auto model = std::make_shared<tidal_model::Cartesian<T>>(
+      Axis(lon, settings.epsilon, true), Axis(lat), settings.tide_type,
+      longitude_major, settings.max_distance);
+
+  // The files are read concurrently, then the grids are moved into the
+  // model.
+  auto waves = std::vector<Vector<std::complex<T>>>(constituents.size());
+  detail::parallel_for(
+      [&](const size_t start, const size_t end) {
+        for (auto ix = start; ix < end; ++ix) {
+          const Dataset ds(constituents[ix].second);
+          waves[ix] = read_grid<T>(ds, settings.amplitude, settings.phase,
+                                   shape, rows, columns);
+        }
+      },
+      constituents.size(), num_threads);
+  for (size_t ix = 0; ix < constituents.size(); ++ix) {
+    model->add_constituent(constituents[ix].first, std::move(waves[ix]));
+  }
+  model->dynamic(settings.dynamic);
+  return model;
+}
+
+/// Load a %LGP tidal model.
+template <typename T, int N, typename Model>
+static auto load_lgp(const LGPSettings& settings, size_t num_threads)
+    -> std::shared_ptr<Model> {
+  const Dataset ds(settings.path);
+  auto lon = read_vector<double>(ds, settings.longitude);
+  auto lat = read_vector<double>(ds, settings.latitude);
+  Eigen::Matrix<int32_t, -1, 3> triangles =
+      read_table<3>(ds, settings.triangle);
+  typename Model::codes_t codes = read_table<N * 3>(ds, settings.codes);
+
+  // Original position of the values stored by the model. If empty, the
+  // values are stored in their original order.
+  auto sources = Vector<int64_t>();
+  if (settings.renumber) {
+    const auto order = mesh::hilbert_order(lon, lat, triangles);
+    const auto vertex_order =
+        mesh::first_touch_order(triangles, order, lon.size());
+    sources = mesh::first_touch_order(codes, order, codes.maxCoeff() + 1);
+    const auto vertex_position = mesh::inverse_order(vertex_order);
+    const auto code_position = mesh::inverse_order(sources);
+    auto new_lon = Eigen::VectorXd(lon.size());
+    auto new_lat = Eigen::VectorXd(lat.size());
+    for (Eigen::Index ix = 0; ix < lon.size(); ++ix) {
+      new_lon(ix) = lon(vertex_order[ix]);
+      new_lat(ix) = lat(vertex_order[ix]);
+    }
+    auto new_triangles = Eigen::Matrix<int32_t, -1, 3>(triangles.rows(), 3);
+    auto new_codes = typename Model::codes_t(codes.rows(), N * 3);
+    for (Eigen::Index ix = 0; ix < triangles.rows(); ++ix) {
+      for (auto jx = 0; jx < 3; ++jx) {
+        new_triangles(ix, jx) =
+            static_cast<int32_t>(vertex_position[triangles(order[ix], jx)]);
+      }
+      for (auto jx = 0; jx < N * 3; ++jx) {
+        new_codes(ix, jx) =
+            static_cast<int>(code_position[codes(order[ix], jx)]);
+      }
+    }
+    lon = std::move(new_lon);
+    lat = std::move(new_lat);
+    triangles = std::move(new_triangles);
+    codes = std::move(new_codes);
+  }
+
+  auto index = std::make_shared<mesh::Index>(
+      std::move(lon), std::move(lat), std::move(triangles), settings.index);
+  if (settings.reference_transforms) {
+    index->build_reference_transforms();
+  }
+  if (settings.coastal_band && settings.max_distance > 0) {
+    index->build_coastal_band(settings.max_distance);
+  }
+  auto model =
+      std::make_shared<Model>(std::move(index), std::move(codes),
+                              settings.tide_type, settings.max_distance,
+                              settings.bbox);
+  const auto& selected = model->selected_indices();
+  if (selected.size() != 0) {
+    if (sources.size() != 0) {
+      auto composed = Vector<int64_t>(selected.size());
+      for (Eigen::Index ix = 0; ix < selected.size(); ++ix) {
+        composed[ix] = sources[selected[ix]];
+      }
+      sources = std::move(composed);
+    } else {
+      sources = selected;
+    }
+  }
+
+  // Names of the constituents to load.
+  auto names = settings.constituents;
+  if (names.empty()) {
+    names = constituents::known();
+  }
+  auto identifiers = std::vector<Constituent>();
+  for (const auto& item : names) {
+    identifiers.push_back(constituents::parse(item));
+  }
+
+  // The constituents are read concurrently, each value being stored at its
+  // position in the model.
+  auto waves = std::vector<Vector<std::complex<T>>>(names.size());
+  detail::parallel_for(
+      [&](const size_t start, const size_t end) {
+        for (auto ix = start; ix < end; ++ix) {
+          const auto amp_id =
+              ds.variable(format(settings.amplitude, names[ix]));
+          const auto pha_id = ds.variable(format(settings.phase, names[ix]));
+          const auto shape = ds.shape(amp_id);
+          if (shape.size() != 1 || ds.shape(pha_id) != shape) {
+            throw std::invalid_argument(
+                "invalid shape of the tidal constituent '" + names[ix] + "'");
+          }
+          const auto amp_decoder = ds.decoder(amp_id);
+          const auto pha_decoder = ds.decoder(pha_id);
+          const auto size = static_cast<int64_t>(shape[0]);
+
+          // Position of each value of the variable in the model.
+          auto positions = Vector<int64_t>();
+          if (sources.size() != 0) {
+            positions = Vector<int64_t>::Constant(size, -1);
+            for (Eigen::Index jx = 0; jx < sources.size(); ++jx) {
+              if (sources[jx] < 0 || sources[jx] >= size) {
+                throw std::invalid_argument(
+                    "LGP code out of range of the tidal constituent '" +
+                    names[ix] + "'");
+              }
+              positions[sources[jx]] = jx;
+            }
+          }
+          auto& wave = waves[ix];
+          wave.resize(sources.size() != 0 ? sources.size() : size);
+          auto amp = std::vector<double>();
+          auto pha = std::vector<double>();
+          for (int64_t first = 0; first < size;
+               first += static_cast<int64_t>(kChunkSize)) {
+            const auto count = static_cast<size_t>(
+                std::min(static_cast<int64_t>(kChunkSize), size - first));
+            amp.resize(count);
+            pha.resize(count);
+            ds.read(amp_id, {static_cast<size_t>(first)}, {count}, amp.data());
+            ds.read(pha_id, {static_cast<size_t>(first)}, {count}, pha.data());
+            for (size_t jx = 0; jx < count; ++jx) {
+              const auto position = positions.size() != 0
+                                        ? positions[first + jx]
+                                        : first + static_cast<int64_t>(jx);
+              if (position >= 0) {
+                wave[position] =
+                    wave_value(amp_decoder.operator()<T>(amp[jx]),
+                               pha_decoder.operator()<T>(pha[jx]));
+              }
+            }
+          }
+        }
+      },
+      names.size(), num_threads);
+  for (size_t ix = 0; ix < names.size(); ++ix) {
+    model->add_constituent(identifiers[ix], std::move(waves[ix]));
+  }
+  if (settings.interleaved) {
+    model->interleave();
+  }
+  model->dynamic(settings.dynamic);
+  return model;
+}
+
+template <typename T>
+auto load_lgp1(const LGPSettings& settings, size_t num_threads)
+    -> std::shared_ptr<tidal_model::LGP1<T>> {
+  return load_lgp<T, 1, tidal_model::LGP1<T>>(settings, num_threads);
+}
+
+template <typename T>
+auto load_lgp2(const LGPSettings& settings, size_t num_threads)
+    -> std::shared_ptr<tidal_model::LGP2<T>> {
+  return load_lgp<T, 2, tidal_model::LGP2<T>>(settings, num_threads);
+}
+
+template auto load_cartesian<double>(const CartesianSettings&, size_t)
+    -> std::shared_ptr<tidal_model::Cartesian<double>>;
+template auto load_cartesian<float>(const CartesianSettings&, size_t)
+    -> std::shared_ptr<tidal_model::Cartesian<float>>;
+template auto load_lgp1<double>(const LGPSettings&, size_t)
+    -> std::shared_ptr<tidal_model::LGP1<double>>;
+template auto load_lgp1<float>(const LGPSettings&, size_t)
+    -> std::shared_ptr<tidal_model::LGP1<float>>;
+template auto load_lgp2<double>(const LGPSettings&, size_t)
+    -> std::shared_ptr<tidal_model::LGP2<double>>;
+template auto load_lgp2<float>(const LGPSettings&, size_t)
+    -> std::shared_ptr<tidal_model::LGP2<float>>;
+
+}  // namespace netcdf
+}  // namespace fes
@@ -0,0 +1,68 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/interpolation_plan.hpp"
+
+#include "fes/detail/grid.hpp"
+#include "fes/detail/math.hpp"
+
+namespace fes {
+namespace tidal_model {
+
+InterpolationPlan::InterpolationPlan(
+    Axis lon, Axis lat, const bool row_major,
+    const Eigen::Ref<const Eigen::VectorXd>& lon_points,
+    const Eigen::Ref<const Eigen::VectorXd>& lat_points,
+    const size_t num_threads)
+    : lon_(std::move(lon)),
+      lat_(std::move(lat)),
+      row_major_(row_major),
+      indices_(lon_points.size(), Eigen::Index{kNodes}),
+      weights_(lon_points.size(), Eigen::Index{kNodes}) {
+  if (lon_points.size() != lat_points.size()) {
+    throw std::invalid_argument("lon and lat must have the same size");
+  }
+  const auto grid =
+      detail::Grid<char>(nullptr, static_cast<size_t>(lon_.size()),
+                         static_cast<size_t>(lat_.size()), row_major_);
+
+  auto worker = [&](const int64_t start, const int64_t end) -> void {
+    for (auto ix = start; ix < end; ++ix) {
+      auto lon_index = lon_.find_indices(lon_points[ix]);
+      auto lat_index = lat_.find_indices(lat_points[ix]);
+      if (!lon_index || !lat_index) {
+        indices_.row(ix).setConstant(-1);
+        weights_.row(ix).setZero();
+        continue;
+      }
+      int64_t i1;
+      int64_t i2;
+      int64_t j1;
+      int64_t j2;
+      std::tie(i1, i2) = *lon_index;
+      std::tie(j1, j2) = *lat_index;
+      const auto x1 = lon_(i1);
+      const auto x2 = lon_(i2);
+      const auto y1 = lat_(j1);
+      const auto y2 = lat_(j2);
+
+      double wx1;
+      double wx2;
+      double wy1;
+      double wy2;
+      std::tie(wx1, wx2, wy1, wy2) = detail::math::bilinear_weights(
+          detail::math::normalize_angle(lon_points[ix], x1), lat_points[ix],
+          x1, y1, detail::math::normalize_angle(x2, x1), y2);
+
+      // Same node order as in Cartesian::interpolate.
+      indices_.row(ix) << grid.index(i1, j1), grid.index(i1, j2),
+          grid.index(i2, j1), grid.index(i2, j2);
+      weights_.row(ix) << wx1 * wy1, wx1 * wy2, wx2 * wy1, wx2 * wy2;
+    }
+  };
+  detail::parallel_for(worker, lon_points.size(), num_threads);
+}
+
+}  // namespace tidal_model
+}  // namespace fes
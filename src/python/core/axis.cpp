@@ -25,7 +25,8 @@ of a variable's values.
 Default constructor.
 
 Args:
-     points: The axis points.
+     points: The axis points, strictly monotonic. They may not be evenly
+          spaced.
      epsilon: The tolerance used to determine if the axis is circular.
      is_circular: True if the axis is circular. For example,
           longitude is circular.
@@ -38,11 +39,15 @@ Args:
       .def_property_readonly("start", &fes::Axis::start,
                              "Return the first value of the axis.")
       .def_property_readonly("step", &fes::Axis::step,
-                             "Return the step of the axis.")
+                             "Return the step of the axis (the mean step if "
+                             "the axis values are not evenly spaced).")
       .def_property_readonly("is_ascending", &fes::Axis::is_ascending,
                              "Return true if the axis is ascending.")
       .def_property_readonly("is_circular", &fes::Axis::is_circular,
                              "Return true if the axis is circular.")
+      .def_property_readonly("is_regular", &fes::Axis::is_regular,
+                             "Return true if the axis values are evenly "
+                             "spaced.")
       .def("end", &fes::Axis::end, "Return the last value of the axis.")
       .def("min_value", &fes::Axis::min_value,
            "Return the minimum value of the axis.")
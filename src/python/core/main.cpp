@@ -12,9 +12,14 @@ extern void init_settings(py::module& m);
 extern void init_axis(py::module& m);
 extern void init_cartesian_model(py::module& m);
 extern void init_constituent(py::module& m);
+extern void init_curvilinear_model(py::module& m);
 extern void init_datemanip(py::module& m);
+extern void init_interpolation_plan(py::module& m);
 extern void init_lgp_model(py::module& m);
 extern void init_mesh_index(py::module& m);
+extern void init_mesh_renumbering(py::module& m);
+extern void init_nested_cartesian_model(py::module& m);
+extern void init_netcdf(py::module& m);
 extern void init_tide(py::module& m);
 extern void init_wave_order2(py::module& m);
 extern void init_wave_table(py::module& m);
@@ -26,6 +31,7 @@ PYBIND11_MODULE(core, m) {
   auto datemanip = m.def_submodule("datemanip", "Date manipulation");
   auto tidal_model = m.def_submodule("tidal_model", "Tidal model");
   auto mesh = m.def_submodule("mesh", "Mesh");
+  auto netcdf = m.def_submodule("netcdf", "NetCDF tidal models");
 
   // Date manipulation (convert the date to UTC seconds, always ignoring the
   // local time zone)
@@ -45,6 +51,7 @@ PYBIND11_MODULE(core, m) {
 
   // Define the mesh indexer.
   init_mesh_index(mesh);
+  init_mesh_renumbering(mesh);
 
   // Define the calculation settings.
   init_settings(m);
@@ -52,7 +59,13 @@ PYBIND11_MODULE(core, m) {
   // Define the tidal models.
   init_abstract_tide_model(m);
   init_cartesian_model(tidal_model);
+  init_curvilinear_model(tidal_model);
   init_lgp_model(tidal_model);
+  init_nested_cartesian_model(tidal_model);
+  init_interpolation_plan(tidal_model);
+
+  // Define the loading of the NetCDF tidal models.
+  init_netcdf(netcdf);
 
   // Define the tide estimator.
   init_tide(m);
@@ -8,14 +8,24 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "fes/python/serialize.hpp"
+
 namespace py = pybind11;
 
 void init_mesh_index(py::module& m) {
+  py::enum_<fes::mesh::IndexType>(m, "IndexType")
+      .value("kRTree", fes::mesh::IndexType::kRTree)
+      .value("kBucketGrid", fes::mesh::IndexType::kBucketGrid)
+      .export_values();
+
   py::class_<fes::mesh::Index, std::shared_ptr<fes::mesh::Index>>(
       m, "Index", "Index the triangles of a mesh.")
       .def(py::init<Eigen::VectorXd, Eigen::VectorXd,
-                    Eigen::Matrix<int32_t, -1, 3>>(),
+                    Eigen::Matrix<int32_t, -1, 3>, fes::mesh::IndexType,
+                    double>(),
            py::arg("lon"), py::arg("lat"), py::arg("triangles"),
+           py::arg("type") = fes::mesh::IndexType::kRTree,
+           py::arg("resolution") = 0.0,
            R"__doc__(
 Construct an index of a mesh.
 
@@ -23,24 +33,94 @@ Args:
     lon: The longitude of the vertices.
     lat: The latitude of the vertices.
     triangles: The triangles of the mesh.
+    type: The structure used to locate the triangle containing a point. With
+        ``kBucketGrid``, the points are located using a grid of buckets
+        listing the triangles, the R-Tree being used as a fallback and to
+        extrapolate the points outside the mesh.
+    resolution: The height of the buckets, in degrees, used with
+        ``kBucketGrid``. If 0, it is derived from the mean size of the
+        triangles.
 )__doc__",
            py::call_guard<py::gil_scoped_release>())
-      .def("lon", &fes::mesh::Index::lon, R"__doc__(
+      .def_property_readonly("type", &fes::mesh::Index::type,
+                             "The structure used to locate the points.")
+      .def("lon", &fes::mesh::Index::lon, py::return_value_policy::copy,
+           R"__doc__(
 Get the longitude of the vertices.
 
 Returns:
     The longitude of the vertices.
 )__doc__")
-      .def("lat", &fes::mesh::Index::lat, R"__doc__(
+      .def("lat", &fes::mesh::Index::lat, py::return_value_policy::copy,
+           R"__doc__(
 Get the latitude of the vertices.
 
 Returns:
     The latitude of the vertices.
 )__doc__")
-      .def("triangles", &fes::mesh::Index::triangles, R"__doc__(
+      .def("triangles", &fes::mesh::Index::triangles,
+           py::return_value_policy::copy, R"__doc__(
 Get the triangles of the mesh.
 
 Returns:
     The triangles of the mesh.
-)__doc__");
+)__doc__")
+      .def("build_reference_transforms",
+           &fes::mesh::Index::build_reference_transforms,
+           R"__doc__(
+Precompute the reference transform of each triangle.
+
+The reference coordinates of a point and its containment in a triangle are then
+evaluated with a few multiplications instead of being derived from the
+vertices at each query. The table uses 48 bytes per triangle.
+)__doc__",
+           py::call_guard<py::gil_scoped_release>())
+      .def("has_reference_transforms",
+           &fes::mesh::Index::has_reference_transforms, R"__doc__(
+Check if the reference transforms of the triangles are precomputed.
+
+Returns:
+    True if the transforms are precomputed.
+)__doc__")
+      .def("build_coastal_band", &fes::mesh::Index::build_coastal_band,
+           py::arg("max_distance"), py::arg("resolution") = 0.0,
+           R"__doc__(
+Precompute the extrapolation stencils of the points located around the mesh.
+
+The band is a raster of the cells located within the extrapolation distance of
+the mesh boundary, each cell storing the vertices that may be the nearest to
+the points it contains. The vertices nearest to a point located outside the
+mesh are then read from the stencil of its cell instead of being searched in
+the R-Tree. The vertices found are the same, so the band does not change the
+extrapolated values. The points located outside the band are searched in the
+R-Tree.
+
+Args:
+    max_distance: The extrapolation distance, in meters.
+    resolution: The size of the cells, in degrees. If 0, it is derived from
+        the distance between the boundary vertices.
+)__doc__",
+           py::call_guard<py::gil_scoped_release>())
+      .def("has_coastal_band", &fes::mesh::Index::has_coastal_band,
+           R"__doc__(
+Check if the extrapolation stencils around the mesh are precomputed.
+
+Returns:
+    True if the stencils are precomputed.
+)__doc__"))
+      .def("__reduce_ex__", &fes::python::reduce_ex<fes::mesh::Index>,
+           py::arg("protocol"),
+           R"__doc__(
+Reduce the index for pickling.
+
+With the pickle protocol 5, the large arrays of the index are exported as
+out-of-band buffers, which can be transferred without being copied.
+)__doc__")
+      .def(py::pickle(
+          [](const fes::mesh::Index& self) {
+            return fes::python::getstate(self);
+          },
+          [](const py::object& state) {
+            return fes::python::setstate<fes::mesh::Index>(state);
+          }));
 }
@@ -0,0 +1,56 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/renumbering.hpp"
+
+#include <pybind11/eigen.h>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+void init_mesh_renumbering(py::module& m) {
+  m.def("hilbert_order", &fes::mesh::hilbert_order, py::arg("lon"),
+        py::arg("lat"), py::arg("triangles"),
+        py::call_guard<py::gil_scoped_release>(),
+        R"__doc__(
+Get the order of the triangles of a mesh along a Hilbert curve.
+
+Sorting the triangles by the position of their barycenter along the curve
+stores the triangles close in space close in memory.
+
+Args:
+    lon: The longitude coordinates of the mesh vertices.
+    lat: The latitude coordinates of the mesh vertices.
+    triangles: The mesh triangles.
+
+Returns:
+    The index of the original triangle stored at each new position.
+)__doc__");
+
+  m.def(
+      "first_touch_order",
+      [](const Eigen::Matrix<int32_t, -1, -1>& table,
+         const fes::Vector<int64_t>& rows,
+         const int64_t size) -> fes::Vector<int64_t> {
+        return fes::mesh::first_touch_order(table, rows, size);
+      },
+      py::arg("table"), py::arg("rows"), py::arg("size"),
+      py::call_guard<py::gil_scoped_release>(),
+      R"__doc__(
+Get the order of the items referenced by the rows of a table, in the order in
+which they are first referenced.
+
+This order gives the numbering of the vertices (or of the LGP codes) matching
+a new order of the triangles. The items that are never referenced are placed
+at the end, in their original order.
+
+Args:
+    table: The table referencing the items, one row per triangle.
+    rows: The order in which the rows are visited.
+    size: The number of items.
+
+Returns:
+    The index of the original item stored at each new position.
+)__doc__");
+}
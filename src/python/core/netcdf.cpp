@@ -0,0 +1,252 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef FES_HAVE_NETCDF
+#include "fes/netcdf/loader.hpp"
+#include "fes/python/optional.hpp"
+#endif
+
+namespace py = pybind11;
+
+#ifdef FES_HAVE_NETCDF
+
+namespace netcdf = fes::netcdf;
+
+// Load a Cartesian model with the precision of the amplitudes stored in the
+// files.
+static auto load_cartesian(const netcdf::CartesianSettings& settings,
+                           const size_t num_threads) -> py::object {
+  if (settings.paths.empty()) {
+    throw std::invalid_argument("no NetCDF files specified");
+  }
+  auto is_double = false;
+  {
+    py::gil_scoped_release release;
+    is_double = netcdf::is_double_precision(settings.paths.begin()->second,
+                                            settings.amplitude);
+  }
+  if (is_double) {
+    std::shared_ptr<fes::tidal_model::Cartesian<double>> model;
+    {
+      py::gil_scoped_release release;
+      model = netcdf::load_cartesian<double>(settings, num_threads);
+    }
+    return py::cast(model);
+  }
+  std::shared_ptr<fes::tidal_model::Cartesian<float>> model;
+  {
+    py::gil_scoped_release release;
+    model = netcdf::load_cartesian<float>(settings, num_threads);
+  }
+  return py::cast(model);
+}
+
+// Load a LGP model of the given type.
+template <typename T>
+static auto load_lgp(const netcdf::LGPSettings& settings, const bool lgp2,
+                     const size_t num_threads) -> py::object {
+  if (lgp2) {
+    std::shared_ptr<fes::tidal_model::LGP2<T>> model;
+    {
+      py::gil_scoped_release release;
+      model = netcdf::load_lgp2<T>(settings, num_threads);
+    }
+    return py::cast(model);
+  }
+  std::shared_ptr<fes::tidal_model::LGP1<T>> model;
+  {
+    py::gil_scoped_release release;
+    model = netcdf::load_lgp1<T>(settings, num_threads);
+  }
+  return py::cast(model);
+}
+
+// Load a LGP model with the precision of the amplitudes stored in the file.
+static auto load_lgp(const netcdf::LGPSettings& settings, const bool lgp2,
+                     const size_t num_threads) -> py::object {
+  auto first = settings.constituents.empty() ? fes::constituents::known()[0]
+                                             : settings.constituents[0];
+  auto amplitude = settings.amplitude;
+  const auto pattern = std::string("{constituent}");
+  auto pos = amplitude.find(pattern);
+  while (pos != std::string::npos) {
+    amplitude.replace(pos, pattern.size(), first);
+    pos = amplitude.find(pattern, pos + first.size());
+  }
+  auto is_double = false;
+  {
+    py::gil_scoped_release release;
+    is_double = netcdf::is_double_precision(settings.path, amplitude);
+  }
+  return is_double ? load_lgp<double>(settings, lgp2, num_threads)
+                   : load_lgp<float>(settings, lgp2, num_threads);
+}
+
+#endif
+
+void init_netcdf(py::module& m) {
+#ifdef FES_HAVE_NETCDF
+  m.attr("available") = true;
+
+  m.def(
+      "load_cartesian",
+      [](const std::map<std::string, std::string>& paths,
+         const std::string& longitude, const std::string& latitude,
+         const std::string& amplitude, const std::string& phase,
+         const double epsilon, const double max_distance,
+         const fes::TideType tide_type,
+         const std::vector<fes::Constituent>& dynamic,
+         const boost::optional<netcdf::BoundingBox>& bbox,
+         const size_t num_threads) -> py::object {
+        auto settings = netcdf::CartesianSettings();
+        for (const auto& item : paths) {
+          settings.paths.emplace(fes::constituents::parse(item.first),
+                                 item.second);
+        }
+        settings.longitude = longitude;
+        settings.latitude = latitude;
+        settings.amplitude = amplitude;
+        settings.phase = phase;
+        settings.epsilon = epsilon;
+        settings.max_distance = max_distance;
+        settings.tide_type = tide_type;
+        settings.dynamic = dynamic;
+        settings.bbox = bbox;
+        return load_cartesian(settings, num_threads);
+      },
+      py::arg("paths"), py::arg("longitude") = "lon",
+      py::arg("latitude") = "lat", py::arg("amplitude") = "amplitude",
+      py::arg("phase") = "phase", py::arg("epsilon") = 1e-6,
+      py::arg("max_distance") = 0.0,
+      py::arg("tide_type") = fes::TideType::kTide,
+      py::arg("dynamic") = std::vector<fes::Constituent>(),
+      py::arg("bbox") = boost::none, py::arg("num_threads") = 0,
+      R"__doc__(
+Load a Cartesian tidal model stored in one NetCDF file per constituent.
+
+The files are read concurrently and the amplitudes and phases are converted
+directly into the complex grids of the model. The precision of the model is
+the precision of the amplitudes stored in the files.
+
+Args:
+    paths: The path to the NetCDF file of each tidal constituent.
+    longitude: The name of the longitude variable.
+    latitude: The name of the latitude variable.
+    amplitude: The name of the amplitude variable.
+    phase: The name of the phase variable.
+    epsilon: The tolerance used to determine if the longitude axis is
+        circular.
+    max_distance: The maximum distance allowed to extrapolate the model.
+    tide_type: The type of tide handled by the model.
+    dynamic: The tidal constituents considered as part of the model, but not
+        defined by the grids.
+    bbox: The region to load (min_lon, min_lat, max_lon, max_lat). If not
+        set, the whole grids are loaded.
+    num_threads: The number of threads to use. If 0, the number of threads
+        is determined by the number of cores.
+
+Returns:
+    The tidal model.
+)__doc__");
+
+  m.def(
+      "load_lgp",
+      [](const std::string& path, const std::vector<std::string>& constituents,
+         const std::string& type, const std::string& longitude,
+         const std::string& latitude, const std::string& triangle,
+         const std::string& codes, const std::string& amplitude,
+         const std::string& phase, const fes::mesh::IndexType index,
+         const bool reference_transforms, const bool coastal_band,
+         const bool interleaved, const bool renumber,
+         const double max_distance, const fes::TideType tide_type,
+         const std::vector<fes::Constituent>& dynamic,
+         const boost::optional<netcdf::BoundingBox>& bbox,
+         const size_t num_threads) -> py::object {
+        if (type != "lgp1" && type != "lgp2") {
+          throw std::invalid_argument("unknown LGP type: " + type);
+        }
+        auto settings = netcdf::LGPSettings();
+        settings.path = path;
+        settings.constituents = constituents;
+        settings.longitude = longitude;
+        settings.latitude = latitude;
+        settings.triangle = triangle;
+        settings.codes = codes;
+        settings.amplitude = amplitude;
+        settings.phase = phase;
+        settings.index = index;
+        settings.reference_transforms = reference_transforms;
+        settings.coastal_band = coastal_band;
+        settings.interleaved = interleaved;
+        settings.renumber = renumber;
+        settings.max_distance = max_distance;
+        settings.tide_type = tide_type;
+        settings.dynamic = dynamic;
+        settings.bbox = bbox;
+        return load_lgp(settings, type == "lgp2", num_threads);
+      },
+      py::arg("path"), py::arg("constituents") = std::vector<std::string>(),
+      py::arg("type") = "lgp1", py::arg("longitude") = "lon",
+      py::arg("latitude") = "lat", py::arg("triangle") = "triangle",
+      py::arg("codes") = "codes",
+      py::arg("amplitude") = "{constituent}_amplitude",
+      py::arg("phase") = "{constituent}_phase",
+      py::arg("index") = fes::mesh::kRTree,
+      py::arg("reference_transforms") = false,
+      py::arg("coastal_band") = false, py::arg("interleaved") = false,
+      py::arg("renumber") = false, py::arg("max_distance") = 0.0,
+      py::arg("tide_type") = fes::TideType::kTide,
+      py::arg("dynamic") = std::vector<fes::Constituent>(),
+      py::arg("bbox") = boost::none, py::arg("num_threads") = 0,
+      R"__doc__(
+Load a LGP tidal model stored in a NetCDF file.
+
+The mesh is read first, then the tidal constituents are read concurrently and
+converted directly into the complex values of the model. The precision of the
+model is the precision of the amplitudes stored in the file.
+
+Args:
+    path: The path to the NetCDF file.
+    constituents: The names of the tidal constituents to load. If empty, all
+        the known constituents are loaded.
+    type: The LGP discretization: ``lgp1`` or ``lgp2``.
+    longitude: The name of the longitude variable.
+    latitude: The name of the latitude variable.
+    triangle: The name of the variable containing the vertices of the
+        triangles.
+    codes: The name of the variable containing the LGP codes.
+    amplitude: The pattern of the amplitude variables.
+    phase: The pattern of the phase variables.
+    index: The structure used to locate the triangles containing the points.
+    reference_transforms: Whether to precompute the reference transforms of
+        the triangles.
+    coastal_band: Whether to precompute the coastal extrapolation stencils.
+    interleaved: Whether to store the values of the constituents in
+        node-major order.
+    renumber: Whether to renumber the mesh along a Hilbert curve.
+    max_distance: The maximum distance allowed to extrapolate the model.
+    tide_type: The type of tide handled by the model.
+    dynamic: The tidal constituents considered as part of the model, but not
+        defined by the mesh.
+    bbox: The region to load (min_lon, min_lat, max_lon, max_lat). If not
+        set, the whole mesh is loaded.
+    num_threads: The number of threads to use. If 0, the number of threads
+        is determined by the number of cores.
+
+Returns:
+    The tidal model.
+)__doc__");
+#else
+  m.attr("available") = false;
+#endif
+}
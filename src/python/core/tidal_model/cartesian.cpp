@@ -9,6 +9,8 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "fes/python/serialize.hpp"
+
 namespace py = pybind11;
 
 template <typename T>
@@ -17,10 +19,10 @@ void init_cartesian_model(py::module& m, const std::string& suffix) {
              std::shared_ptr<fes::tidal_model::Cartesian<T>>>(
       m, ("Cartesian" + suffix).c_str(),
       "A tidal model that uses a Cartesian grid to store the wave models.")
-      .def(py::init<fes::Axis, fes::Axis, fes::TideType, bool>(),
+      .def(py::init<fes::Axis, fes::Axis, fes::TideType, bool, double>(),
            py::arg("lon"), py::arg("lat"),
            py::arg("tide_type") = fes::TideType::kTide,
-           py::arg("longitude_major") = true,
+           py::arg("longitude_major") = true, py::arg("max_distance") = 0,
            R"__doc__(
 Construct a Cartesian tidal model.
 
@@ -29,6 +31,9 @@ Args:
      lat: The latitude axis.
      tide_type: The type of tide.
      longitude_major: If true, the longitude axis is the major axis.
+     max_distance: The maximum distance, in meters, allowed to extrapolate
+          the wave model from the nearest defined grid cells. By default,
+          extrapolation is disabled.
 )__doc__")
       .def("lon", &fes::tidal_model::Cartesian<T>::lon, R"__doc__(
 Get the longitude axis.
@@ -41,19 +46,53 @@ Get the latitude axis.
 
 Returns:
      The latitude axis.
+)__doc__")
+      .def("max_distance", &fes::tidal_model::Cartesian<T>::max_distance,
+           R"__doc__(
+Get the maximum distance allowed to extrapolate the wave model.
+
+Returns:
+     The maximum distance, in meters.
+)__doc__")
+      .def("save", &fes::python::save<fes::tidal_model::Cartesian<T>>,
+           py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Save the tidal model to a file.
+
+The state of the model is written directly to the file, without being built in
+memory.
+
+Args:
+    path: The path to the file.
+)__doc__")
+      .def_static("load", &fes::python::load<fes::tidal_model::Cartesian<T>>,
+                  py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+                  R"__doc__(
+Load a tidal model saved by :meth:`save`.
+
+The values of the model are read directly from the file.
+
+Args:
+    path: The path to the file.
+
+Returns:
+    The tidal model.
+)__doc__")
+      .def("__reduce_ex__",
+           &fes::python::reduce_ex<fes::tidal_model::Cartesian<T>>,
+           py::arg("protocol"),
+           R"__doc__(
+Reduce the tidal model for pickling.
+
+With the pickle protocol 5, the large arrays of the model are exported as
+out-of-band buffers, which can be transferred without being copied.
 )__doc__")
       .def(py::pickle(
           [](const fes::tidal_model::Cartesian<T>& self) {
-            return py::bytes(self.getstate());
+            return fes::python::getstate(self);
           },
-          [](const py::bytes& state) {
-            char* buffer = nullptr;
-            py::ssize_t length = 0;
-            if (PyBytes_AsStringAndSize(state.ptr(), &buffer, &length) != 0) {
-              throw py::error_already_set();
-            }
-            return fes::tidal_model::Cartesian<T>::setstate(
-                fes::string_view(buffer, length));
+          [](const py::object& state) {
+            return fes::python::setstate<fes::tidal_model::Cartesian<T>>(state);
           }));
 }
 
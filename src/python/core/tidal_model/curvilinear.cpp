@@ -0,0 +1,80 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/curvilinear.hpp"
+
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+template <typename T>
+void init_curvilinear_model(py::module& m, const std::string& suffix) {
+  py::class_<fes::tidal_model::Curvilinear<T>, fes::AbstractTidalModel<T>,
+             std::shared_ptr<fes::tidal_model::Curvilinear<T>>>(
+      m, ("Curvilinear" + suffix).c_str(),
+      "A tidal model that uses a curvilinear grid to store the wave models.")
+      .def(py::init<fes::Matrix<double>, fes::Matrix<double>, fes::TideType,
+                    double>(),
+           py::arg("lon"), py::arg("lat"),
+           py::arg("tide_type") = fes::TideType::kTide,
+           py::arg("resolution") = 0,
+           R"__doc__(
+Construct a curvilinear tidal model.
+
+Args:
+     lon: The longitudes of the grid nodes, a two-dimensional array.
+     lat: The latitudes of the grid nodes, a two-dimensional array with the
+          same shape as ``lon``.
+     tide_type: The type of tide.
+     resolution: The size, in degrees, of the cells of the raster used to
+          locate the grid cells. If zero, the resolution is derived from the
+          mean size of the grid cells.
+
+.. note::
+
+     The wave models added to this model must be stored in the order of the
+     flattened coordinate arrays (i.e. ``wave.ravel()`` for an array with the
+     same shape as ``lon``).
+)__doc__")
+      .def("lon", &fes::tidal_model::Curvilinear<T>::lon, R"__doc__(
+Get the longitudes of the grid nodes.
+
+Returns:
+     The longitudes of the grid nodes.
+)__doc__")
+      .def("lat", &fes::tidal_model::Curvilinear<T>::lat, R"__doc__(
+Get the latitudes of the grid nodes.
+
+Returns:
+     The latitudes of the grid nodes.
+)__doc__")
+      .def("resolution", &fes::tidal_model::Curvilinear<T>::resolution,
+           R"__doc__(
+Get the size of the cells of the lookup raster.
+
+Returns:
+     The size of the cells, in degrees.
+)__doc__")
+      .def(py::pickle(
+          [](const fes::tidal_model::Curvilinear<T>& self) {
+            return py::bytes(self.getstate());
+          },
+          [](const py::bytes& state) {
+            char* buffer = nullptr;
+            py::ssize_t length = 0;
+            if (PyBytes_AsStringAndSize(state.ptr(), &buffer, &length) != 0) {
+              throw py::error_already_set();
+            }
+            return fes::tidal_model::Curvilinear<T>::setstate(
+                fes::string_view(buffer, length));
+          }));
+}
+
+void init_curvilinear_model(py::module& m) {
+  init_curvilinear_model<double>(m, "Complex128");
+  init_curvilinear_model<float>(m, "Complex64");
+}
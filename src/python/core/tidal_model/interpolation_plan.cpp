@@ -0,0 +1,87 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/interpolation_plan.hpp"
+
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+template <typename T>
+static void init_interpolation_plan(
+    py::class_<fes::tidal_model::InterpolationPlan>& cls) {
+  cls.def(py::init<const fes::tidal_model::Cartesian<T>&,
+                   const Eigen::Ref<const Eigen::VectorXd>&,
+                   const Eigen::Ref<const Eigen::VectorXd>&, size_t>(),
+          py::arg("model"), py::arg("lon"), py::arg("lat"),
+          py::arg("num_threads") = 0, py::call_guard<py::gil_scoped_release>(),
+          R"__doc__(
+Build the interpolation plan of a set of points on the grid of a model.
+
+Args:
+  model: The Cartesian model defining the grid.
+  lon: The longitudes of the points.
+  lat: The latitudes of the points.
+  num_threads: The number of threads to use. If 0, the number of threads is
+    determined by the number of cores.
+)__doc__")
+      .def("apply", &fes::tidal_model::InterpolationPlan::apply<T>,
+           py::arg("model"), py::arg("num_threads") = 0,
+           py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Interpolate the wave models of a Cartesian model at the points of the plan.
+
+Args:
+  model: The Cartesian model to interpolate. It must be defined on the grid
+    used to build the plan.
+  num_threads: The number of threads to use. If 0, the number of threads is
+    determined by the number of cores.
+
+Returns:
+  A tuple containing the interpolated wave models stored in a dictionary and a
+  flag indicating if the point was extrapolated, interpolated or if the model
+  is undefined.
+)__doc__");
+}
+
+void init_interpolation_plan(py::module& m) {
+  auto cls = py::class_<fes::tidal_model::InterpolationPlan>(
+      m, "InterpolationPlan",
+      R"__doc__(
+Bilinear interpolation plan of a set of points on a Cartesian grid.
+
+The plan stores the grid nodes surrounding each point and their weights. It is
+built once and applied to any number of Cartesian models defined on the same
+grid, without searching the grid axes again.
+)__doc__");
+  cls.def(py::init<fes::Axis, fes::Axis, bool,
+                   const Eigen::Ref<const Eigen::VectorXd>&,
+                   const Eigen::Ref<const Eigen::VectorXd>&, size_t>(),
+          py::arg("lon_axis"), py::arg("lat_axis"), py::arg("longitude_major"),
+          py::arg("lon"), py::arg("lat"), py::arg("num_threads") = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"__doc__(
+Build the interpolation plan of a set of points.
+
+Args:
+  lon_axis: The longitude axis of the grid.
+  lat_axis: The latitude axis of the grid.
+  longitude_major: If true, the longitude axis is the major axis.
+  lon: The longitudes of the points.
+  lat: The latitudes of the points.
+  num_threads: The number of threads to use. If 0, the number of threads is
+    determined by the number of cores.
+)__doc__")
+      .def("__len__", &fes::tidal_model::InterpolationPlan::size,
+           "Return the number of points of the plan.")
+      .def("indices", &fes::tidal_model::InterpolationPlan::indices,
+           "Return the positions of the grid nodes surrounding each point.")
+      .def("weights", &fes::tidal_model::InterpolationPlan::weights,
+           "Return the bilinear weights of the grid nodes.");
+  init_interpolation_plan<double>(cls);
+  init_interpolation_plan<float>(cls);
+}
@@ -9,6 +9,7 @@
 #include <pybind11/stl.h>
 
 #include "fes/python/optional.hpp"
+#include "fes/python/serialize.hpp"
 
 namespace py = pybind11;
 
@@ -49,6 +50,23 @@ Get the index of the finite elements.
 
 Returns:
     The index of the finite elements.
+)__doc__")
+      .def("interleave", &fes::tidal_model::LGP1<T>::interleave,
+           R"__doc__(
+Store the values of all the tidal constituents of each LGP node contiguously.
+
+The interpolation of a point inside a triangle then reads one contiguous row of
+values per LGP node instead of scattered values for each tidal constituent.
+The node-major table replaces the vectors of the loaded constituents, which
+are released. The constituents should be loaded before calling this method:
+each constituent added afterwards copies the table once.
+)__doc__")
+      .def("interleaved", &fes::tidal_model::LGP1<T>::interleaved,
+           R"__doc__(
+Check if the values of the tidal constituents are stored in node-major order.
+
+Returns:
+    True if the layout is interleaved.
 )__doc__")
       .def("selected_indices", &fes::tidal_model::LGP1<T>::selected_indices,
            R"__doc__(Retrieve the indices for wave model values that intersect
@@ -57,19 +75,89 @@ the specified bounding box.
 Returns:
   A vector containing the selected indices. If no bounding box is set, an empty
   vector is returned.
+)__doc__")
+      .def("interpolate_batch",
+           &fes::tidal_model::LGP1<T>::interpolate_batch, py::arg("lon"),
+           py::arg("lat"), py::arg("num_threads") = 0,
+           py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Interpolate the wave models loaded at the given coordinates, in batches.
+
+The points are processed in batches: the triangles containing the points of a
+batch are first located, then the wave values are gathered, those of the
+following points being prefetched while the current point is interpolated.
+The results are identical to those of :meth:`interpolate`.
+
+Args:
+    lon: The longitude of the points to interpolate at.
+    lat: The latitude of the points to interpolate at.
+    num_threads: The number of threads to use. If 0, the number of threads is
+        determined by the number of cores.
+
+Returns:
+    A tuple containing the interpolated values, one row per point and one
+    column per tidal constituent in the order of :meth:`identifiers`, and a
+    flag indicating if each point was extrapolated, interpolated or if the
+    model is undefined.
+)__doc__")
+      .def("subset", &fes::tidal_model::LGP1<T>::subset, py::arg("bbox"),
+           py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Extract the part of the model covering a bounding box into a standalone model.
+
+The triangles intersecting the bounding box are copied with their vertices,
+LGP codes and wave values, renumbered densely, into a new model with its own
+mesh index. The points located inside the bounding box and inside the mesh are
+interpolated as by this model. The extracted model can be pickled to be loaded
+by workers processing only this region.
+
+Args:
+    bbox: The bounding box to extract: the minimum longitude, the minimum
+        latitude, the maximum longitude, and the maximum latitude.
+
+Returns:
+    The extracted model. Its selected indices give the position of its values
+    in the wave models read by this model.
+)__doc__")
+      .def("save", &fes::python::save<fes::tidal_model::LGP1<T>>,
+           py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Save the tidal model to a file.
+
+The state of the model is written directly to the file, without being built in
+memory.
+
+Args:
+    path: The path to the file.
+)__doc__")
+      .def_static("load", &fes::python::load<fes::tidal_model::LGP1<T>>,
+                  py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+                  R"__doc__(
+Load a tidal model saved by :meth:`save`.
+
+The values of the model are read directly from the file.
+
+Args:
+    path: The path to the file.
+
+Returns:
+    The tidal model.
+)__doc__")
+      .def("__reduce_ex__",
+           &fes::python::reduce_ex<fes::tidal_model::LGP1<T>>,
+           py::arg("protocol"),
+           R"__doc__(
+Reduce the tidal model for pickling.
+
+With the pickle protocol 5, the large arrays of the model are exported as
+out-of-band buffers, which can be transferred without being copied.
 )__doc__")
       .def(py::pickle(
           [](const fes::tidal_model::LGP1<T>& self) {
-            return py::bytes(self.getstate());
+            return fes::python::getstate(self);
           },
-          [](const py::bytes& state) {
-            char* buffer = nullptr;
-            py::ssize_t length = 0;
-            if (PyBytes_AsStringAndSize(state.ptr(), &buffer, &length) != 0) {
-              throw py::error_already_set();
-            }
-            return fes::tidal_model::LGP1<T>::setstate(
-                fes::string_view(buffer, length));
+          [](const py::object& state) {
+            return fes::python::setstate<fes::tidal_model::LGP1<T>>(state);
           }));
 }
 
@@ -110,6 +198,23 @@ Get the index of the finite elements.
 
 Returns:
     The index of the finite elements.
+)__doc__")
+      .def("interleave", &fes::tidal_model::LGP2<T>::interleave,
+           R"__doc__(
+Store the values of all the tidal constituents of each LGP node contiguously.
+
+The interpolation of a point inside a triangle then reads one contiguous row of
+values per LGP node instead of scattered values for each tidal constituent.
+The node-major table replaces the vectors of the loaded constituents, which
+are released. The constituents should be loaded before calling this method:
+each constituent added afterwards copies the table once.
+)__doc__")
+      .def("interleaved", &fes::tidal_model::LGP2<T>::interleaved,
+           R"__doc__(
+Check if the values of the tidal constituents are stored in node-major order.
+
+Returns:
+    True if the layout is interleaved.
 )__doc__")
       .def("selected_indices", &fes::tidal_model::LGP2<T>::selected_indices,
            R"__doc__(Retrieve the indices for wave model values that intersect
@@ -118,19 +223,89 @@ the specified bounding box.
 Returns:
   A vector containing the selected indices. If no bounding box is set, an empty
   vector is returned.
+)__doc__")
+      .def("interpolate_batch",
+           &fes::tidal_model::LGP2<T>::interpolate_batch, py::arg("lon"),
+           py::arg("lat"), py::arg("num_threads") = 0,
+           py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Interpolate the wave models loaded at the given coordinates, in batches.
+
+The points are processed in batches: the triangles containing the points of a
+batch are first located, then the wave values are gathered, those of the
+following points being prefetched while the current point is interpolated.
+The results are identical to those of :meth:`interpolate`.
+
+Args:
+    lon: The longitude of the points to interpolate at.
+    lat: The latitude of the points to interpolate at.
+    num_threads: The number of threads to use. If 0, the number of threads is
+        determined by the number of cores.
+
+Returns:
+    A tuple containing the interpolated values, one row per point and one
+    column per tidal constituent in the order of :meth:`identifiers`, and a
+    flag indicating if each point was extrapolated, interpolated or if the
+    model is undefined.
+)__doc__")
+      .def("subset", &fes::tidal_model::LGP2<T>::subset, py::arg("bbox"),
+           py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Extract the part of the model covering a bounding box into a standalone model.
+
+The triangles intersecting the bounding box are copied with their vertices,
+LGP codes and wave values, renumbered densely, into a new model with its own
+mesh index. The points located inside the bounding box and inside the mesh are
+interpolated as by this model. The extracted model can be pickled to be loaded
+by workers processing only this region.
+
+Args:
+    bbox: The bounding box to extract: the minimum longitude, the minimum
+        latitude, the maximum longitude, and the maximum latitude.
+
+Returns:
+    The extracted model. Its selected indices give the position of its values
+    in the wave models read by this model.
+)__doc__")
+      .def("save", &fes::python::save<fes::tidal_model::LGP2<T>>,
+           py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+           R"__doc__(
+Save the tidal model to a file.
+
+The state of the model is written directly to the file, without being built in
+memory.
+
+Args:
+    path: The path to the file.
+)__doc__")
+      .def_static("load", &fes::python::load<fes::tidal_model::LGP2<T>>,
+                  py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+                  R"__doc__(
+Load a tidal model saved by :meth:`save`.
+
+The values of the model are read directly from the file.
+
+Args:
+    path: The path to the file.
+
+Returns:
+    The tidal model.
+)__doc__")
+      .def("__reduce_ex__",
+           &fes::python::reduce_ex<fes::tidal_model::LGP2<T>>,
+           py::arg("protocol"),
+           R"__doc__(
+Reduce the tidal model for pickling.
+
+With the pickle protocol 5, the large arrays of the model are exported as
+out-of-band buffers, which can be transferred without being copied.
 )__doc__")
       .def(py::pickle(
           [](const fes::tidal_model::LGP2<T>& self) {
-            return py::bytes(self.getstate());
+            return fes::python::getstate(self);
           },
-          [](const py::bytes& state) {
-            char* buffer = nullptr;
-            py::ssize_t length = 0;
-            if (PyBytes_AsStringAndSize(state.ptr(), &buffer, &length) != 0) {
-              throw py::error_already_set();
-            }
-            return fes::tidal_model::LGP2<T>::setstate(
-                fes::string_view(buffer, length));
+          [](const py::object& state) {
+            return fes::python::setstate<fes::tidal_model::LGP2<T>>(state);
           }));
 }
 
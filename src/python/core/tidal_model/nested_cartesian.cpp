@@ -0,0 +1,77 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/nested_cartesian.hpp"
+
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+template <typename T>
+void init_nested_cartesian_model(py::module& m, const std::string& suffix) {
+  py::class_<fes::tidal_model::NestedCartesian<T>, fes::AbstractTidalModel<T>,
+             std::shared_ptr<fes::tidal_model::NestedCartesian<T>>>(
+      m, ("NestedCartesian" + suffix).c_str(),
+      "A tidal model that combines several Cartesian grids of different "
+      "resolutions.")
+      .def(py::init<const std::vector<
+                        std::shared_ptr<fes::tidal_model::Cartesian<T>>>&,
+                    double>(),
+           py::arg("models"), py::arg("resolution") = 1.0,
+           R"__doc__(
+Construct a nested Cartesian tidal model.
+
+Args:
+     models: The Cartesian tidal models, ordered from the finest to the
+          coarsest. A point is interpolated on the first model covering it
+          where the tidal constituents are defined. All models must handle the
+          same tide type and the same tidal constituents.
+     resolution: The size, in degrees, of the cells of the raster used to
+          dispatch the points to the models.
+)__doc__")
+      .def(
+          "grids",
+          [](const fes::tidal_model::NestedCartesian<T>& self) {
+            auto result = py::list();
+            for (const auto& item : self.grids()) {
+              result.append(py::make_tuple(item.lon, item.lat));
+            }
+            return result;
+          },
+          R"__doc__(
+Get the grids of the model.
+
+Returns:
+     The longitude and latitude axes of the grids, ordered from the finest to
+     the coarsest.
+)__doc__")
+      .def("resolution", &fes::tidal_model::NestedCartesian<T>::resolution,
+           R"__doc__(
+Get the size of the cells of the dispatch raster.
+
+Returns:
+     The size of the cells, in degrees.
+)__doc__")
+      .def(py::pickle(
+          [](const fes::tidal_model::NestedCartesian<T>& self) {
+            return py::bytes(self.getstate());
+          },
+          [](const py::bytes& state) {
+            char* buffer = nullptr;
+            py::ssize_t length = 0;
+            if (PyBytes_AsStringAndSize(state.ptr(), &buffer, &length) != 0) {
+              throw py::error_already_set();
+            }
+            return fes::tidal_model::NestedCartesian<T>::setstate(
+                fes::string_view(buffer, length));
+          }));
+}
+
+void init_nested_cartesian_model(py::module& m) {
+  init_nested_cartesian_model<double>(m, "Complex128");
+  init_nested_cartesian_model<float>(m, "Complex64");
+}
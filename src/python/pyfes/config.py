@@ -14,11 +14,19 @@ by the numerical model.
 from __future__ import annotations
 
 from typing import TYPE_CHECKING, Any, NamedTuple, Union
+from collections.abc import Iterable, Iterator, Mapping
+import concurrent.futures
 import dataclasses
 import enum
+import hashlib
+import json
 import os
+import pickle
 import re
 from re import Match
+import struct
+import threading
+import warnings
 
 import netCDF4
 import numpy
@@ -33,11 +41,15 @@ from .core import (
     kRadial,
     kTide,
     mesh,
+    netcdf,
     tidal_model,
 )
+from . import shared_memory
+from .shared_memory import _check_trusted
+from .version import __version__
 
 if TYPE_CHECKING:
-    from collections.abc import Callable
+    from collections.abc import Callable, Sequence
 
     from .type_hints import Matrix, Vector
 
@@ -53,6 +65,10 @@ MAX_INTERPOLATION_DEPTH = 10
 #: Number of dimensions expected in the wave data.
 WAVE_DIMENSIONS = 2
 
+#: Lock serializing the accesses to the NetCDF library, which is not
+#: thread-safe. The decoding of the values read runs concurrently.
+NETCDF_LOCK = threading.Lock()
+
 #: Alias to LPG classes known to this software.
 LGPModel = type[tidal_model.LGP1Complex64
                 | tidal_model.LGP1Complex128
@@ -79,6 +95,29 @@ class InterpolationDepthError(Exception):
     defines itself."""
 
 
+def _map(
+    function: Callable[[Any], Any],
+    items: Sequence[Any],
+    num_threads: int,
+) -> Iterator[Any]:
+    """Apply a function to items concurrently.
+
+    Args:
+        function: The function to apply.
+        items: The items to process.
+        num_threads: The maximum number of threads to use. If 0, the number
+            of threads is determined by the number of cores.
+
+    Returns:
+        The results of the function, in the order of the items.
+    """
+    if num_threads == 1 or len(items) <= 1:
+        yield from map(function, items)
+        return
+    with concurrent.futures.ThreadPoolExecutor(num_threads or None) as pool:
+        yield from pool.map(function, items)
+
+
 def _expand(rawval: str) -> str:
     """Interpolation of environment variables present in a character string.
 
@@ -199,7 +238,7 @@ def load_cartesian_model(
         indicating if grid is longitude-major.
     """
 
-    with netCDF4.Dataset(path) as ds:
+    with NETCDF_LOCK, netCDF4.Dataset(path) as ds:
         lon: Vector = ds.variables[lon_name][:]
         lat: Vector = ds.variables[lat_name][:]
         longitude_major = ds.variables[amp_name].shape[0] == lon.size
@@ -240,10 +279,10 @@ def load_cartesian_model(
             amp = numpy.ma.filled(ds.variables[amp_name][:], numpy.nan)
             pha = numpy.ma.filled(ds.variables[pha_name][:], numpy.nan)
 
-        if ds.variables[pha_name].units.lower() in [
-                'degree', 'degrees', 'deg'
-        ]:
-            pha = numpy.radians(pha)
+        units: str = ds.variables[pha_name].units
+
+    if units.lower() in ['degree', 'degrees', 'deg']:
+        pha = numpy.radians(pha)
 
     wave: Matrix = amp * numpy.cos(pha) + 1j * amp * numpy.sin(pha)
 
@@ -284,6 +323,10 @@ class Common:
     #: as a tuple of four floats: (min_lon, min_lat, max_lon, max_lat). Default
     #: is None, which means the whole grid is loaded.
     bbox: tuple[float, float, float, float] | None = None
+    #: Whether to load the model with the native NetCDF loader of the library,
+    #: which reads the constituents concurrently. Requires the library to be
+    #: built with the ``FES_ENABLE_NETCDF`` option.
+    native: bool = False
 
     def __post_init__(self) -> None:
         if self.tidal_type not in tuple(item.name.lower()
@@ -293,6 +336,9 @@ class Common:
             raise ValueError('longitude cannot be empty.')
         if not self.latitude:
             raise ValueError('latitude cannot be empty.')
+        if self.native and not netcdf.available:
+            raise ValueError('The native NetCDF loader is not available: the '
+                             'library was built without FES_ENABLE_NETCDF.')
         known_constituents = constituents.known()
         for item in self.dynamic:
             if item not in known_constituents:
@@ -303,6 +349,101 @@ class Common:
         """Return the list of dynamic constituents."""
         return list(map(constituents.parse, self.dynamic))
 
+    def files(self) -> list[str]:
+        """Return the paths of the files read to build the model."""
+        raise NotImplementedError
+
+    def cache_key(self) -> str:
+        """Return the key identifying the model built from this configuration.
+
+        The key depends on the settings, the version of the library, and the
+        path, size and modification time of the files read. It changes as
+        soon as one of them changes.
+        """
+        digest = hashlib.sha256()
+        digest.update(
+            json.dumps(
+                {
+                    'version': __version__,
+                    'type': type(self).__name__,
+                    'settings': dataclasses.asdict(self),
+                },
+                sort_keys=True,
+                default=str,
+            ).encode())
+        for item in self.files():
+            info = os.stat(item)
+            digest.update(f'{os.path.abspath(item)}:{info.st_size}:'
+                          f'{info.st_mtime_ns}'.encode())
+        return digest.hexdigest()
+
+    def load(self, num_threads: int = 0) -> TidalModel:
+        """Load the tidal model defined by the configuration.
+
+        Args:
+            num_threads: The maximum number of threads reading the
+                constituents. If 0, the number of threads is determined by the
+                number of cores.
+
+        Returns:
+            The tidal model.
+        """
+        raise NotImplementedError
+
+    def load_cached(self,
+                    cache: str | os.PathLike,
+                    num_threads: int = 0) -> TidalModel:
+        """Load the tidal model, reusing the model previously built from the
+        same configuration and files if it is stored in the cache.
+
+        Loading a model from the cache unpickles it, which can execute
+        arbitrary code: the cache must only be writable by the current user.
+        The directory is created with this restriction if it does not exist.
+        If it is owned by another user, or writable by the group or the other
+        users, the cache is not used, and the model is built and not stored.
+
+        Args:
+            cache: The directory storing the models built.
+            num_threads: The maximum number of threads reading the
+                constituents, if the model is built.
+
+        Returns:
+            The tidal model.
+        """
+        key = self.cache_key()
+        try:
+            os.makedirs(cache, mode=0o700, exist_ok=True)
+            _check_trusted(cache)
+        except OSError as err:
+            warnings.warn(f'Unable to use the cache: {err}',
+                          RuntimeWarning,
+                          stacklevel=2)
+            return self.load(num_threads)
+        try:
+            return shared_memory.attach(key, cache)
+        except FileNotFoundError:
+            pass
+        except (OSError, ValueError, EOFError, pickle.UnpicklingError,
+                struct.error) as err:
+            warnings.warn(f'Invalid cached tidal model {key!r}: {err}',
+                          RuntimeWarning,
+                          stacklevel=2)
+        model = self.load(num_threads)
+        try:
+            shared_memory.publish(model, key, cache)
+        except OSError as err:
+            warnings.warn(f'Unable to cache the tidal model: {err}',
+                          RuntimeWarning,
+                          stacklevel=2)
+        return model
+
+    @staticmethod
+    def _selected(names: Iterable[str],
+                  selection: Iterable[str]) -> list[str]:
+        """Return the names of the constituents that are selected."""
+        selected = set(map(constituents.parse, selection))
+        return [item for item in names if constituents.parse(item) in selected]
+
 
 @dataclasses.dataclass(frozen=True)
 class Cartesian(Common):
@@ -316,6 +457,8 @@ class Cartesian(Common):
     phase: str = 'phase'
     #: The tolerance used to determine if the longitude axis is circular.
     epsilon: float = 1e-6
+    #: Max distance allowed to extrapolate.
+    max_distance: float = 0.0
 
     def __post_init__(self) -> None:
         super().__post_init__()
@@ -331,8 +474,55 @@ class Cartesian(Common):
         if not self.phase:
             raise ValueError('phase cannot be empty.')
 
-    def load(self) -> TidalModel:
-        """Load the tidal model defined by the configuration."""
+    def select(self, selection: Iterable[str]) -> Cartesian:
+        """Restrict the configuration to a subset of the constituents.
+
+        The files of the constituents that are not selected are not read when
+        loading the model.
+
+        Args:
+            selection: The names of the constituents to keep.
+
+        Returns:
+            The restricted configuration.
+        """
+        names = self._selected(self.paths, selection)
+        if not names:
+            raise ValueError('None of the selected constituents is defined '
+                             'by the model.')
+        return dataclasses.replace(
+            self, paths={item: self.paths[item] for item in names})
+
+    def files(self) -> list[str]:
+        """Return the paths of the files read to build the model."""
+        return list(self.paths.values())
+
+    def load(self, num_threads: int = 0) -> TidalModel:
+        """Load the tidal model defined by the configuration.
+
+        The files of the constituents are read concurrently.
+
+        Args:
+            num_threads: The maximum number of threads reading the files. If
+                0, the number of threads is determined by the number of cores.
+
+        Returns:
+            The tidal model.
+        """
+        if self.native:
+            return netcdf.load_cartesian(
+                self.paths,
+                longitude=self.longitude,
+                latitude=self.latitude,
+                amplitude=self.amplitude,
+                phase=self.phase,
+                epsilon=self.epsilon,
+                max_distance=self.max_distance,
+                tide_type=TideType[self.tidal_type.upper()].value,
+                dynamic=self.dynamic_constituents,
+                bbox=self.bbox,
+                num_threads=num_threads,
+            )
 
         # Define a named tuple to hold the properties of the cartesian grid.
         class GridProperties(NamedTuple):
@@ -365,18 +555,14 @@ class Cartesian(Common):
 
         model: TidalModelInstance | None = None
 
-        # Loop over each constituent and its corresponding NetCDF file path.
-        for constituent, path in self.paths.items():
-            # Check that the NetCDF file exists.
+        # Check that the NetCDF files exist.
+        for path in self.paths.values():
             if not os.path.exists(path):
                 raise FileNotFoundError(f'File not found: {path!r}.')
 
-            lon: Vector
-            lat: Vector
-            wave: Matrix
-
-            # Load the tidal model for this constituent.
-            lon, lat, wave, longitude_major = load_cartesian_model(
+        def read(path: str) -> tuple[Vector, Vector, Matrix, bool]:
+            """Load the tidal model of a constituent."""
+            return load_cartesian_model(
                 path,
                 self.longitude,
                 self.latitude,
@@ -386,6 +572,17 @@ class Cartesian(Common):
                 self.bbox,
             )
 
+        lon: Vector
+        lat: Vector
+        wave: Matrix
+
+        # Loop over each constituent and its corresponding NetCDF file path.
+        # The files are read concurrently, the constituents being added to the
+        # model in the order of the configuration.
+        for (constituent, path), (lon, lat, wave, longitude_major) in zip(
+                self.paths.items(),
+                _map(read, list(self.paths.values()), num_threads)):
+
             if wave.ndim != WAVE_DIMENSIONS:
                 raise ValueError(f'defined constituent {constituent!r} has '
                                  f'invalid shape: {wave.shape!r}.')
@@ -409,6 +606,7 @@ class Cartesian(Common):
                     Axis(lat),
                     tide_type=TideType[self.tidal_type.upper()].value,
                     longitude_major=longitude_major,
+                    max_distance=self.max_distance,
                 )
 
                 # Memorize the properties of the grid.
@@ -446,6 +644,47 @@ class Cartesian(Common):
         return model.instance
 
 
+def _renumber_mesh(
+    lon: Vector,
+    lat: Vector,
+    triangles: Matrix,
+    codes: Matrix,
+) -> tuple[Vector, Vector, Matrix, Matrix, Vector]:
+    """Renumber a mesh to store the items close in space close in memory.
+
+    The triangles are sorted along a Hilbert curve, then the vertices and the
+    LGP codes are numbered in the order in which the triangles use them.
+
+    Args:
+        lon: The longitude coordinates of the mesh vertices.
+        lat: The latitude coordinates of the mesh vertices.
+        triangles: The mesh triangles.
+        codes: The LGP codes of the triangles.
+
+    Returns:
+        The renumbered vertices, triangles and codes, and the original LGP
+        code stored at each new position.
+    """
+    triangles = numpy.asarray(triangles, dtype=numpy.int32)
+    codes = numpy.asarray(codes, dtype=numpy.int32)
+    order = mesh.hilbert_order(lon, lat, triangles)
+    vertex_order = mesh.first_touch_order(triangles, order, len(lon))
+    code_order = mesh.first_touch_order(codes, order, int(codes.max()) + 1)
+
+    vertex_position = numpy.empty_like(vertex_order)
+    vertex_position[vertex_order] = numpy.arange(len(vertex_order))
+    code_position = numpy.empty_like(code_order)
+    code_position[code_order] = numpy.arange(len(code_order))
+
+    return (
+        numpy.asarray(lon)[vertex_order],
+        numpy.asarray(lat)[vertex_order],
+        vertex_position[triangles[order]].astype(numpy.int32),
+        code_position[codes[order]].astype(numpy.int32),
+        code_order,
+    )
+
+
 @dataclasses.dataclass(frozen=True)
 class LGP(Common):
     """Configuration for the LGP model."""
@@ -454,14 +693,29 @@ class LGP(Common):
     amplitude: str = '{constituent}_amplitude'
     #: List of the tidal constituents to use.
     constituents: list[str] = dataclasses.field(default_factory=list)
+    #: Whether to precompute the vertices used to extrapolate the points
+    #: located around the mesh. Requires a positive ``max_distance``.
+    coastal_band: bool = False
     #: The name of the variable containing the LGP codes.
     codes: str = 'codes'
+    #: The structure used to locate the mesh triangles containing the
+    #: points. Allowed values are ``rtree`` and ``bucket_grid``.
+    index: str = 'rtree'
+    #: Whether to store the values of all the constituents of each LGP node
+    #: contiguously, to speed up the interpolation.
+    interleaved: bool = False
     #: Max distance allowed to extrapolate.
     max_distance: float = 0.0
     #: The path to the NetCDF file to use.
     path: str = ''
     #: The pattern of the variable containing the phases.
     phase: str = '{constituent}_phase'
+    #: Whether to precompute the reference transform of each triangle, to
+    #: speed up the interpolation at the cost of 48 bytes per triangle.
+    reference_transforms: bool = False
+    #: Whether to renumber the triangles along a Hilbert curve, and the
+    #: vertices and LGP codes in the order in which the triangles use them.
+    renumber: bool = False
     #: The name of the variable containing the vertices of the triangles.
     triangle: str = 'triangle'
     #: Type of LGP discretization to use. Allowed values are ``lgp1`` and
@@ -487,6 +741,8 @@ class LGP(Common):
             raise ValueError('phase cannot be empty.')
         if self.type not in tuple(item.name.lower() for item in LGPType):
             raise ValueError(f'Unknown LGP type: {self.type!r}.')
+        if self.index not in ('rtree', 'bucket_grid'):
+            raise ValueError(f'Unknown index type: {self.index!r}.')
         try:
             self.amplitude.format(constituent='M2')
         except KeyError as err:
@@ -498,6 +754,29 @@ class LGP(Common):
             raise ValueError(
                 f'Invalid phase pattern: {self.phase!r}.') from err
 
+    def select(self, selection: Iterable[str]) -> LGP:
+        """Restrict the configuration to a subset of the constituents.
+
+        The variables of the constituents that are not selected are not read
+        when loading the model.
+
+        Args:
+            selection: The names of the constituents to keep.
+
+        Returns:
+            The restricted configuration.
+        """
+        names = self._selected(self.constituents or constituents.known(),
+                               selection)
+        if not names:
+            raise ValueError('None of the selected constituents is defined '
+                             'by the model.')
+        return dataclasses.replace(self, constituents=names)
+
+    def files(self) -> list[str]:
+        """Return the paths of the files read to build the model."""
+        return [self.path]
+
     def _lgp_class(self, dtype: numpy.dtype) -> LGPModel:
         """Return the class of the LGP tidal model."""
         if self.type == LGPType.LGP1.name:
@@ -511,54 +790,129 @@ class LGP(Common):
             return tidal_model.LGP2Complex128
         raise ValueError(f'Unknown wave type: {dtype!r}.')
 
-    def load(self) -> TidalModel:
-        """Load the tidal model defined by the configuration."""
-        with netCDF4.Dataset(self.path, 'r') as ds:
-            lon: Vector = ds.variables[self.longitude][:]
-            lat: Vector = ds.variables[self.latitude][:]
-            triangles: Matrix = ds.variables[self.triangle][:]
-            codes: Matrix = ds.variables[self.codes][:]
+    def load(self, num_threads: int = 0) -> TidalModel:
+        """Load the tidal model defined by the configuration.
+
+        The mesh is read first, then the constituents are decoded
+        concurrently.
+
+        Args:
+            num_threads: The maximum number of threads decoding the
+                constituents. If 0, the number of threads is determined by the
+                number of cores.
+
+        Returns:
+            The tidal model.
+        """
+        if self.native:
+            return netcdf.load_lgp(
+                self.path,
+                self.constituents,
+                type=self.type,
+                longitude=self.longitude,
+                latitude=self.latitude,
+                triangle=self.triangle,
+                codes=self.codes,
+                amplitude=self.amplitude,
+                phase=self.phase,
+                index=(mesh.IndexType.kBucketGrid
+                       if self.index == 'bucket_grid' else
+                       mesh.IndexType.kRTree),
+                reference_transforms=self.reference_transforms,
+                coastal_band=self.coastal_band,
+                interleaved=self.interleaved,
+                renumber=self.renumber,
+                max_distance=self.max_distance,
+                tide_type=TideType[self.tidal_type.upper()].value,
+                dynamic=self.dynamic_constituents,
+                bbox=self.bbox,
+                num_threads=num_threads,
+            )
+        names: list[str] = self.constituents or constituents.known()
+        with NETCDF_LOCK:
+            ds = netCDF4.Dataset(self.path, 'r')
+        try:
+            with NETCDF_LOCK:
+                lon: Vector = ds.variables[self.longitude][:]
+                lat: Vector = ds.variables[self.latitude][:]
+                triangles: Matrix = ds.variables[self.triangle][:]
+                codes: Matrix = ds.variables[self.codes][:]
+
+                for item in names:
+                    amp_name: str = self.amplitude.format(constituent=item)
+                    if amp_name not in ds.variables:
+                        raise ValueError(f'Variable not found: {amp_name!r}.')
+                    pha_name: str = self.phase.format(constituent=item)
+                    if pha_name not in ds.variables:
+                        raise ValueError(f'Variable not found: {pha_name!r}.')
+                type_name: LGPModel = self._lgp_class(
+                    (ds.variables[self.amplitude.format(
+                        constituent=names[0])].dtype.type(0) + 1j).dtype)
 
-            instance: TidalModel | None = None
             selected_indices: Vector | None = None
-
-            for item in self.constituents or constituents.known():
-                amp_name: str = self.amplitude.format(constituent=item)
-                if amp_name not in ds.variables:
-                    raise ValueError(f'Variable not found: {amp_name!r}.')
-                pha_name: str = self.phase.format(constituent=item)
-                if pha_name not in ds.variables:
-                    raise ValueError(f'Variable not found: {pha_name!r}.')
-
-                if instance is None:
-                    type_name: LGPModel = self._lgp_class(
-                        (ds.variables[amp_name].dtype.type(0) + 1j).dtype)
-
-                    instance = type_name(
-                        mesh.Index(lon, lat, triangles),
-                        codes=codes,
-                        tide_type=TideType[self.tidal_type.upper()].value,
-                        max_distance=self.max_distance,
-                        bbox=self.bbox,
-                    )
-                    if self.bbox is not None:
-                        selected_indices = instance.selected_indices()
-
-                amp = numpy.ma.filled(ds.variables[amp_name][:], numpy.nan)
-                pha = numpy.ma.filled(ds.variables[pha_name][:], numpy.nan)
+            code_order: Vector | None = None
+
+            if self.renumber:
+                lon, lat, triangles, codes, code_order = _renumber_mesh(
+                    lon, lat, triangles, codes)
+
+            index = mesh.Index(
+                lon,
+                lat,
+                triangles,
+                type=(mesh.IndexType.kBucketGrid
+                      if self.index == 'bucket_grid' else
+                      mesh.IndexType.kRTree),
+            )
+            if self.reference_transforms:
+                index.build_reference_transforms()
+            if self.coastal_band and self.max_distance > 0:
+                index.build_coastal_band(self.max_distance)
+
+            instance: TidalModel = type_name(
+                index,
+                codes=codes,
+                tide_type=TideType[self.tidal_type.upper()].value,
+                max_distance=self.max_distance,
+                bbox=self.bbox,
+            )
+            if self.bbox is not None:
+                selected_indices = instance.selected_indices()
+            # The values of the LGP codes are read in the new order.
+            if code_order is not None:
+                selected_indices = (code_order if selected_indices is None
+                                    else code_order[selected_indices])
+
+            def read(item: str) -> Vector:
+                """Read and decode the wave of a constituent."""
+                amp_name = self.amplitude.format(constituent=item)
+                pha_name = self.phase.format(constituent=item)
+                with NETCDF_LOCK:
+                    amp = ds.variables[amp_name][:]
+                    pha = ds.variables[pha_name][:]
+                    units: str = ds.variables[pha_name].units
+                amp = numpy.ma.filled(amp, numpy.nan)
+                pha = numpy.ma.filled(pha, numpy.nan)
 
                 if selected_indices is not None:
                     amp = amp[selected_indices]
                     pha = pha[selected_indices]
 
-                if ds.variables[pha_name].units in ['degree', 'degrees']:
+                if units in ['degree', 'degrees']:
                     pha = numpy.radians(pha)
 
-                wave: Vector = amp * numpy.cos(pha) + 1j * amp * numpy.sin(pha)
-                del amp, pha
+                return amp * numpy.cos(pha) + 1j * amp * numpy.sin(pha)
 
+            # The constituents are decoded concurrently, and added to the
+            # model in the order of the configuration.
+            for item, wave in zip(names, _map(read, names, num_threads)):
                 instance.add_constituent(item, wave)
-        assert instance is not None, 'No tidal model loaded.'
+        finally:
+            with NETCDF_LOCK:
+                ds.close()
+
+        if self.interleaved:
+            instance.interleave()
 
         # Set the wave to be considered as part of this model, but not defined
         # as a Cartesian grid.
@@ -581,12 +935,12 @@ def parse(path: str | os.PathLike) -> dict[str, Any]:
         return _parse(yaml.load(stream, Loader=Loader))
 
 
-def _load_model(
+def _model_settings(
     settings: dict[str, Any],
     tidal_type: str,
     bbox: tuple[float, float, float, float] | None = None,
-) -> TidalModel:
-    """Load a configuration file into memory.
+) -> Cartesian | LGP:
+    """Get the configuration of a tidal model.
 
     Args:
         settings: A dictionary defining the YAML document.
@@ -596,7 +950,7 @@ def _load_model(
             max_lat). If not provided, the whole grid is loaded.
 
     Returns:
-        The tidal model loaded from the configuration file.
+        The configuration of the tidal model.
     """
 
     def tidal_type_exists(config: dict[str, Any], section: str) -> None:
@@ -607,20 +961,82 @@ def _load_model(
     if 'cartesian' in settings:
         tidal_type_exists(settings, 'cartesian')
         settings['cartesian'].update(tidal_type=tidal_type)
-        return Cartesian(bbox=bbox, **settings['cartesian']).load()
+        return Cartesian(bbox=bbox, **settings['cartesian'])
     if 'lgp' in settings:
         tidal_type_exists(settings, 'lgp')
         settings['lgp'].update(tidal_type=tidal_type)
-        return LGP(bbox=bbox, **settings['lgp']).load()
+        return LGP(bbox=bbox, **settings['lgp'])
 
     raise ValueError('No tidal model found. Expected either "cartesian" or '
                      '"lgp".')
 
 
+def _build_model(settings: Cartesian | LGP,
+                 cache: str | os.PathLike | None,
+                 num_threads: int = 0) -> TidalModel:
+    """Load a tidal model, through the cache if set."""
+    if cache is None:
+        return settings.load(num_threads)
+    return settings.load_cached(cache, num_threads)
+
+
+class LazyModels(Mapping[str, TidalModel]):
+    """Tidal models loaded on first access.
+
+    Each model is loaded, once, the first time it is retrieved. The models
+    never used by the processing are not read from disk.
+
+    Args:
+        settings: The configuration of each tidal model.
+        cache: The directory storing the models built, if any. It must only
+            be writable by the current user (see :py:func:`load`).
+        num_threads: The maximum number of threads reading the constituents
+            of a model.
+    """
+
+    def __init__(self,
+                 settings: dict[str, Cartesian | LGP],
+                 cache: str | os.PathLike | None = None,
+                 num_threads: int = 0) -> None:
+        self._settings = settings
+        self._cache = cache
+        self._num_threads = num_threads
+        self._models: dict[str, TidalModel] = {}
+        self._lock = threading.Lock()
+
+    def __getitem__(self, key: str) -> TidalModel:
+        with self._lock:
+            if key not in self._models:
+                self._models[key] = _build_model(self._settings[key],
+                                                 self._cache,
+                                                 self._num_threads)
+            return self._models[key]
+
+    def __iter__(self) -> Iterator[str]:
+        return iter(self._settings)
+
+    def __len__(self) -> int:
+        return len(self._settings)
+
+    def loaded(self) -> list[str]:
+        """Return the keys of the models already loaded."""
+        with self._lock:
+            return list(self._models)
+
+    def __reduce__(self) -> tuple[Any, ...]:
+        # The pickled object is a dictionary of all the models, loaded if
+        # necessary.
+        return (dict, (dict(self.items()), ))
+
+
 def load(
     path: str | os.PathLike,
     bbox: tuple[float, float, float, float] | None = None,
-) -> dict[str, TidalModel]:
+    constituents: Iterable[str] | None = None,
+    lazy: bool = False,
+    cache: str | os.PathLike | None = None,
+    num_threads: int = 0,
+) -> Mapping[str, TidalModel]:
     """Load a configuration file into memory.
 
     Args:
@@ -628,6 +1044,26 @@ def load(
         bbox: Bounding box to consider when loading the tidal model. It is
             represented as a tuple of four floats: (min_lon, min_lat, max_lon,
             max_lat). If not provided, the whole grid is loaded.
+        constituents: The names of the constituents to load. The other
+            constituents defined by the configuration file are not read. If
+            not provided, all the constituents are loaded.
+        lazy: If true, each tidal model is loaded the first time it is
+            retrieved from the returned mapping, instead of being loaded
+            immediately.
+        cache: The directory storing the models built. If set, a model is
+            stored in binary form the first time it is built, then mapped
+            from the cache by the following loads, as long as the settings
+            and the files read (path, size and modification time) are
+            unchanged. The models are unpickled from the cache, which can
+            execute arbitrary code: the directory and its files must be owned
+            by the current user and not writable by the other users,
+            otherwise the cache is ignored.
+        num_threads: The maximum number of threads used to load the models.
+            The sections of the configuration file are loaded concurrently,
+            and so are the constituents of each model, the threads being
+            shared out between the sections. If 0, the number of threads is
+            determined by the number of cores. If 1, the models are loaded
+            sequentially.
 
     Returns:
         A dictionary defining the configuration of the processing to be
@@ -635,7 +1071,7 @@ def load(
         The key is the type of the tidal model (e.g. ``tide``, ``radial``) and
         the value is the tidal model.
     """
-    models: dict[str, TidalModel] = {}
+    models: dict[str, Cartesian | LGP] = {}
     user_settings: dict[str, Any] = parse(path)
 
     if user_settings is None or len(user_settings) == 0:
@@ -647,7 +1083,7 @@ def load(
             raise ValueError(f'Configuration file {path!r} is invalid. '
                              f'Expected "tide" or "radial" section.')
         try:
-            models[key] = _load_model(settings, tidal_type=key, bbox=bbox)
+            models[key] = _model_settings(settings, tidal_type=key, bbox=bbox)
         except TypeError as err:
             if 'unexpected keyword argument' in str(err):
                 msg = str(err)
@@ -659,4 +1095,17 @@ def load(
                     f'Unknown keyword: {unknown_key!r} in section '
                     f'{section!r}.') from err
             raise err from None
-    return models
+        if constituents is not None:
+            models[key] = models[key].select(constituents)
+    if lazy:
+        return LazyModels(models, cache, num_threads)
+    # Each section loaded concurrently reads its constituents with its share
+    # of the threads, so that at most num_threads threads are used.
+    num_threads = num_threads or os.cpu_count() or 1
+    sections = max(1, min(num_threads, len(models)))
+    share = num_threads // sections
+    return dict(
+        zip(
+            models,
+            _map(lambda item: _build_model(item, cache, share),
+                 list(models.values()), sections)))
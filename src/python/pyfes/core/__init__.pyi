@@ -1,7 +1,7 @@
 from typing import ClassVar, Dict, Iterator, List, Optional, Tuple, overload
 import datetime
 
-from . import constituents, datemanip, mesh, tidal_model
+from . import constituents, datemanip, mesh, netcdf, tidal_model
 
 __all__ = [
     "AbstractTidalModelComplex64",
@@ -20,6 +20,7 @@ __all__ = [
     "datemanip",
     "evaluate_tide",
     "mesh",
+    "netcdf",
     "tidal_model",
 ]
 
@@ -354,6 +355,10 @@ class Axis:
     def is_circular(self) -> bool:
         ...
 
+    @property
+    def is_regular(self) -> bool:
+        ...
+
     @property
     def start(self) -> float:
         ...
@@ -1,9 +1,60 @@
-from ..type_hints import MatrixInt32, VectorFloat64
+from typing import ClassVar
+
+from ..type_hints import MatrixInt32, VectorFloat64, VectorInt64
+
+class IndexType:
+    __members__: ClassVar[dict] = ...  # read-only
+    kBucketGrid: ClassVar[IndexType] = ...
+    kRTree: ClassVar[IndexType] = ...
+
+    def __init__(self, value: int) -> None:
+        ...
+
+    def __eq__(self, other: object) -> bool:
+        ...
+
+    def __hash__(self) -> int:
+        ...
+
+    def __index__(self) -> int:
+        ...
+
+    def __int__(self) -> int:
+        ...
+
+    def __ne__(self, other: object) -> bool:
+        ...
+
+    @property
+    def name(self) -> str:
+        ...
+
+    @property
+    def value(self) -> int:
+        ...
+
+
+kBucketGrid: IndexType
+kRTree: IndexType
+
 
 class Index:
 
-    def __init__(self, lon: VectorFloat64, lat: VectorFloat64,
-                 triangles: MatrixInt32) -> None:
+    def __init__(self,
+                 lon: VectorFloat64,
+                 lat: VectorFloat64,
+                 triangles: MatrixInt32,
+                 type: IndexType = ...,
+                 resolution: float = 0.0) -> None:
+        ...
+
+    def __getstate__(self) -> bytes:
+        ...
+
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def lat(self) -> VectorFloat64:
@@ -14,3 +65,31 @@ class Index:
 
     def triangles(self) -> MatrixInt32:
         ...
+
+    def build_reference_transforms(self) -> None:
+        ...
+
+    def has_reference_transforms(self) -> bool:
+        ...
+
+    def build_coastal_band(self,
+                           max_distance: float,
+                           resolution: float = 0.0) -> None:
+        ...
+
+    def has_coastal_band(self) -> bool:
+        ...
+
+    @property
+    def type(self) -> IndexType:
+        ...
+
+
+def hilbert_order(lon: VectorFloat64, lat: VectorFloat64,
+                  triangles: MatrixInt32) -> VectorInt64:
+    ...
+
+
+def first_touch_order(table: MatrixInt32, rows: VectorInt64,
+                      size: int) -> VectorInt64:
+    ...
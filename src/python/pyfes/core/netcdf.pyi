@@ -0,0 +1,53 @@
+from typing import Union
+
+from . import Constituent, TideType, mesh
+from .tidal_model import (
+    CartesianComplex64,
+    CartesianComplex128,
+    LGP1Complex64,
+    LGP1Complex128,
+    LGP2Complex64,
+    LGP2Complex128,
+)
+
+available: bool
+
+
+def load_cartesian(
+    paths: dict[str, str],
+    longitude: str = 'lon',
+    latitude: str = 'lat',
+    amplitude: str = 'amplitude',
+    phase: str = 'phase',
+    epsilon: float = 1e-6,
+    max_distance: float = 0.0,
+    tide_type: TideType = ...,
+    dynamic: list[Constituent] = ...,
+    bbox: tuple[float, float, float, float] | None = None,
+    num_threads: int = 0,
+) -> Union[CartesianComplex64, CartesianComplex128]:
+    ...
+
+
+def load_lgp(
+    path: str,
+    constituents: list[str] = ...,
+    type: str = 'lgp1',
+    longitude: str = 'lon',
+    latitude: str = 'lat',
+    triangle: str = 'triangle',
+    codes: str = 'codes',
+    amplitude: str = '{constituent}_amplitude',
+    phase: str = '{constituent}_phase',
+    index: mesh.IndexType = ...,
+    reference_transforms: bool = False,
+    coastal_band: bool = False,
+    interleaved: bool = False,
+    renumber: bool = False,
+    max_distance: float = 0.0,
+    tide_type: TideType = ...,
+    dynamic: list[Constituent] = ...,
+    bbox: tuple[float, float, float, float] | None = None,
+    num_threads: int = 0,
+) -> Union[LGP1Complex64, LGP1Complex128, LGP2Complex64, LGP2Complex128]:
+    ...
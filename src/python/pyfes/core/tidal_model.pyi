@@ -1,11 +1,23 @@
+from typing import overload
+
 from . import (
     AbstractTidalModelComplex64,
     AbstractTidalModelComplex128,
     Axis,
+    Constituent,
     TideType,
     mesh,
 )
-from ..type_hints import MatrixInt32, VectorInt64
+from ..type_hints import (
+    MatrixComplex128,
+    MatrixFloat64,
+    MatrixInt32,
+    MatrixInt64,
+    VectorComplex128,
+    VectorFloat64,
+    VectorInt8,
+    VectorInt64,
+)
 
 class CartesianComplex128(AbstractTidalModelComplex128):
 
@@ -13,21 +25,35 @@ class CartesianComplex128(AbstractTidalModelComplex128):
                  lon: Axis,
                  lat: Axis,
                  tide_type: TideType = ...,
-                 longitude_major: bool = ...) -> None:
+                 longitude_major: bool = ...,
+                 max_distance: float = ...) -> None:
         ...
 
     def __getstate__(self) -> bytes:
         ...
 
-    def __setstate__(self, state: bytes) -> None:
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def lat(self) -> Axis:
         ...
 
+    @staticmethod
+    def load(path: str) -> CartesianComplex128:
+        ...
+
     def lon(self) -> Axis:
         ...
 
+    def max_distance(self) -> float:
+        ...
+
+    def save(self, path: str) -> None:
+        ...
+
 
 class CartesianComplex64(AbstractTidalModelComplex64):
 
@@ -36,21 +62,121 @@ class CartesianComplex64(AbstractTidalModelComplex64):
                  lat: Axis,
                  tide_type: TideType = ...,
                  longitude_major: bool = ...,
-                 bbox: tuple[float, float, float, float] | None = ...) -> None:
+                 max_distance: float = ...) -> None:
         ...
 
     def __getstate__(self) -> bytes:
         ...
 
-    def __setstate__(self, state: bytes) -> None:
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def lat(self) -> Axis:
         ...
 
+    @staticmethod
+    def load(path: str) -> CartesianComplex64:
+        ...
+
     def lon(self) -> Axis:
         ...
 
+    def max_distance(self) -> float:
+        ...
+
+    def save(self, path: str) -> None:
+        ...
+
+
+class CurvilinearComplex128(AbstractTidalModelComplex128):
+
+    def __init__(self,
+                 lon: MatrixFloat64,
+                 lat: MatrixFloat64,
+                 tide_type: TideType = ...,
+                 resolution: float = ...) -> None:
+        ...
+
+    def __getstate__(self) -> bytes:
+        ...
+
+    def __setstate__(self, state: bytes) -> None:
+        ...
+
+    def lat(self) -> MatrixFloat64:
+        ...
+
+    def lon(self) -> MatrixFloat64:
+        ...
+
+    def resolution(self) -> float:
+        ...
+
+
+class CurvilinearComplex64(AbstractTidalModelComplex64):
+
+    def __init__(self,
+                 lon: MatrixFloat64,
+                 lat: MatrixFloat64,
+                 tide_type: TideType = ...,
+                 resolution: float = ...) -> None:
+        ...
+
+    def __getstate__(self) -> bytes:
+        ...
+
+    def __setstate__(self, state: bytes) -> None:
+        ...
+
+    def lat(self) -> MatrixFloat64:
+        ...
+
+    def lon(self) -> MatrixFloat64:
+        ...
+
+    def resolution(self) -> float:
+        ...
+
+
+class InterpolationPlan:
+
+    @overload
+    def __init__(self,
+                 lon_axis: Axis,
+                 lat_axis: Axis,
+                 longitude_major: bool,
+                 lon: VectorFloat64,
+                 lat: VectorFloat64,
+                 num_threads: int = ...) -> None:
+        ...
+
+    @overload
+    def __init__(self,
+                 model: CartesianComplex128 | CartesianComplex64,
+                 lon: VectorFloat64,
+                 lat: VectorFloat64,
+                 num_threads: int = ...) -> None:
+        ...
+
+    def __len__(self) -> int:
+        ...
+
+    def apply(
+        self,
+        model: CartesianComplex128 | CartesianComplex64,
+        num_threads: int = ...,
+    ) -> tuple[dict[Constituent, VectorComplex128], VectorInt8]:
+        ...
+
+    def indices(self) -> MatrixInt64:
+        ...
+
+    def weights(self) -> MatrixFloat64:
+        ...
+
 
 class LGP1Complex128(AbstractTidalModelComplex128):
 
@@ -65,15 +191,42 @@ class LGP1Complex128(AbstractTidalModelComplex128):
     def __getstate__(self) -> bytes:
         ...
 
-    def __setstate__(self, state: bytes) -> None:
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def index(self) -> mesh.Index:
         ...
 
+    def interleave(self) -> None:
+        ...
+
+    def interleaved(self) -> bool:
+        ...
+
+    def interpolate_batch(
+        self,
+        lon: VectorFloat64,
+        lat: VectorFloat64,
+        num_threads: int = ...,
+    ) -> tuple[MatrixComplex128, VectorInt8]:
+        ...
+
+    @staticmethod
+    def load(path: str) -> LGP1Complex128:
+        ...
+
+    def save(self, path: str) -> None:
+        ...
+
     def selected_indices(self) -> VectorInt64:
         ...
 
+    def subset(self, bbox: tuple[float, float, float, float]) -> LGP1Complex128:
+        ...
+
 
 class LGP1Complex64(AbstractTidalModelComplex64):
 
@@ -88,15 +241,42 @@ class LGP1Complex64(AbstractTidalModelComplex64):
     def __getstate__(self) -> bytes:
         ...
 
-    def __setstate__(self, state: bytes) -> None:
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def index(self) -> mesh.Index:
         ...
 
+    def interleave(self) -> None:
+        ...
+
+    def interleaved(self) -> bool:
+        ...
+
+    def interpolate_batch(
+        self,
+        lon: VectorFloat64,
+        lat: VectorFloat64,
+        num_threads: int = ...,
+    ) -> tuple[MatrixComplex128, VectorInt8]:
+        ...
+
+    @staticmethod
+    def load(path: str) -> LGP1Complex64:
+        ...
+
+    def save(self, path: str) -> None:
+        ...
+
     def selected_indices(self) -> VectorInt64:
         ...
 
+    def subset(self, bbox: tuple[float, float, float, float]) -> LGP1Complex64:
+        ...
+
 
 class LGP2Complex128(AbstractTidalModelComplex128):
 
@@ -111,15 +291,42 @@ class LGP2Complex128(AbstractTidalModelComplex128):
     def __getstate__(self) -> bytes:
         ...
 
-    def __setstate__(self, state: bytes) -> None:
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def index(self) -> mesh.Index:
         ...
 
+    def interleave(self) -> None:
+        ...
+
+    def interleaved(self) -> bool:
+        ...
+
+    def interpolate_batch(
+        self,
+        lon: VectorFloat64,
+        lat: VectorFloat64,
+        num_threads: int = ...,
+    ) -> tuple[MatrixComplex128, VectorInt8]:
+        ...
+
+    @staticmethod
+    def load(path: str) -> LGP2Complex128:
+        ...
+
+    def save(self, path: str) -> None:
+        ...
+
     def selected_indices(self) -> VectorInt64:
         ...
 
+    def subset(self, bbox: tuple[float, float, float, float]) -> LGP2Complex128:
+        ...
+
 
 class LGP2Complex64(AbstractTidalModelComplex64):
 
@@ -134,11 +341,78 @@ class LGP2Complex64(AbstractTidalModelComplex64):
     def __getstate__(self) -> bytes:
         ...
 
-    def __setstate__(self, state: bytes) -> None:
+    def __reduce_ex__(self, protocol: int) -> tuple:
+        ...
+
+    def __setstate__(self, state: bytes | tuple) -> None:
         ...
 
     def index(self) -> mesh.Index:
         ...
 
+    def interleave(self) -> None:
+        ...
+
+    def interleaved(self) -> bool:
+        ...
+
+    def interpolate_batch(
+        self,
+        lon: VectorFloat64,
+        lat: VectorFloat64,
+        num_threads: int = ...,
+    ) -> tuple[MatrixComplex128, VectorInt8]:
+        ...
+
+    @staticmethod
+    def load(path: str) -> LGP2Complex64:
+        ...
+
+    def save(self, path: str) -> None:
+        ...
+
     def selected_indices(self) -> VectorInt64:
         ...
+
+    def subset(self, bbox: tuple[float, float, float, float]) -> LGP2Complex64:
+        ...
+
+
+class NestedCartesianComplex128(AbstractTidalModelComplex128):
+
+    def __init__(self,
+                 models: list[CartesianComplex128],
+                 resolution: float = ...) -> None:
+        ...
+
+    def __getstate__(self) -> bytes:
+        ...
+
+    def __setstate__(self, state: bytes) -> None:
+        ...
+
+    def grids(self) -> list[tuple[Axis, Axis]]:
+        ...
+
+    def resolution(self) -> float:
+        ...
+
+
+class NestedCartesianComplex64(AbstractTidalModelComplex64):
+
+    def __init__(self,
+                 models: list[CartesianComplex64],
+                 resolution: float = ...) -> None:
+        ...
+
+    def __getstate__(self) -> bytes:
+        ...
+
+    def __setstate__(self, state: bytes) -> None:
+        ...
+
+    def grids(self) -> list[tuple[Axis, Axis]]:
+        ...
+
+    def resolution(self) -> float:
+        ...
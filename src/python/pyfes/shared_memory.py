@@ -0,0 +1,238 @@
+# Copyright (c) 2025 CNES
+#
+# All rights reserved. Use of this source code is governed by a
+# BSD-style license that can be found in the LICENSE file.
+"""
+Publish the tidal models in shared memory.
+==========================================
+
+A model loaded once is published in a file stored in a memory file system
+(a directory of ``/dev/shm`` private to the current user by default), then
+attached by the other processes of the node.
+Attaching a model maps the file and rebuilds the model directly from the
+mapped memory, without reading the NetCDF files, decoding the waves or
+building the spatial index again. The large arrays of the attached model are
+not copied: they are read from the mapping, shared by all the processes of the
+node.
+
+Attaching a model unpickles the published file, which can execute arbitrary
+code: only the files owned by the current user, and not writable by the group
+or the other users, are attached.
+"""
+from __future__ import annotations
+
+from typing import TYPE_CHECKING, Any
+import mmap
+import os
+import pathlib
+import pickle
+import stat
+import struct
+import tempfile
+
+if TYPE_CHECKING:
+    from .config import TidalModel
+
+#: Memory file system storing the published models. By default, the models
+#: are stored in a subdirectory private to the current user.
+SHARED_MEMORY_DIRECTORY = '/dev/shm'
+
+#: Signature of the published models.
+MAGIC = b'PYFESSHM'
+
+#: Version of the layout of the published models.
+VERSION = 1
+
+#: Layout of the header: signature, version, size of the pickled state and
+#: number of out-of-band buffers.
+HEADER = struct.Struct('<8sIQQ')
+
+#: Layout of the position of a buffer: offset and size in bytes.
+BUFFER = struct.Struct('<QQ')
+
+#: Alignment of the buffers in the file.
+ALIGNMENT = 64
+
+
+def _check_trusted(path: str | os.PathLike,
+                   info: os.stat_result | None = None) -> None:
+    """Check that a file or directory can only be modified by the current
+    user.
+
+    Args:
+        path: The path to check.
+        info: The status of the path, if already known. Passing the status of
+            an open file checks the file actually read, even if the path is
+            replaced in the meantime.
+
+    Raises:
+        PermissionError: If the path is owned by another user, or writable by
+            the group or the other users.
+    """
+    if info is None:
+        info = os.stat(path)
+    if hasattr(os, 'getuid') and info.st_uid != os.getuid():
+        raise PermissionError(
+            f'{os.fspath(path)!r} is not owned by the current user')
+    if info.st_mode & (stat.S_IWGRP | stat.S_IWOTH):
+        raise PermissionError(
+            f'{os.fspath(path)!r} is writable by other users')
+
+
+def _default_directory() -> pathlib.Path:
+    """Return the directory storing the published models of the current
+    user."""
+    suffix = f'-{os.getuid()}' if hasattr(os, 'getuid') else ''
+    return pathlib.Path(SHARED_MEMORY_DIRECTORY) / f'pyfes{suffix}'
+
+
+def _path(name: str, directory: str | os.PathLike | None) -> pathlib.Path:
+    """Return the path of a published model."""
+    if not name or os.sep in name:
+        raise ValueError(f'Invalid name: {name!r}.')
+    return pathlib.Path(directory or _default_directory()) / name
+
+
+def _align(offset: int) -> int:
+    """Round an offset up to the alignment of the buffers."""
+    return (offset + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def publish(
+    model: TidalModel,
+    name: str,
+    directory: str | os.PathLike | None = None,
+) -> pathlib.Path:
+    """Publish a tidal model in shared memory.
+
+    The model is pickled with the protocol 5: its large arrays are written as
+    is, aligned, after the pickled state. The file is written under a
+    temporary name, then renamed, so that the processes never attach a
+    partially written model.
+
+    Args:
+        model: The tidal model to publish.
+        name: The name of the published model.
+        directory: The directory storing the published models. Defaults to
+            a subdirectory of :py:data:`SHARED_MEMORY_DIRECTORY` private to
+            the current user.
+
+    Returns:
+        The path of the file storing the model.
+
+    Raises:
+        PermissionError: If the default directory is owned by another user,
+            or writable by the group or the other users.
+    """
+    path = _path(name, directory)
+    if directory is None:
+        os.makedirs(path.parent, mode=0o700, exist_ok=True)
+        _check_trusted(path.parent)
+    buffers: list[pickle.PickleBuffer] = []
+    state = pickle.dumps(model, protocol=5, buffer_callback=buffers.append)
+    views = [item.raw() for item in buffers]
+
+    offset = _align(HEADER.size + BUFFER.size * len(views) + len(state))
+    table = []
+    for item in views:
+        table.append((offset, item.nbytes))
+        offset = _align(offset + item.nbytes)
+
+    fd, temporary = tempfile.mkstemp(dir=path.parent, prefix=f'.{name}.')
+    try:
+        with os.fdopen(fd, 'wb') as stream:
+            stream.write(
+                HEADER.pack(MAGIC, VERSION, len(state), len(views)))
+            for item in table:
+                stream.write(BUFFER.pack(*item))
+            stream.write(state)
+            for (start, _), item in zip(table, views):
+                stream.seek(start)
+                stream.write(item)
+            stream.truncate(offset)
+        os.replace(temporary, path)
+    except BaseException:
+        os.unlink(temporary)
+        raise
+    finally:
+        for item in views:
+            item.release()
+    return path
+
+
+def attach(
+    name: str,
+    directory: str | os.PathLike | None = None,
+) -> TidalModel:
+    """Attach a tidal model published in shared memory.
+
+    Args:
+        name: The name of the published model.
+        directory: The directory storing the published models. Defaults to
+            a subdirectory of :py:data:`SHARED_MEMORY_DIRECTORY` private to
+            the current user.
+
+    Returns:
+        The tidal model.
+
+    Raises:
+        PermissionError: If the published file is owned by another user, or
+            writable by the group or the other users. The file is not read.
+
+    .. note::
+
+        The large arrays of the model (the values of the waves, the LGP codes
+        and the arrays of the spatial index) are borrowed from the shared
+        memory, which stays mapped as long as the model is alive. The
+        published file must therefore not be rewritten in place; it can be
+        replaced with :py:func:`publish` or removed with :py:func:`unlink`.
+    """
+    path = _path(name, directory)
+    with open(path, 'rb') as stream:
+        _check_trusted(path, os.fstat(stream.fileno()))
+        mm = mmap.mmap(stream.fileno(), 0, access=mmap.ACCESS_READ)
+    view = memoryview(mm)
+    buffers: list[memoryview] = []
+    state: memoryview | None = None
+    try:
+        magic, version, size, count = HEADER.unpack_from(view)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f'{str(path)!r} is not a published model.')
+        start = HEADER.size + BUFFER.size * count
+        for ix in range(count):
+            offset, nbytes = BUFFER.unpack_from(
+                view, HEADER.size + BUFFER.size * ix)
+            buffers.append(view[offset:offset + nbytes])
+        state = view[start:start + size]
+        model: Any = pickle.loads(state, buffers=buffers)
+    finally:
+        for item in buffers:
+            try:
+                item.release()
+            except BufferError:
+                # The model borrows the buffer.
+                pass
+        if state is not None:
+            state.release()
+        view.release()
+    try:
+        mm.close()
+    except BufferError:
+        # The unpickled objects still reference the mapping, which is closed
+        # when they are destroyed.
+        pass
+    return model
+
+
+def unlink(name: str, directory: str | os.PathLike | None = None) -> None:
+    """Remove a tidal model published in shared memory.
+
+    The processes that attached the model are not affected.
+
+    Args:
+        name: The name of the published model.
+        directory: The directory storing the published models. Defaults to
+            a subdirectory of :py:data:`SHARED_MEMORY_DIRECTORY` private to
+            the current user.
+    """
+    _path(name, directory).unlink()
@@ -49,6 +49,11 @@
 
     A matrix of :py:class:`numpy.int32`.
 
+.. py:data:: MatrixInt64
+    :canonical: MatrixInt64
+
+    A matrix of :py:class:`numpy.int64`.
+
 .. py:data:: MatrixFloat64
     :canonical: MatrixFloat64
 
@@ -92,6 +97,7 @@ if TYPE_CHECKING:
     VectorComplex128 = Vector[numpy.complex128]
     VectorDateTime64 = Vector[numpy.datetime64]
     MatrixInt32 = Matrix[numpy.int32]
+    MatrixInt64 = Matrix[numpy.int64]
     MatrixFloat64 = Matrix[numpy.float64]
     MatrixComplex128 = Matrix[numpy.complex128]
     NDArrayStructured = numpy.ndarray[Any, numpy.dtype[numpy.void]]
@@ -112,6 +118,7 @@ else:
     VectorComplex128 = GenericAlias(numpy.ndarray, (Any, DType))
     VectorDateTime64 = GenericAlias(numpy.ndarray, (Any, DType))
     MatrixInt32 = GenericAlias(numpy.ndarray, (Any, DType))
+    MatrixInt64 = GenericAlias(numpy.ndarray, (Any, DType))
     MatrixFloat64 = GenericAlias(numpy.ndarray, (Any, DType))
     MatrixComplex128 = GenericAlias(numpy.ndarray, (Any, DType))
     NDArrayStructured = GenericAlias(numpy.ndarray,
@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 TEST(Axis, Constructor) {
   auto points =
       static_cast<Eigen::VectorXd>(Eigen::VectorXd::LinSpaced(360, 0.0, 359.0));
@@ -46,6 +48,10 @@ TEST(Axis, Constructor) {
 
   points = Eigen::VectorXd(10);
   points << 0, 3, 12, 15, 18, 21, 24, 27, 30, 33;
+  EXPECT_FALSE(fes::Axis(points).is_regular());
+
+  points = Eigen::VectorXd(10);
+  points << 0, 3, 12, 15, 18, 21, 24, 27, 30, 27;
   EXPECT_THROW({ auto axis = fes::Axis(points); }, std::invalid_argument);
 
   points = Eigen::VectorXd(1);
@@ -186,6 +192,68 @@ TEST(Axis, FindIndices) {
   EXPECT_EQ(*indexes, std::make_tuple(1, 0));
 }
 
+TEST(Axis, Irregular) {
+  // Mercator latitudes.
+  auto points = Eigen::VectorXd(61);
+  for (Eigen::Index ix = 0; ix < points.size(); ++ix) {
+    auto y = -1.5 + ix * 0.05;
+    points[ix] = fes::detail::math::degrees(std::atan(std::sinh(y)));
+  }
+  for (auto ascending : {true, false}) {
+    auto values = ascending ? points : points.reverse().eval();
+    auto axis = fes::Axis(values);
+    EXPECT_FALSE(axis.is_regular());
+    EXPECT_FALSE(axis.is_circular());
+    EXPECT_EQ(axis.is_ascending(), ascending);
+    EXPECT_EQ(axis.size(), 61);
+    EXPECT_EQ(axis(10), values[10]);
+    EXPECT_EQ(axis.min_value(), points[0]);
+    EXPECT_EQ(axis.max_value(), points[60]);
+
+    for (auto y = -64.5; y <= 64.5; y += 0.1) {
+      // Reference: brute force search of the closest value.
+      Eigen::Index expected;
+      (values.array() - y).abs().minCoeff(&expected);
+      auto index = axis.find_index(y);
+      ASSERT_NE(index, -1);
+      EXPECT_DOUBLE_EQ(std::abs(axis(index) - y),
+                       std::abs(values[expected] - y));
+
+      auto indexes = axis.find_indices(y);
+      ASSERT_TRUE(indexes.has_value());
+      auto y0 = axis(std::get<0>(*indexes));
+      auto y1 = axis(std::get<1>(*indexes));
+      EXPECT_LE(std::min(y0, y1), y);
+      EXPECT_GE(std::max(y0, y1), y);
+    }
+    EXPECT_FALSE(axis.find_indices(70).has_value());
+    EXPECT_EQ(axis.find_index(89), -1);
+    EXPECT_EQ(axis.find_index(89, true), ascending ? 60 : 0);
+
+    auto state = axis.getstate();
+    auto other =
+        fes::Axis::setstate(fes::string_view(state.data(), state.size()));
+    EXPECT_EQ(axis, other);
+    EXPECT_EQ(other.find_index(45), axis.find_index(45));
+  }
+
+  // Circular longitudes, refined between 0 and 10 degrees.
+  auto lon = Eigen::VectorXd(370);
+  lon << Eigen::VectorXd::LinSpaced(20, 0, 9.5),
+      Eigen::VectorXd::LinSpaced(350, 10, 359);
+  auto axis = fes::Axis(lon, 1e-6, true);
+  EXPECT_TRUE(axis.is_circular());
+  EXPECT_EQ(axis.find_index(5.25), 11);
+  EXPECT_EQ(axis.find_index(365.2), 10);
+  EXPECT_EQ(axis.find_index(-0.6), 369);
+  auto indexes = axis.find_indices(359.5);
+  ASSERT_TRUE(indexes.has_value());
+  EXPECT_EQ(*indexes, std::make_tuple(369, 0));
+  indexes = axis.find_indices(100.5);
+  ASSERT_TRUE(indexes.has_value());
+  EXPECT_EQ(*indexes, std::make_tuple(110, 111));
+}
+
 TEST(Axis, Serialization) {
   auto points =
       static_cast<Eigen::VectorXd>(Eigen::VectorXd::LinSpaced(360, 0.0, 359.0));
@@ -84,3 +84,34 @@ TEST(Triangle, ReferenceRightAngledDegradedCase) {
   EXPECT_NEAR(x, 0.18519769401644656, 1e-6);
   EXPECT_NEAR(y, 0.81480230598367187, 1e-6);
 }
+
+TEST(StaticTriangle, Interface) {
+  auto v1 = geometry::Point(0.004, 0.004);
+  auto v2 = geometry::Point(-0.273, 0.004);
+  auto v3 = geometry::Point(-0.11, -0.192);
+  auto triangle = geometry::Triangle(v1, v2, v3);
+  auto static_triangle = geometry::StaticTriangle(v1, v2, v3);
+  EXPECT_EQ(v1, static_triangle.v1());
+  EXPECT_EQ(v2, static_triangle.v2());
+  EXPECT_EQ(v3, static_triangle.v3());
+  EXPECT_EQ(static_triangle.is_vertex(v3), 2);
+  EXPECT_EQ(static_triangle.is_vertex({0, 0}), -1);
+  EXPECT_EQ(triangle, static_cast<geometry::Triangle>(static_triangle));
+
+  // The static triangle must locate the points exactly like the triangle.
+  for (auto lon = -0.3; lon <= 0.03; lon += 0.0075) {
+    for (auto lat = -0.2; lat <= 0.01; lat += 0.005) {
+      auto point = geometry::Point(lon, lat);
+      EXPECT_EQ(triangle.covered_by(point), static_triangle.covered_by(point));
+    }
+  }
+  EXPECT_TRUE(static_triangle.covered_by(v1));
+  EXPECT_TRUE(static_triangle.covered_by(v2));
+  EXPECT_TRUE(static_triangle.covered_by(v3));
+
+  double x = NAN;
+  double y = NAN;
+  std::tie(x, y) = static_triangle.reference_right_angled({0.001, 0.001});
+  EXPECT_NEAR(0.00453105, x, 1e-6);
+  EXPECT_NEAR(0.0153061, y, 1e-6);
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/bucket_grid.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace mesh = fes::mesh;
+
+TEST(BucketGrid, Candidates) {
+  // Two triangles forming the square [10, 12] x [40, 42], and a triangle
+  // crossing the antimeridian.
+  auto lon = Eigen::VectorXd(7);
+  auto lat = Eigen::VectorXd(7);
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>(3, 3);
+  lon << 10, 12, 12, 10, 179.5, -179.5, 179.5;
+  lat << 40, 40, 42, 42, -10, -10, -9;
+  triangles << 0, 1, 2, 0, 2, 3, 4, 5, 6;
+
+  auto grid = mesh::BucketGrid(lon, lat, triangles, 0.5);
+  EXPECT_DOUBLE_EQ(grid.resolution(), 0.5);
+  EXPECT_FALSE(grid.empty());
+
+  auto to_vector = [](const std::pair<const int32_t*, const int32_t*>& range) {
+    return std::vector<int32_t>(range.first, range.second);
+  };
+  EXPECT_EQ(to_vector(grid.candidates(11, 41)), (std::vector<int32_t>{0, 1}));
+  EXPECT_EQ(to_vector(grid.candidates(-349, 41)),
+            (std::vector<int32_t>{0, 1}));
+  EXPECT_TRUE(to_vector(grid.candidates(20, 41)).empty());
+  EXPECT_EQ(to_vector(grid.candidates(179.9, -9.9)),
+            (std::vector<int32_t>{2}));
+  EXPECT_EQ(to_vector(grid.candidates(-179.9, -9.9)),
+            (std::vector<int32_t>{2}));
+  EXPECT_TRUE(to_vector(grid.candidates(0, -9.9)).empty());
+  // Rows outside the mesh have no bucket.
+  EXPECT_TRUE(to_vector(grid.candidates(11, 60)).empty());
+  EXPECT_TRUE(to_vector(grid.candidates(NAN, 41)).empty());
+
+  // The buckets are wider at high latitudes.
+  auto high = mesh::BucketGrid(lon, lat.array() + 40, triangles, 0.5);
+  EXPECT_LT(high.size(), grid.size());
+
+  // The resolution is coarsened to limit the number of buckets.
+  auto coarse = mesh::BucketGrid(lon, lat, triangles, 1e-3);
+  EXPECT_GT(coarse.resolution(), 1e-3);
+  EXPECT_LE(coarse.size(), int64_t{mesh::BucketGrid::kMinBuckets});
+  EXPECT_EQ(to_vector(coarse.candidates(11, 41)),
+            (std::vector<int32_t>{0, 1}));
+
+  EXPECT_THROW(mesh::BucketGrid(lon, lat, triangles, -1),
+               std::invalid_argument);
+}
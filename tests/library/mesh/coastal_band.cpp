@@ -0,0 +1,147 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/coastal_band.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "fes/geometry/ecef.hpp"
+#include "fes/mesh/index.hpp"
+
+namespace mesh = fes::mesh;
+
+// Regular mesh of nx by ny cells of 0.1 degree, each cell being split into
+// two triangles.
+static auto make_mesh(const int nx, const int ny)
+    -> std::tuple<Eigen::VectorXd, Eigen::VectorXd,
+                  Eigen::Matrix<int32_t, -1, 3>> {
+  auto lon = Eigen::VectorXd((nx + 1) * (ny + 1));
+  auto lat = Eigen::VectorXd((nx + 1) * (ny + 1));
+  for (auto jx = 0; jx <= ny; ++jx) {
+    for (auto ix = 0; ix <= nx; ++ix) {
+      lon(jx * (nx + 1) + ix) = ix * 0.1;
+      lat(jx * (nx + 1) + ix) = 40 + jx * 0.1;
+    }
+  }
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>(2 * nx * ny, 3);
+  for (auto jx = 0; jx < ny; ++jx) {
+    for (auto ix = 0; ix < nx; ++ix) {
+      const auto item = 2 * (jx * nx + ix);
+      const auto v0 = jx * (nx + 1) + ix;
+      triangles.row(item) << v0, v0 + 1, v0 + nx + 2;
+      triangles.row(item + 1) << v0, v0 + nx + 2, v0 + nx + 1;
+    }
+  }
+  return std::make_tuple(lon, lat, triangles);
+}
+
+TEST(CoastalBand, Search) {
+  constexpr auto kMaxDistance = 30'000.0;
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>();
+  std::tie(lon, lat, triangles) = make_mesh(20, 20);
+
+  auto reference = mesh::Index(lon, lat, triangles);
+  auto index = mesh::Index(lon, lat, triangles);
+  EXPECT_TRUE(index.coastal_band().empty());
+  index.build_coastal_band(kMaxDistance);
+  const auto& band = index.coastal_band();
+  EXPECT_FALSE(band.empty());
+  EXPECT_EQ(band.max_distance(), kMaxDistance);
+  EXPECT_GT(band.resolution(), 0);
+
+  auto generator = std::mt19937(0);
+  auto x = std::uniform_real_distribution<double>(-0.6, 2.6);
+  auto y = std::uniform_real_distribution<double>(39.4, 42.6);
+  auto neighbors = mesh::PackedRTree::Neighbors{};
+  auto covered = 0;
+  for (auto trial = 0; trial < 2000; ++trial) {
+    const auto point = fes::geometry::Point(x(generator), y(generator));
+    const auto ecef =
+        static_cast<fes::geometry::EarthCenteredEarthFixed>(point);
+    if (band.nearest(point.lon(), point.lat(),
+                     Eigen::Vector3d(ecef.x(), ecef.y(), ecef.z()),
+                     mesh::Index::kExtrapolationNeighbors, neighbors)) {
+      ++covered;
+    }
+
+    // The band does not change the vertices used to extrapolate, whatever
+    // the maximum distance.
+    for (auto max_distance : {10'000.0, kMaxDistance, 60'000.0}) {
+      const auto query = index.search(point, max_distance);
+      const auto expected = reference.search(point, max_distance);
+      ASSERT_EQ(query.index, expected.index);
+      ASSERT_EQ(query.nearest_vertices.size(),
+                expected.nearest_vertices.size());
+      for (size_t ix = 0; ix < query.nearest_vertices.size(); ++ix) {
+        EXPECT_EQ(query.nearest_vertices[ix].vertex_id,
+                  expected.nearest_vertices[ix].vertex_id);
+        EXPECT_EQ(query.nearest_vertices[ix].triangle_index,
+                  expected.nearest_vertices[ix].triangle_index);
+      }
+    }
+  }
+  EXPECT_GT(covered, 1000);
+
+  // Outside the band, the vertices are searched in the R-Tree.
+  const auto ecef = static_cast<fes::geometry::EarthCenteredEarthFixed>(
+      fes::geometry::Point(10, 41));
+  EXPECT_FALSE(band.nearest(10, 41,
+                            Eigen::Vector3d(ecef.x(), ecef.y(), ecef.z()),
+                            mesh::Index::kExtrapolationNeighbors, neighbors));
+
+  EXPECT_THROW(index.build_coastal_band(0), std::invalid_argument);
+  EXPECT_THROW(index.build_coastal_band(kMaxDistance, -1),
+               std::invalid_argument);
+  // The size of the band is bounded.
+  EXPECT_THROW(index.build_coastal_band(kMaxDistance, 1e-4),
+               std::invalid_argument);
+}
+
+TEST(CoastalBand, Serialize) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>();
+  std::tie(lon, lat, triangles) = make_mesh(10, 10);
+
+  auto index = mesh::Index(lon, lat, triangles);
+  index.build_coastal_band(20'000, 0.05);
+  const auto& band = index.coastal_band();
+  EXPECT_EQ(band.resolution(), 0.05);
+
+  auto state = band.getstate();
+  auto other =
+      mesh::CoastalBand::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.size(), band.size());
+  EXPECT_EQ(other.max_distance(), band.max_distance());
+  EXPECT_EQ(other.resolution(), band.resolution());
+  EXPECT_EQ(other.getstate(), state);
+  auto expected = mesh::PackedRTree::Neighbors{};
+  auto neighbors = mesh::PackedRTree::Neighbors{};
+  for (auto x = -0.3; x <= 1.3; x += 0.05) {
+    const auto ecef = static_cast<fes::geometry::EarthCenteredEarthFixed>(
+        fes::geometry::Point(x, 39.9));
+    const auto point = Eigen::Vector3d(ecef.x(), ecef.y(), ecef.z());
+    ASSERT_EQ(other.nearest(x, 39.9, point, 10, neighbors),
+              band.nearest(x, 39.9, point, 10, expected));
+    EXPECT_TRUE(std::equal(neighbors.begin(), neighbors.end(),
+                           expected.begin(), expected.end()));
+  }
+
+  // The band is kept by the serialization of the index.
+  auto index_state = index.getstate();
+  auto other_index = mesh::Index::setstate(
+      fes::string_view(index_state.data(), index_state.size()));
+  EXPECT_EQ(other_index.coastal_band().getstate(), state);
+
+  EXPECT_THROW(mesh::CoastalBand::setstate(
+                   fes::string_view(state.data(), state.size() / 2)),
+               std::invalid_argument);
+}
@@ -6,6 +6,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
 namespace mesh = fes::mesh;
 
 static auto make_data()
@@ -106,4 +110,349 @@ TEST(Index, Serialize) {
   query = index.search({-0.4057, 0.0717}, 50'000);
   EXPECT_TRUE(query.is_inside());
   EXPECT_EQ(query.index, 10);
+
+  // The search structures are restored without being rebuilt.
+  EXPECT_EQ(other.getstate(), state);
+  EXPECT_EQ(other.neighbors(), index.neighbors());
+  query = other.search({-0.16067459068705148, 0.09857747238454806}, 50'000);
+  EXPECT_TRUE(query.is_inside());
+  EXPECT_EQ(query.index, 5);
+  query = other.search({-0.4057, 0.0717}, 50'000);
+  EXPECT_TRUE(query.is_inside());
+  EXPECT_EQ(query.index, 10);
+  EXPECT_EQ(other.selected_triangles(fes::geometry::Box({-1, -1}, {1, 1})),
+            index.selected_triangles(fes::geometry::Box({-1, -1}, {1, 1})));
+
+  index = mesh::Index(lon, lat, triangles, mesh::kBucketGrid);
+  state = index.getstate();
+  other = mesh::Index::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.type(), mesh::kBucketGrid);
+  EXPECT_EQ(other.bucket_grid().size(), index.bucket_grid().size());
+  EXPECT_EQ(other.getstate(), state);
+  query = other.search({-0.4057, 0.0717}, 50'000);
+  EXPECT_TRUE(query.is_inside());
+  EXPECT_EQ(query.index, 10);
+
+  // The state can be streamed.
+  auto ss = std::stringstream();
+  index.getstate(ss);
+  EXPECT_EQ(ss.str(), state);
+  other = mesh::Index::setstate(ss);
+  EXPECT_EQ(other.getstate(), state);
+  auto truncated = std::stringstream(state.substr(0, state.size() - 8));
+  EXPECT_THROW(mesh::Index::setstate(truncated), std::invalid_argument);
+}
+
+TEST(Index, SetStateOutOfRange) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  const auto index = mesh::Index(lon, lat, triangles, mesh::kBucketGrid);
+  const auto state = index.getstate();
+  // Restores the index from its state, with one item replaced.
+  auto setstate = [&state](const size_t offset, const auto value) {
+    auto data = state;
+    std::memcpy(&data[offset], &value, sizeof(value));
+    return mesh::Index::setstate(fes::string_view(data.data(), data.size()));
+  };
+
+  // Position of the first values of the arrays in the state.
+  const auto shape = 2 * sizeof(Eigen::Index);
+  const auto triangles_offset = 2 * (shape + 19 * sizeof(double)) + shape;
+  const auto neighbors_offset =
+      triangles_offset + 72 * sizeof(int32_t) + sizeof(mesh::IndexType) + shape;
+  const auto vertex_offsets_offset = neighbors_offset + 72 * sizeof(int32_t) +
+                                     shape + 57 * sizeof(double) + shape;
+  // The last triangle listed by the grid of buckets, which is followed by the
+  // state of the empty coastal band.
+  const auto bucket_offset = state.size() - sizeof(int32_t) - sizeof(size_t) -
+                             index.coastal_band().getstate().size();
+
+  EXPECT_NO_THROW(setstate(triangles_offset, int32_t{18}));
+  EXPECT_THROW(setstate(triangles_offset, int32_t{19}), std::invalid_argument);
+  EXPECT_THROW(setstate(triangles_offset, int32_t{-1}), std::invalid_argument);
+  EXPECT_NO_THROW(setstate(neighbors_offset, int32_t{-1}));
+  EXPECT_THROW(setstate(neighbors_offset, int32_t{24}), std::invalid_argument);
+  EXPECT_THROW(setstate(neighbors_offset, int32_t{-2}), std::invalid_argument);
+  EXPECT_NO_THROW(setstate(vertex_offsets_offset, int64_t{0}));
+  EXPECT_THROW(setstate(vertex_offsets_offset, int64_t{1}),
+               std::invalid_argument);
+  EXPECT_THROW(setstate(vertex_offsets_offset + sizeof(int64_t), int64_t{80}),
+               std::invalid_argument);
+  EXPECT_NO_THROW(setstate(bucket_offset, int32_t{23}));
+  EXPECT_THROW(setstate(bucket_offset, int32_t{24}), std::invalid_argument);
+}
+
+TEST(Index, SearchInPlace) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  auto index = mesh::Index(lon, lat, triangles);
+  auto result = mesh::TriangleQueryResult{};
+
+  // The same result structure is reused for all the queries.
+  index.search({-0.4057, 0.0717}, 50'000, result);
+  EXPECT_TRUE(result.is_inside());
+  EXPECT_EQ(result.index, 10);
+  EXPECT_TRUE(result.nearest_vertices.empty());
+  EXPECT_TRUE(result.triangle.covered_by(result.point));
+
+  // Point outside the mesh, but close enough to extrapolate.
+  index.search({0.7, 0.0}, 50'000, result);
+  EXPECT_FALSE(result.is_inside());
+  EXPECT_TRUE(result.is_valid());
+  auto expected = index.search({0.7, 0.0}, 50'000);
+  ASSERT_EQ(result.nearest_vertices.size(), expected.nearest_vertices.size());
+  for (size_t ix = 0; ix < expected.nearest_vertices.size(); ++ix) {
+    EXPECT_EQ(result.nearest_vertices[ix].triangle_index,
+              expected.nearest_vertices[ix].triangle_index);
+    EXPECT_EQ(result.nearest_vertices[ix].vertex_id,
+              expected.nearest_vertices[ix].vertex_id);
+  }
+
+  // Point too far from the mesh: the previous vertices are discarded.
+  index.search({10, 10}, 50'000, result);
+  EXPECT_FALSE(result.is_valid());
+  EXPECT_TRUE(result.nearest_vertices.empty());
+
+  index.search({-0.16067459068705148, 0.09857747238454806}, 50'000, result);
+  EXPECT_TRUE(result.is_inside());
+  EXPECT_EQ(result.index, 5);
+}
+
+TEST(Index, Walk) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  auto index = mesh::Index(lon, lat, triangles);
+
+  // Triangle 0 (0, 2, 3) shares the edge (2, 3) with triangle 12, the edge
+  // (3, 0) with triangle 1 and the edge (0, 2) with triangle 5.
+  const auto& neighbors = index.neighbors();
+  EXPECT_EQ(neighbors(0, 0), 12);
+  EXPECT_EQ(neighbors(0, 1), 1);
+  EXPECT_EQ(neighbors(0, 2), 5);
+  // The edge (8, 9) of triangle 11 lies on the boundary of the mesh.
+  EXPECT_EQ(neighbors(11, 0), -1);
+  for (Eigen::Index ix = 0; ix < neighbors.rows(); ++ix) {
+    for (Eigen::Index jx = 0; jx < 3; ++jx) {
+      auto neighbor = neighbors(ix, jx);
+      if (neighbor != -1) {
+        EXPECT_TRUE((neighbors.row(neighbor).array() == ix).any());
+      }
+    }
+  }
+
+  // The walk locates the points inside the mesh like the R*Tree, whatever the
+  // starting triangle.
+  auto result = mesh::TriangleQueryResult{};
+  for (auto x = -0.45; x <= 0.55; x += 0.05) {
+    for (auto y = -0.3; y <= 0.4; y += 0.05) {
+      auto point = fes::geometry::Point(x, y);
+      auto expected = index.search(point, 0);
+      if (!expected.is_inside()) {
+        EXPECT_FALSE(index.walk(point, 0, result));
+        continue;
+      }
+      for (int32_t start = 0; start < 24; start += 5) {
+        if (index.walk(point, start, result)) {
+          EXPECT_TRUE(result.is_inside());
+          EXPECT_TRUE(result.triangle.covered_by(point));
+          EXPECT_EQ(result.point, point);
+        }
+      }
+      // The walk starting from the triangle containing the point or from a
+      // neighbor always succeeds.
+      ASSERT_TRUE(index.walk(point, expected.index, result));
+      EXPECT_EQ(result.index, expected.index);
+      auto neighbor = neighbors(expected.index, 0) != -1
+                          ? neighbors(expected.index, 0)
+                          : neighbors(expected.index, 1);
+      EXPECT_TRUE(index.walk(point, neighbor, result));
+    }
+  }
+}
+
+TEST(Index, BucketGrid) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  auto rtree = mesh::Index(lon, lat, triangles);
+  auto index = mesh::Index(lon, lat, triangles, mesh::kBucketGrid);
+  EXPECT_EQ(rtree.type(), mesh::kRTree);
+  EXPECT_TRUE(rtree.bucket_grid().empty());
+  EXPECT_EQ(index.type(), mesh::kBucketGrid);
+  EXPECT_FALSE(index.bucket_grid().empty());
+
+  // Both indexes locate the points in triangles covering them, and
+  // extrapolate the points outside the mesh in the same way.
+  for (auto x = -0.6; x <= 0.7; x += 0.05) {
+    for (auto y = -0.5; y <= 0.6; y += 0.05) {
+      auto point = fes::geometry::Point(x, y);
+      auto expected = rtree.search(point, 50'000);
+      auto query = index.search(point, 50'000);
+      ASSERT_EQ(query.is_inside(), expected.is_inside());
+      EXPECT_EQ(query.nearest_vertices.size(),
+                expected.nearest_vertices.size());
+      if (query.is_inside()) {
+        EXPECT_TRUE(query.triangle.covered_by(point));
+      }
+    }
+  }
+
+  auto state = index.getstate();
+  auto other =
+      mesh::Index::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.type(), mesh::kBucketGrid);
+  EXPECT_EQ(other.bucket_grid().resolution(),
+            index.bucket_grid().resolution());
+  EXPECT_EQ(other.bucket_grid().size(), index.bucket_grid().size());
+  auto query = other.search({-0.4057, 0.0717}, 50'000);
+  EXPECT_TRUE(query.is_inside());
+  EXPECT_EQ(query.index, 10);
+}
+
+TEST(Index, SelectedTriangles) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  auto index = mesh::Index(lon, lat, triangles);
+
+  // Reference selection: exact test on all the triangles.
+  auto brute_force = [&](const fes::geometry::Box& bbox) {
+    auto result = std::vector<int64_t>{};
+    for (int64_t ix = 0; ix < triangles.rows(); ++ix) {
+      auto triangle = fes::geometry::Triangle(
+          {lon(triangles(ix, 0)), lat(triangles(ix, 0))},
+          {lon(triangles(ix, 1)), lat(triangles(ix, 1))},
+          {lon(triangles(ix, 2)), lat(triangles(ix, 2))});
+      if (bbox.intersects(triangle)) {
+        result.push_back(ix);
+      }
+    }
+    return result;
+  };
+
+  for (auto x = -0.5; x <= 0.6; x += 0.1) {
+    for (auto y = -0.4; y <= 0.4; y += 0.1) {
+      for (auto size : {0.01, 0.1, 0.3}) {
+        auto bbox = fes::geometry::Box({x, y}, {x + size, y + size});
+        auto expected = brute_force(bbox);
+        if (expected.empty()) {
+          EXPECT_THROW(index.selected_triangles(bbox), std::invalid_argument);
+        } else {
+          EXPECT_EQ(index.selected_triangles(bbox), expected);
+        }
+      }
+    }
+  }
+
+  // A small box inside triangle 5, without any vertex.
+  auto bbox = fes::geometry::Box({-0.15, 0.09}, {-0.14, 0.1});
+  EXPECT_EQ(index.selected_triangles(bbox), std::vector<int64_t>{5});
+
+  // A box far from the mesh.
+  EXPECT_THROW(index.selected_triangles(fes::geometry::Box({10, 10}, {11, 11})),
+               std::invalid_argument);
+}
+
+TEST(Index, IncidentTriangles) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  auto index = mesh::Index(lon, lat, triangles);
+  auto to_vector = [](const std::pair<const int32_t*, const int32_t*>& range) {
+    return std::vector<int32_t>(range.first, range.second);
+  };
+  // The central vertex is shared by the first six triangles.
+  EXPECT_EQ(to_vector(index.incident_triangles(0)),
+            (std::vector<int32_t>{0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(to_vector(index.incident_triangles(8)),
+            (std::vector<int32_t>{10, 11}));
+  EXPECT_EQ(to_vector(index.incident_triangles(13)),
+            (std::vector<int32_t>{22, 23}));
+
+  // Each corner of each triangle is listed once.
+  auto count = int64_t(0);
+  for (int32_t ix = 0; ix < static_cast<int32_t>(index.n_positions()); ++ix) {
+    for (auto item : to_vector(index.incident_triangles(ix))) {
+      EXPECT_TRUE((triangles.row(item).array() == ix).any());
+      ++count;
+    }
+  }
+  EXPECT_EQ(count, triangles.size());
+}
+
+TEST(Index, ReferenceTransforms) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles) = make_data();
+
+  auto index = mesh::Index(lon, lat, triangles);
+  EXPECT_FALSE(index.has_reference_transforms());
+  index.build_reference_transforms();
+  EXPECT_TRUE(index.has_reference_transforms());
+
+  // Same results as the computation from the vertices of the triangles.
+  for (auto x = -0.5; x <= 0.6; x += 0.01) {
+    for (auto y = -0.42; y <= 0.45; y += 0.01) {
+      const auto point = fes::geometry::Point(x, y);
+      const auto query = index.search(point, 0);
+      if (!query.is_inside()) {
+        continue;
+      }
+      EXPECT_TRUE(index.covered_by(query.index, point));
+      double xi;
+      double eta;
+      double expected_xi;
+      double expected_eta;
+      std::tie(xi, eta) = index.reference_right_angled(query.index, point);
+      std::tie(expected_xi, expected_eta) =
+          query.triangle.reference_right_angled(point);
+      EXPECT_NEAR(xi, expected_xi, 1e-12);
+      EXPECT_NEAR(eta, expected_eta, 1e-12);
+    }
+  }
+  EXPECT_FALSE(index.covered_by(5, {0.3, -0.3}));
+
+  // The transforms are kept by the serialization.
+  auto state = index.getstate();
+  auto other =
+      mesh::Index::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_TRUE(other.has_reference_transforms());
+  EXPECT_EQ(other.getstate(), state);
+
+  // Triangle crossing the antimeridian, and a degenerate triangle.
+  lon.resize(5);
+  lat.resize(5);
+  triangles.resize(2, 3);
+  lon << 179.5, -179.5, 179.5, 10, 11;
+  lat << 0, 0, 1, 5, 5;
+  triangles << 0, 1, 2,  //
+      3, 4, 3;
+  index = mesh::Index(lon, lat, triangles);
+  index.build_reference_transforms();
+  EXPECT_TRUE(index.covered_by(0, {179.75, 0.25}));
+  EXPECT_TRUE(index.covered_by(0, {-539.75, 0.25}));
+  EXPECT_FALSE(index.covered_by(0, {179.9, 0.9}));
+  auto xy = index.reference_right_angled(0, {-179.75, 0.25});
+  EXPECT_NEAR(std::get<0>(xy), 0.75, 1e-12);
+  EXPECT_NEAR(std::get<1>(xy), 0.25, 1e-12);
+  EXPECT_FALSE(index.covered_by(1, {10.5, 5}));
+  xy = index.reference_right_angled(1, {10.5, 5});
+  EXPECT_EQ(std::get<0>(xy), 0);
+  EXPECT_EQ(std::get<1>(xy), 0);
 }
@@ -0,0 +1,127 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/packed_rtree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mesh = fes::mesh;
+
+static auto make_points(const int64_t size)
+    -> std::pair<Eigen::Matrix<double, 3, -1>, fes::Vector<int32_t>> {
+  auto generator = std::mt19937(42);
+  auto distribution = std::uniform_real_distribution<double>(-1000, 1000);
+  auto points = Eigen::Matrix<double, 3, -1>(3, size);
+  auto ids = fes::Vector<int32_t>(size);
+  for (int64_t ix = 0; ix < size; ++ix) {
+    points.col(ix) << distribution(generator), distribution(generator),
+        distribution(generator);
+    ids[ix] = static_cast<int32_t>(ix * 2);
+  }
+  return std::make_pair(points, ids);
+}
+
+TEST(PackedRTree, Nearest) {
+  auto points = Eigen::Matrix<double, 3, -1>();
+  auto ids = fes::Vector<int32_t>();
+  std::tie(points, ids) = make_points(5000);
+  auto tree = mesh::PackedRTree(points, ids);
+  EXPECT_EQ(tree.size(), 5000);
+  EXPECT_FALSE(tree.empty());
+
+  auto neighbors = mesh::PackedRTree::Neighbors{};
+  auto generator = std::mt19937(0);
+  auto distribution = std::uniform_real_distribution<double>(-1100, 1100);
+  for (auto trial = 0; trial < 100; ++trial) {
+    const auto point = Eigen::Vector3d(distribution(generator),
+                                       distribution(generator),
+                                       distribution(generator));
+    auto expected = std::vector<std::pair<double, int32_t>>{};
+    for (int64_t ix = 0; ix < points.cols(); ++ix) {
+      expected.emplace_back((points.col(ix) - point).norm(), ids[ix]);
+    }
+    std::sort(expected.begin(), expected.end());
+    tree.nearest(point, 8, neighbors);
+    ASSERT_EQ(neighbors.size(), 8);
+    for (size_t ix = 0; ix < neighbors.size(); ++ix) {
+      EXPECT_DOUBLE_EQ(neighbors[ix].first, expected[ix].first);
+      EXPECT_EQ(neighbors[ix].second, expected[ix].second);
+    }
+  }
+
+  // The number of neighbors is limited to kMaxNeighbors.
+  tree.nearest(Eigen::Vector3d::Zero(), 1000, neighbors);
+  EXPECT_EQ(neighbors.size(), size_t{mesh::PackedRTree::kMaxNeighbors});
+
+  auto empty = mesh::PackedRTree();
+  empty.nearest(Eigen::Vector3d::Zero(), 8, neighbors);
+  EXPECT_TRUE(neighbors.empty());
+}
+
+TEST(PackedRTree, Query) {
+  auto points = Eigen::Matrix<double, 3, -1>();
+  auto ids = fes::Vector<int32_t>();
+  std::tie(points, ids) = make_points(5000);
+  auto tree = mesh::PackedRTree(points, ids);
+
+  const auto min_corner = Eigen::Vector3d(-200, 0, -500);
+  const auto max_corner = Eigen::Vector3d(300, 250, 100);
+  auto expected = std::vector<int32_t>{};
+  for (int64_t ix = 0; ix < points.cols(); ++ix) {
+    if ((points.col(ix).array() >= min_corner.array()).all() &&
+        (points.col(ix).array() <= max_corner.array()).all()) {
+      expected.push_back(ids[ix]);
+    }
+  }
+  auto found = std::vector<int32_t>{};
+  tree.query(min_corner, max_corner,
+             [&found](const int32_t id) { found.push_back(id); });
+  std::sort(found.begin(), found.end());
+  EXPECT_FALSE(expected.empty());
+  EXPECT_EQ(found, expected);
+}
+
+TEST(PackedRTree, Serialize) {
+  auto points = Eigen::Matrix<double, 3, -1>();
+  auto ids = fes::Vector<int32_t>();
+  std::tie(points, ids) = make_points(1000);
+  auto tree = mesh::PackedRTree(points, ids);
+
+  auto state = tree.getstate();
+  auto other =
+      mesh::PackedRTree::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.size(), tree.size());
+  EXPECT_EQ(other.getstate(), state);
+
+  auto expected = mesh::PackedRTree::Neighbors{};
+  auto neighbors = mesh::PackedRTree::Neighbors{};
+  tree.nearest(Eigen::Vector3d(10, 20, 30), 4, expected);
+  other.nearest(Eigen::Vector3d(10, 20, 30), 4, neighbors);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), neighbors.begin(),
+                         neighbors.end()));
+
+  EXPECT_THROW(mesh::PackedRTree::setstate("invalid"), std::invalid_argument);
+
+  // The levels must match the number of points: 63 leaves, 4 nodes and the
+  // root.
+  auto levels = state.substr(state.size() - 4 * sizeof(int64_t));
+  EXPECT_EQ(levels.size(), 4 * sizeof(int64_t));
+  auto first_nodes = std::vector<int64_t>(4);
+  std::memcpy(first_nodes.data(), levels.data(), levels.size());
+  EXPECT_EQ(first_nodes, std::vector<int64_t>({0, 63, 67, 68}));
+  auto invalid = state;
+  first_nodes[1] = 62;
+  std::memcpy(&invalid[state.size() - levels.size()], first_nodes.data(),
+              levels.size());
+  EXPECT_THROW(mesh::PackedRTree::setstate(
+                   fes::string_view(invalid.data(), invalid.size())),
+               std::invalid_argument);
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/mesh/renumbering.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "fes/mesh/index.hpp"
+
+namespace mesh = fes::mesh;
+
+// Regular mesh of nx by ny cells, each cell being split into two triangles.
+// The vertices and the triangles are shuffled to mimic the arbitrary
+// numbering of a mesh generator.
+static auto make_mesh(const int nx, const int ny)
+    -> std::tuple<Eigen::VectorXd, Eigen::VectorXd,
+                  Eigen::Matrix<int32_t, -1, 3>> {
+  auto generator = std::mt19937(42);
+  auto vertices = std::vector<int32_t>((nx + 1) * (ny + 1));
+  std::iota(vertices.begin(), vertices.end(), 0);
+  std::shuffle(vertices.begin(), vertices.end(), generator);
+  auto lon = Eigen::VectorXd((nx + 1) * (ny + 1));
+  auto lat = Eigen::VectorXd((nx + 1) * (ny + 1));
+  for (auto jx = 0; jx <= ny; ++jx) {
+    for (auto ix = 0; ix <= nx; ++ix) {
+      lon(vertices[jx * (nx + 1) + ix]) = -10 + ix * 0.5;
+      lat(vertices[jx * (nx + 1) + ix]) = 20 + jx * 0.5;
+    }
+  }
+  auto cells = std::vector<int>(nx * ny);
+  std::iota(cells.begin(), cells.end(), 0);
+  std::shuffle(cells.begin(), cells.end(), generator);
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>(2 * nx * ny, 3);
+  for (size_t item = 0; item < cells.size(); ++item) {
+    const auto ix = cells[item] % nx;
+    const auto jx = cells[item] / nx;
+    const auto v0 = jx * (nx + 1) + ix;
+    triangles.row(2 * item) << vertices[v0], vertices[v0 + 1],
+        vertices[v0 + nx + 2];
+    triangles.row(2 * item + 1) << vertices[v0], vertices[v0 + nx + 2],
+        vertices[v0 + nx + 1];
+  }
+  return std::make_tuple(lon, lat, triangles);
+}
+
+// Mean distance, in number of items, between the vertices of each triangle.
+static auto mean_spread(const Eigen::Matrix<int32_t, -1, 3>& triangles)
+    -> double {
+  auto result = 0.0;
+  for (Eigen::Index ix = 0; ix < triangles.rows(); ++ix) {
+    result += triangles.row(ix).maxCoeff() - triangles.row(ix).minCoeff();
+  }
+  return result / static_cast<double>(triangles.rows());
+}
+
+TEST(Renumbering, HilbertIndex) {
+  EXPECT_EQ(mesh::hilbert_index(-180, -90), 0);
+  // The longitudes are periodic.
+  EXPECT_EQ(mesh::hilbert_index(190, 10), mesh::hilbert_index(-170, 10));
+  // The last cell of the curve is at the bottom right corner.
+  const auto side = uint64_t(1) << mesh::kHilbertBits;
+  EXPECT_EQ(mesh::hilbert_index(179.9999999, -90), side * side - 1);
+  EXPECT_EQ(mesh::hilbert_index(-179.9999999, 89.9999999),
+            (side * side - 1) / 3);
+}
+
+TEST(Renumbering, FirstTouchOrder) {
+  auto table = Eigen::Matrix<int32_t, -1, 3>(3, 3);
+  table << 4, 2, 0,  //
+      1, 2, 4,       //
+      5, 0, 1;
+  auto rows = fes::Vector<int64_t>(3);
+  rows << 2, 0, 1;
+  auto order = mesh::first_touch_order(table, rows, 7);
+  auto expected = fes::Vector<int64_t>(7);
+  expected << 5, 0, 1, 4, 2, 3, 6;
+  EXPECT_EQ(order, expected);
+
+  auto inverse = mesh::inverse_order(order);
+  for (Eigen::Index ix = 0; ix < order.size(); ++ix) {
+    EXPECT_EQ(inverse[order[ix]], ix);
+  }
+  EXPECT_THROW(mesh::first_touch_order(table, rows, 5), std::invalid_argument);
+}
+
+TEST(Renumbering, Mesh) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int32_t, -1, 3>();
+  std::tie(lon, lat, triangles) = make_mesh(64, 48);
+
+  // Renumber the triangles along the curve, then the vertices in the order in
+  // which the triangles use them.
+  const auto order = mesh::hilbert_order(lon, lat, triangles);
+  ASSERT_EQ(order.size(), triangles.rows());
+  auto sorted = fes::Vector<int64_t>(order);
+  std::sort(sorted.data(), sorted.data() + sorted.size());
+  for (Eigen::Index ix = 0; ix < sorted.size(); ++ix) {
+    ASSERT_EQ(sorted[ix], ix);
+  }
+  const auto vertices = mesh::first_touch_order(triangles, order, lon.size());
+  const auto inverse = mesh::inverse_order(vertices);
+  auto new_lon = Eigen::VectorXd(lon.size());
+  auto new_lat = Eigen::VectorXd(lat.size());
+  for (Eigen::Index ix = 0; ix < lon.size(); ++ix) {
+    new_lon(ix) = lon(vertices[ix]);
+    new_lat(ix) = lat(vertices[ix]);
+  }
+  auto new_triangles = Eigen::Matrix<int32_t, -1, 3>(triangles.rows(), 3);
+  for (Eigen::Index ix = 0; ix < triangles.rows(); ++ix) {
+    for (auto jx = 0; jx < 3; ++jx) {
+      new_triangles(ix, jx) =
+          static_cast<int32_t>(inverse[triangles(order[ix], jx)]);
+    }
+  }
+
+  // The vertices of each triangle are closer in memory.
+  EXPECT_LT(mean_spread(new_triangles), mean_spread(triangles) / 10);
+
+  // The renumbered mesh locates the same triangles.
+  auto index = mesh::Index(lon, lat, triangles);
+  auto new_index = mesh::Index(new_lon, new_lat, new_triangles);
+  auto generator = std::mt19937(0);
+  auto x = std::uniform_real_distribution<double>(-9.9, 21.9);
+  auto y = std::uniform_real_distribution<double>(20.1, 43.9);
+  for (auto trial = 0; trial < 200; ++trial) {
+    const auto point = fes::geometry::Point(x(generator), y(generator));
+    const auto expected = index.search(point, 0);
+    const auto result = new_index.search(point, 0);
+    ASSERT_TRUE(result.is_inside());
+    const auto triangle = expected.index;
+    const auto new_triangle = result.index;
+    for (auto jx = 0; jx < 3; ++jx) {
+      EXPECT_EQ(lon(triangles(triangle, jx)),
+                new_lon(new_triangles(new_triangle, jx)));
+      EXPECT_EQ(lat(triangles(triangle, jx)),
+                new_lat(new_triangles(new_triangle, jx)));
+    }
+  }
+}
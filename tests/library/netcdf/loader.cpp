@@ -0,0 +1,234 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/netcdf/loader.hpp"
+
+#include <gtest/gtest.h>
+#include <netcdf.h>
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fes/detail/math.hpp"
+
+namespace netcdf = fes::netcdf;
+
+// Throw an exception if a call to the NetCDF library failed.
+static auto check(const int status) -> void {
+  if (status != NC_NOERR) {
+    throw std::runtime_error(nc_strerror(status));
+  }
+}
+
+// Expected value of a wave, the phase being expressed in degrees.
+template <typename T>
+static auto wave_value(const T amp, const T pha) -> std::complex<T> {
+  const auto phase = fes::detail::math::radians<T>(pha);
+  return {amp * std::cos(phase), amp * std::sin(phase)};
+}
+
+// Write a grid of amplitudes and phases, stored in latitude-major order.
+static auto write_grid(const std::string& path, const std::vector<float>& lon,
+                       const std::vector<float>& lat,
+                       const std::vector<float>& amp,
+                       const std::vector<float>& pha) -> void {
+  auto ncid = 0;
+  auto dims = std::array<int, 2>{};
+  auto lon_id = 0;
+  auto lat_id = 0;
+  auto amp_id = 0;
+  auto pha_id = 0;
+  const auto fill_value = -1.0F;
+  check(nc_create(path.c_str(), NC_CLOBBER, &ncid));
+  check(nc_def_dim(ncid, "lat", lat.size(), &dims[0]));
+  check(nc_def_dim(ncid, "lon", lon.size(), &dims[1]));
+  check(nc_def_var(ncid, "lat", NC_FLOAT, 1, &dims[0], &lat_id));
+  check(nc_def_var(ncid, "lon", NC_FLOAT, 1, &dims[1], &lon_id));
+  check(nc_def_var(ncid, "amplitude", NC_FLOAT, 2, dims.data(), &amp_id));
+  check(nc_put_att_float(ncid, amp_id, "_FillValue", NC_FLOAT, 1,
+                         &fill_value));
+  check(nc_def_var(ncid, "phase", NC_FLOAT, 2, dims.data(), &pha_id));
+  check(nc_put_att_text(ncid, pha_id, "units", 7, "degrees"));
+  check(nc_enddef(ncid));
+  check(nc_put_var_float(ncid, lat_id, lat.data()));
+  check(nc_put_var_float(ncid, lon_id, lon.data()));
+  check(nc_put_var_float(ncid, amp_id, amp.data()));
+  check(nc_put_var_float(ncid, pha_id, pha.data()));
+  check(nc_close(ncid));
+}
+
+// Write a regular mesh of nx by ny cells, each cell being split into two
+// triangles, with the values of the M2 wave at its vertices.
+static auto write_mesh(const std::string& path, const int nx, const int ny,
+                       const std::vector<double>& amp,
+                       const std::vector<double>& pha) -> void {
+  auto lon = std::vector<double>();
+  auto lat = std::vector<double>();
+  for (auto jx = 0; jx <= ny; ++jx) {
+    for (auto ix = 0; ix <= nx; ++ix) {
+      lon.push_back(ix * 0.5);
+      lat.push_back(jx * 0.5);
+    }
+  }
+  auto triangles = std::vector<int>();
+  for (auto jx = 0; jx < ny; ++jx) {
+    for (auto ix = 0; ix < nx; ++ix) {
+      const auto v0 = jx * (nx + 1) + ix;
+      triangles.insert(triangles.end(), {v0, v0 + 1, v0 + nx + 2});
+      triangles.insert(triangles.end(), {v0, v0 + nx + 2, v0 + nx + 1});
+    }
+  }
+  auto ncid = 0;
+  auto vertices = 0;
+  auto dims = std::array<int, 2>{};
+  auto ids = std::array<int, 6>{};
+  check(nc_create(path.c_str(), NC_CLOBBER, &ncid));
+  check(nc_def_dim(ncid, "node", lon.size(), &vertices));
+  check(nc_def_dim(ncid, "element", triangles.size() / 3, &dims[0]));
+  check(nc_def_dim(ncid, "three", 3, &dims[1]));
+  check(nc_def_var(ncid, "lon", NC_DOUBLE, 1, &vertices, &ids[0]));
+  check(nc_def_var(ncid, "lat", NC_DOUBLE, 1, &vertices, &ids[1]));
+  check(nc_def_var(ncid, "triangle", NC_INT, 2, dims.data(), &ids[2]));
+  check(nc_def_var(ncid, "codes", NC_INT, 2, dims.data(), &ids[3]));
+  check(nc_def_var(ncid, "M2_amplitude", NC_DOUBLE, 1, &vertices, &ids[4]));
+  check(nc_def_var(ncid, "M2_phase", NC_DOUBLE, 1, &vertices, &ids[5]));
+  check(nc_put_att_text(ncid, ids[5], "units", 7, "degrees"));
+  check(nc_enddef(ncid));
+  check(nc_put_var_double(ncid, ids[0], lon.data()));
+  check(nc_put_var_double(ncid, ids[1], lat.data()));
+  check(nc_put_var_int(ncid, ids[2], triangles.data()));
+  check(nc_put_var_int(ncid, ids[3], triangles.data()));
+  check(nc_put_var_double(ncid, ids[4], amp.data()));
+  check(nc_put_var_double(ncid, ids[5], pha.data()));
+  check(nc_close(ncid));
+}
+
+TEST(NetCDF, Cartesian) {
+  constexpr auto kNx = 36;
+  constexpr auto kNy = 19;
+  auto lon = std::vector<float>();
+  auto lat = std::vector<float>();
+  for (auto ix = 0; ix < kNx; ++ix) {
+    lon.push_back(static_cast<float>(ix * 10));
+  }
+  for (auto ix = 0; ix < kNy; ++ix) {
+    lat.push_back(static_cast<float>(-90 + ix * 10));
+  }
+  auto generator = std::mt19937(42);
+  auto amplitude = std::uniform_real_distribution<float>(0, 2);
+  auto phase = std::uniform_real_distribution<float>(-180, 180);
+  auto settings = netcdf::CartesianSettings();
+  auto amps = std::vector<std::vector<float>>();
+  auto phas = std::vector<std::vector<float>>();
+  for (auto ident : {fes::kM2, fes::kK1}) {
+    auto amp = std::vector<float>(kNx * kNy);
+    auto pha = std::vector<float>(kNx * kNy);
+    for (size_t ix = 0; ix < amp.size(); ++ix) {
+      amp[ix] = amplitude(generator);
+      pha[ix] = phase(generator);
+    }
+    // A masked value
+    amp[3] = -1;
+    const auto path = testing::TempDir() + "/fes_loader_" +
+                      fes::constituents::name(ident) + ".nc";
+    write_grid(path, lon, lat, amp, pha);
+    settings.paths.emplace(ident, path);
+    amps.push_back(std::move(amp));
+    phas.push_back(std::move(pha));
+  }
+  ASSERT_FALSE(
+      netcdf::is_double_precision(settings.paths.at(fes::kM2), "amplitude"));
+
+  auto model = netcdf::load_cartesian<float>(settings, 2);
+  EXPECT_EQ(model->lon().size(), kNx);
+  EXPECT_EQ(model->lat().size(), kNy);
+  auto item = size_t(0);
+  for (auto ident : {fes::kM2, fes::kK1}) {
+    const auto& wave = model->data().at(ident);
+    ASSERT_EQ(wave.size(), kNx * kNy);
+    EXPECT_TRUE(std::isnan(wave(3).real()));
+    for (auto ix = 0; ix < wave.size(); ++ix) {
+      if (ix != 3) {
+        EXPECT_EQ(wave(ix), wave_value(amps[item][ix], phas[item][ix]));
+      }
+    }
+    ++item;
+  }
+
+  // A region crossing the date line.
+  settings.bbox = netcdf::BoundingBox(-40, -20, 30, 40);
+  model = netcdf::load_cartesian<float>(settings, 1);
+  EXPECT_EQ(model->lon().size(), 8);
+  EXPECT_EQ(model->lat().size(), 7);
+  const auto& wave = model->data().at(fes::kM2);
+  for (auto jx = 0; jx < 7; ++jx) {
+    for (auto ix = 0; ix < 8; ++ix) {
+      const auto kx = (jx + 7) * kNx + (ix + 32) % kNx;
+      EXPECT_EQ(wave(jx * 8 + ix), wave_value(amps[0][kx], phas[0][kx]));
+    }
+  }
+
+  settings.amplitude = "unknown";
+  EXPECT_THROW(netcdf::load_cartesian<float>(settings), std::invalid_argument);
+}
+
+TEST(NetCDF, LGP1) {
+  constexpr auto kNx = 8;
+  constexpr auto kNy = 6;
+  auto generator = std::mt19937(42);
+  auto amplitude = std::uniform_real_distribution<double>(0, 2);
+  auto phase = std::uniform_real_distribution<double>(-180, 180);
+  auto amp = std::vector<double>((kNx + 1) * (kNy + 1));
+  auto pha = std::vector<double>(amp.size());
+  for (size_t ix = 0; ix < amp.size(); ++ix) {
+    amp[ix] = amplitude(generator);
+    pha[ix] = phase(generator);
+  }
+  const auto path = testing::TempDir() + "/fes_loader_lgp1.nc";
+  write_mesh(path, kNx, kNy, amp, pha);
+
+  auto settings = netcdf::LGPSettings();
+  settings.path = path;
+  settings.constituents = {"M2"};
+  ASSERT_TRUE(netcdf::is_double_precision(path, "M2_amplitude"));
+  auto model = netcdf::load_lgp1<double>(settings);
+  const auto& wave = model->data().at(fes::kM2);
+  ASSERT_EQ(wave.size(), static_cast<Eigen::Index>(amp.size()));
+  for (auto ix = 0; ix < wave.size(); ++ix) {
+    EXPECT_EQ(wave(ix), wave_value(amp[ix], pha[ix]));
+  }
+
+  // The renumbered model, restricted to a region, interpolates the same
+  // values.
+  settings.renumber = true;
+  settings.interleaved = true;
+  settings.bbox = netcdf::BoundingBox(0.2, 0.2, 2.8, 2.3);
+  auto other = netcdf::load_lgp1<double>(settings, 2);
+  EXPECT_TRUE(other->interleaved());
+  auto acc1 = std::unique_ptr<fes::Accelerator>(
+      model->accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto acc2 = std::unique_ptr<fes::Accelerator>(
+      other->accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto x = std::uniform_real_distribution<double>(0.3, 2.7);
+  auto y = std::uniform_real_distribution<double>(0.3, 2.2);
+  for (auto trial = 0; trial < 100; ++trial) {
+    const auto point = fes::geometry::Point(x(generator), y(generator));
+    fes::Quality expected_quality;
+    fes::Quality quality;
+    const auto expected = model->interpolate(point, expected_quality,
+                                             acc1.get());
+    const auto values = other->interpolate(point, quality, acc2.get());
+    ASSERT_EQ(quality, expected_quality);
+    EXPECT_NEAR(std::abs(values[0].second - expected[0].second), 0, 1e-12);
+  }
+
+  settings.constituents = {"K1"};
+  EXPECT_THROW(netcdf::load_lgp1<double>(settings), std::invalid_argument);
+}
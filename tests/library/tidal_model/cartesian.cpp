@@ -6,6 +6,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <sstream>
+
 TEST(TidalModelCartesian, Constructor) {
   auto points = Eigen::VectorXd(5);
   points << 0, 1, 2, 3, 4;
@@ -59,3 +64,93 @@ TEST(TidalModelCartesian, GetSetState) {
   EXPECT_EQ(model_data.at(fes::kM2)(4), other_data.at(fes::kM2)(4));
   EXPECT_EQ(model_data.at(fes::kK2)(4), other_data.at(fes::kK2)(4));
 }
+
+TEST(TidalModelCartesian, StreamState) {
+  auto points = Eigen::VectorXd(5);
+  points << 0, 1, 2, 3, 4;
+  auto matrix = Eigen::VectorXcd(25);
+  for (auto ix = 0; ix < matrix.size(); ++ix) {
+    matrix(ix) = {static_cast<double>(ix), -static_cast<double>(ix)};
+  }
+  auto axis = fes::Axis(points);
+  auto model = fes::tidal_model::Cartesian<double>(axis, axis, fes::kTide,
+                                                   false, 200'000);
+  model.add_constituent(fes::kM2, matrix);
+  model.add_constituent(fes::kK2, matrix);
+
+  // The stream receives the bytes of the in-memory state.
+  const auto state = model.getstate();
+  auto ss = std::stringstream();
+  model.getstate(ss);
+  EXPECT_EQ(ss.str(), state);
+
+  const auto other = fes::tidal_model::Cartesian<double>::setstate(ss);
+  EXPECT_EQ(other.getstate(), state);
+  EXPECT_EQ(other.data().at(fes::kM2), model.data().at(fes::kM2));
+  EXPECT_EQ(other.max_distance(), model.max_distance());
+
+  auto truncated = std::stringstream(state.substr(0, state.size() - 1));
+  EXPECT_THROW(fes::tidal_model::Cartesian<double>::setstate(truncated),
+               std::invalid_argument);
+}
+
+TEST(TidalModelCartesian, Extrapolation) {
+  auto points = Eigen::VectorXd(5);
+  points << 0, 1, 2, 3, 4;
+  auto axis = fes::Axis(points);
+  // The last two columns of the grid are undefined.
+  auto wave = Eigen::VectorXcd(25);
+  for (int64_t ix = 0; ix < 5; ++ix) {
+    for (int64_t iy = 0; iy < 5; ++iy) {
+      wave(ix * 5 + iy) = ix < 3 ? std::complex<double>(ix + 1, iy)
+                                 : std::complex<double>(std::nan(""), 0);
+    }
+  }
+  auto model = fes::tidal_model::Cartesian<double>(axis, axis, fes::kTide);
+  model.add_constituent(fes::kM2, wave);
+
+  auto quality = fes::Quality{};
+  auto acc = std::unique_ptr<fes::Accelerator>(
+      model.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto values = model.interpolate({3.5, 1.5}, quality, acc.get());
+  EXPECT_EQ(quality, fes::kUndefined);
+  EXPECT_TRUE(std::isnan(values[0].second.real()));
+
+  // 200 km: the third column is close enough to the nearest defined cells,
+  // but not the fourth one.
+  auto extrapolated =
+      fes::tidal_model::Cartesian<double>(axis, axis, fes::kTide, true, 200e3);
+  extrapolated.add_constituent(fes::kM2, wave);
+  EXPECT_EQ(extrapolated.max_distance(), 200e3);
+  values = extrapolated.interpolate({3.5, 1.5}, quality, acc.get());
+  EXPECT_EQ(quality, -2);
+  EXPECT_NEAR(values[0].second.real(), 3, 1e-12);
+  EXPECT_NEAR(values[0].second.imag(), 1.5, 1e-12);
+
+  // Points inside the defined area are interpolated as usual.
+  values = extrapolated.interpolate({1.5, 1.5}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_NEAR(values[0].second.real(), 2.5, 1e-12);
+
+  // The extrapolation table is preserved by the serialization.
+  auto state = extrapolated.getstate();
+  auto other = fes::tidal_model::Cartesian<double>::setstate(
+      fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.max_distance(), 200e3);
+  values = other.interpolate({3.5, 1.5}, quality, acc.get());
+  EXPECT_EQ(quality, -2);
+  EXPECT_NEAR(values[0].second.real(), 3, 1e-12);
+
+  // A new constituent undefined in defined cells updates the table: the
+  // nearest defined cells become the diagonal neighbors.
+  auto partial = Eigen::VectorXcd(wave);
+  partial(2 * 5 + 1) = std::complex<double>(std::nan(""), 0);
+  partial(2 * 5 + 2) = std::complex<double>(std::nan(""), 0);
+  extrapolated.add_constituent(fes::kK2, partial);
+  values = extrapolated.interpolate({3.5, 1.5}, quality, acc.get());
+  EXPECT_EQ(quality, -2);
+  for (const auto& item : values) {
+    EXPECT_NEAR(item.second.real(), 3, 1e-12);
+    EXPECT_NEAR(item.second.imag(), 1.5, 1e-12);
+  }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/curvilinear.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <memory>
+
+using Model = fes::tidal_model::Curvilinear<double>;
+
+// Grid rotated by 30 degrees around (175, 10), crossing the antimeridian.
+static auto build_model() -> Model {
+  const auto angle = fes::detail::math::radians(30.0);
+  auto lon = fes::Matrix<double>(21, 31);
+  auto lat = fes::Matrix<double>(21, 31);
+  for (int64_t i = 0; i < 21; ++i) {
+    for (int64_t j = 0; j < 31; ++j) {
+      auto x = (i - 10) * 0.5;
+      auto y = (j - 15) * 0.5;
+      lon(i, j) = fes::detail::math::normalize_angle(
+          175 + x * std::cos(angle) - y * std::sin(angle));
+      lat(i, j) = 10 + x * std::sin(angle) + y * std::cos(angle);
+    }
+  }
+  auto model = Model(lon, lat, fes::kTide);
+
+  // The wave is a linear function of the coordinates, the bilinear
+  // interpolation is exact.
+  auto wave = Eigen::VectorXcd(21 * 31);
+  for (int64_t i = 0; i < 21; ++i) {
+    for (int64_t j = 0; j < 31; ++j) {
+      wave(i * 31 + j) = std::complex<double>(i, j);
+    }
+  }
+  wave(0) = std::complex<double>(std::nan(""), 0);
+  model.add_constituent(fes::kM2, wave);
+  return model;
+}
+
+TEST(TidalModelCurvilinear, Interpolate) {
+  auto model = build_model();
+  auto quality = fes::Quality{};
+  auto acc = std::unique_ptr<fes::Accelerator>(
+      model.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  const auto angle = fes::detail::math::radians(30.0);
+
+  // Points along a track, located using the cached cells, then on a second
+  // pass by the lookup raster.
+  for (auto pass = 0; pass < 2; ++pass) {
+    for (auto u = 0.3; u < 19.5; u += 0.7) {
+      auto v = 25.1 - u;
+      auto x = (u - 10) * 0.5;
+      auto y = (v - 15) * 0.5;
+      auto point =
+          fes::geometry::Point(175 + x * std::cos(angle) - y * std::sin(angle),
+                               10 + x * std::sin(angle) + y * std::cos(angle));
+      if (pass == 1) {
+        acc.reset(model.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+      }
+      auto values = model.interpolate(point, quality, acc.get());
+      ASSERT_EQ(values.size(), 1);
+      EXPECT_EQ(quality, 4);
+      EXPECT_NEAR(values[0].second.real(), u, 1e-9);
+      EXPECT_NEAR(values[0].second.imag(), v, 1e-9);
+    }
+  }
+
+  // Outside the grid.
+  auto values = model.interpolate({0, 0}, quality, acc.get());
+  EXPECT_EQ(quality, fes::kUndefined);
+  EXPECT_TRUE(std::isnan(values[0].second.real()));
+
+  // Cell with an undefined node.
+  auto x = (0.5 - 10) * 0.5;
+  auto y = (0.5 - 15) * 0.5;
+  values = model.interpolate(
+      {175 + x * std::cos(angle) - y * std::sin(angle),
+       10 + x * std::sin(angle) + y * std::cos(angle)},
+      quality, acc.get());
+  EXPECT_EQ(quality, 3);
+}
+
+TEST(TidalModelCurvilinear, GetSetState) {
+  auto model = build_model();
+  auto state = model.getstate();
+  auto other = Model::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.resolution(), model.resolution());
+  EXPECT_EQ(other.lon(), model.lon());
+  EXPECT_EQ(other.lat(), model.lat());
+  EXPECT_EQ(other.identifiers(), model.identifiers());
+
+  auto quality = fes::Quality{};
+  auto acc = std::unique_ptr<fes::Accelerator>(
+      other.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto values = other.interpolate({175, 10}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_NEAR(values[0].second.real(), 10, 1e-9);
+  EXPECT_NEAR(values[0].second.imag(), 15, 1e-9);
+
+  EXPECT_THROW(Model::setstate("invalid"), std::invalid_argument);
+  EXPECT_THROW(Model(fes::Matrix<double>::Zero(2, 2),
+                     fes::Matrix<double>::Zero(3, 2), fes::kTide),
+               std::invalid_argument);
+}
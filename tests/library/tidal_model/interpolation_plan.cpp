@@ -0,0 +1,90 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/interpolation_plan.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <random>
+
+using Model = fes::tidal_model::Cartesian<double>;
+
+static auto build_model(const bool row_major, const double max_distance)
+    -> Model {
+  auto lon = fes::Axis(Eigen::VectorXd::LinSpaced(180, 0, 358), 1e-6, true);
+  auto lat = fes::Axis(Eigen::VectorXd::LinSpaced(81, -80, 80));
+  auto model = Model(lon, lat, fes::kTide, row_major, max_distance);
+  for (auto ident : {fes::kM2, fes::kK1}) {
+    auto wave = Eigen::VectorXcd(180 * 81);
+    for (int64_t ix = 0; ix < 180; ++ix) {
+      for (int64_t iy = 0; iy < 81; ++iy) {
+        auto index = row_major ? ix * 81 + iy : iy * 180 + ix;
+        // A continent in the middle of the grid.
+        wave(index) = ix > 40 && ix < 60 && iy > 20 && iy < 50
+                          ? std::complex<double>(std::nan(""), 0)
+                          : std::complex<double>(std::sin(ix * 0.1) + ident,
+                                                 std::cos(iy * 0.1));
+      }
+    }
+    model.add_constituent(ident, wave);
+  }
+  return model;
+}
+
+TEST(TidalModelInterpolationPlan, Apply) {
+  auto generator = std::mt19937(42);
+  auto lon_distribution = std::uniform_real_distribution<double>(-180, 180);
+  auto lat_distribution = std::uniform_real_distribution<double>(-90, 90);
+  auto lon = Eigen::VectorXd(5000);
+  auto lat = Eigen::VectorXd(5000);
+  for (Eigen::Index ix = 0; ix < lon.size(); ++ix) {
+    lon[ix] = lon_distribution(generator);
+    lat[ix] = lat_distribution(generator);
+  }
+  // Points around the continent.
+  lon.head(1000) = Eigen::VectorXd::LinSpaced(1000, 75, 125);
+  lat.head(1000).setConstant(-10.5);
+
+  for (auto row_major : {true, false}) {
+    for (auto max_distance : {0.0, 300e3}) {
+      auto model = build_model(row_major, max_distance);
+      auto plan = fes::tidal_model::InterpolationPlan(model, lon, lat, 2);
+      EXPECT_EQ(plan.size(), 5000);
+
+      auto result = plan.apply(model, 3);
+      const auto& values = std::get<0>(result);
+      const auto& qualities = std::get<1>(result);
+      ASSERT_EQ(values.size(), 2);
+
+      auto acc = std::unique_ptr<fes::Accelerator>(
+          model.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+      auto extrapolated = 0;
+      for (Eigen::Index ix = 0; ix < lon.size(); ++ix) {
+        auto quality = fes::Quality{};
+        const auto& expected =
+            model.interpolate({lon[ix], lat[ix]}, quality, acc.get());
+        ASSERT_EQ(qualities[ix], quality);
+        extrapolated += quality < 0 ? 1 : 0;
+        for (const auto& item : expected) {
+          const auto& value = values.at(item.first)[ix];
+          if (quality == fes::kUndefined) {
+            EXPECT_TRUE(std::isnan(value.real()));
+          } else {
+            EXPECT_NEAR(value.real(), item.second.real(), 1e-12);
+            EXPECT_NEAR(value.imag(), item.second.imag(), 1e-12);
+          }
+        }
+      }
+      EXPECT_EQ(extrapolated > 0, max_distance > 0);
+    }
+  }
+
+  // The plan is bound to the grid used to build it.
+  auto plan = fes::tidal_model::InterpolationPlan(build_model(true, 0), lon,
+                                                  lat);
+  EXPECT_THROW(plan.apply(build_model(false, 0)), std::invalid_argument);
+}
@@ -4,14 +4,19 @@
 // BSD-style license that can be found in the LICENSE file.
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
 #include "fes/tidal_model/lgp.hpp"
 
-TEST(InterpolatorLGP1, Constructor) {
+static auto make_data()
+    -> std::tuple<Eigen::VectorXd, Eigen::VectorXd, Eigen::Matrix<int, -1, 3>,
+                  Eigen::Matrix<int, -1, 3>> {
   auto lon = Eigen::VectorXd(19);
   auto lat = Eigen::VectorXd(19);
   auto triangles = Eigen::Matrix<int, -1, 3>(24, 3);
   auto codes = Eigen::Matrix<int, -1, 3>(24, 3);
-  auto values = Eigen::VectorXcd(24 * 3);
 
   lon << 0.004, -0.175, -0.273, -0.11, 0.183, 0.256, 0.183, -0.428, -0.501,
       -0.371, 0.46, 0.622, 0.451, 0.313, -0.021, -0.289, -0.175, 0.077, 0.321;
@@ -68,6 +73,16 @@ TEST(InterpolatorLGP1, Constructor) {
       63, 64, 65,    // 21
       66, 67, 68,    // 22
       69, 70, 71;    // 23
+  return std::make_tuple(lon, lat, triangles, codes);
+}
+
+TEST(InterpolatorLGP1, Constructor) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto values = Eigen::VectorXcd(24 * 3);
 
   values.setOnes();
 
@@ -87,3 +102,66 @@ TEST(InterpolatorLGP1, Constructor) {
   auto y = other.interpolate({0.0, 0.0}, quality, acc.get());
   EXPECT_EQ(x, y);
 }
+
+TEST(InterpolatorLGP1, BoundingBox) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 3>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto values = Eigen::VectorXcd(24 * 3);
+  for (auto ix = 0; ix < values.size(); ++ix) {
+    values(ix) = std::complex<double>(ix, -ix);
+  }
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+
+  // Reference model covering the whole mesh.
+  auto global = fes::tidal_model::LGP1<double>(index, codes, fes::kTide);
+  global.add_constituent(fes::kS2, values);
+  EXPECT_EQ(global.selected_indices().size(), 0);
+
+  // Regional model: only the wave values of the selected codes are loaded.
+  auto regional = fes::tidal_model::LGP1<double>(
+      index, codes, fes::kTide, 0,
+      std::make_tuple(-0.15, 0.09, -0.14, 0.1));
+  const auto selected = regional.selected_indices();
+  ASSERT_EQ(selected.size(), 3);
+  EXPECT_TRUE(std::is_sorted(selected.data(), selected.data() + 3));
+  auto subset = Eigen::VectorXcd(selected.size());
+  for (auto ix = 0; ix < selected.size(); ++ix) {
+    subset(ix) = values(selected(ix));
+  }
+  EXPECT_THROW(regional.add_constituent(fes::kS2, values),
+               std::invalid_argument);
+  regional.add_constituent(fes::kS2, subset);
+
+  auto global_acc = std::unique_ptr<fes::Accelerator>(
+      global.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto regional_acc = std::unique_ptr<fes::Accelerator>(
+      regional.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  fes::Quality expected_quality;
+  fes::Quality quality;
+
+  // Inside the selected triangle, the result is the one of the global model.
+  auto x = global.interpolate({-0.145, 0.095}, expected_quality,
+                              global_acc.get());
+  auto y = regional.interpolate({-0.145, 0.095}, quality, regional_acc.get());
+  EXPECT_EQ(quality, expected_quality);
+  ASSERT_EQ(x.size(), 1);
+  ASSERT_EQ(y.size(), 1);
+  EXPECT_NEAR(std::abs(x[0].second - y[0].second), 0, 1e-12);
+
+  // Outside the bounding box, the point is undefined.
+  y = regional.interpolate({0.3, -0.3}, quality, regional_acc.get());
+  EXPECT_EQ(quality, fes::kUndefined);
+  EXPECT_TRUE(std::isnan(y[0].second.real()));
+
+  // The selection survives serialization.
+  auto state = regional.getstate();
+  auto other = fes::tidal_model::LGP1<double>::setstate(
+      fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.selected_indices(), selected);
+  y = other.interpolate({-0.145, 0.095}, quality, regional_acc.get());
+  EXPECT_EQ(quality, expected_quality);
+  EXPECT_NEAR(std::abs(x[0].second - y[0].second), 0, 1e-12);
+}
@@ -4,14 +4,26 @@
 // BSD-style license that can be found in the LICENSE file.
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include "fes/detail/serialize.hpp"
 #include "fes/tidal_model/lgp.hpp"
 
-TEST(InterpolatorLGP2, Constructor) {
+static auto make_data()
+    -> std::tuple<Eigen::VectorXd, Eigen::VectorXd, Eigen::Matrix<int, -1, 3>,
+                  Eigen::Matrix<int, -1, 6>> {
   auto lon = Eigen::VectorXd(19);
   auto lat = Eigen::VectorXd(19);
   auto triangles = Eigen::Matrix<int, -1, 3>(24, 3);
   auto codes = Eigen::Matrix<int, -1, 6>(24, 6);
-  auto values = Eigen::VectorXcd(24 * 6);
 
   lon << 0.004, -0.175, -0.273, -0.11, 0.183, 0.256, 0.183, -0.428, -0.501,
       -0.371, 0.46, 0.622, 0.451, 0.313, -0.021, -0.289, -0.175, 0.077, 0.321;
@@ -69,6 +81,16 @@ TEST(InterpolatorLGP2, Constructor) {
       126, 127, 128, 129, 130, 131,  // 21
       132, 133, 134, 135, 136, 137,  // 22
       138, 139, 140, 141, 142, 143;  // 23
+  return std::make_tuple(lon, lat, triangles, codes);
+}
+
+TEST(InterpolatorLGP2, Constructor) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto values = Eigen::VectorXcd(24 * 6);
 
   values.setOnes();
 
@@ -83,3 +105,421 @@ TEST(InterpolatorLGP2, Constructor) {
   lgp2.interpolate({0.0, 0.0}, quality, acc.get());
   lgp2.interpolate({0.0, 0.0}, quality, acc.get());
 }
+
+TEST(InterpolatorLGP2, Interleaved) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+
+  auto generator = std::mt19937(42);
+  auto distribution = std::uniform_real_distribution<float>(-1, 1);
+  auto make_wave = [&]() {
+    auto wave = fes::Vector<std::complex<float>>(24 * 6);
+    for (auto ix = 0; ix < wave.size(); ++ix) {
+      wave(ix) = {distribution(generator), distribution(generator)};
+    }
+    return wave;
+  };
+
+  auto lgp2 = fes::tidal_model::LGP2<float>(index, codes, fes::kTide);
+  auto interleaved = fes::tidal_model::LGP2<float>(index, codes, fes::kTide);
+  interleaved.interleave();
+  EXPECT_TRUE(interleaved.interleaved());
+  EXPECT_FALSE(lgp2.interleaved());
+  for (auto ident : {fes::kM2, fes::kS2, fes::kK1, fes::kO1}) {
+    auto wave = make_wave();
+    lgp2.add_constituent(ident, wave);
+    interleaved.add_constituent(ident, wave);
+  }
+
+  // Serialization keeps the layout.
+  auto state = interleaved.getstate();
+  auto other = fes::tidal_model::LGP2<float>::setstate(
+      fes::string_view(state.data(), state.size()));
+  EXPECT_TRUE(other.interleaved());
+
+  // The data map only lists the constituents, whose values are read from the
+  // node-major table without copying them.
+  EXPECT_EQ(interleaved.identifiers(), lgp2.identifiers());
+  for (const auto& item : interleaved.data()) {
+    EXPECT_EQ(item.second.size(), 0);
+    const auto values = interleaved.values(item.first);
+    EXPECT_EQ(values.innerStride(), 4);
+    EXPECT_EQ(values, lgp2.data().at(item.first));
+    EXPECT_EQ(other.values(item.first), lgp2.values(item.first));
+  }
+  EXPECT_THROW(interleaved.values(fes::kN2), std::invalid_argument);
+
+  auto acc1 = std::unique_ptr<fes::Accelerator>(
+      lgp2.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto acc2 = std::unique_ptr<fes::Accelerator>(
+      interleaved.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto acc3 = std::unique_ptr<fes::Accelerator>(
+      other.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto lon_distribution = std::uniform_real_distribution<double>(-0.5, 0.6);
+  auto lat_distribution = std::uniform_real_distribution<double>(-0.4, 0.45);
+  for (auto trial = 0; trial < 200; ++trial) {
+    const auto point = fes::geometry::Point(lon_distribution(generator),
+                                            lat_distribution(generator));
+    fes::Quality expected_quality;
+    fes::Quality quality;
+    const auto expected = lgp2.interpolate(point, expected_quality, acc1.get());
+    auto values = interleaved.interpolate(point, quality, acc2.get());
+    EXPECT_EQ(quality, expected_quality);
+    ASSERT_EQ(values.size(), expected.size());
+    for (size_t ix = 0; ix < values.size(); ++ix) {
+      EXPECT_EQ(values[ix].first, expected[ix].first);
+      if (quality != fes::kUndefined) {
+        EXPECT_EQ(values[ix].second, expected[ix].second);
+      }
+    }
+    values = other.interpolate(point, quality, acc3.get());
+    EXPECT_EQ(quality, expected_quality);
+    for (size_t ix = 0; ix < values.size(); ++ix) {
+      if (quality != fes::kUndefined) {
+        EXPECT_EQ(values[ix].second, expected[ix].second);
+      }
+    }
+  }
+}
+
+TEST(InterpolatorLGP2, ReferenceTransforms) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto values = Eigen::VectorXcd(24 * 6);
+  for (auto ix = 0; ix < values.size(); ++ix) {
+    values(ix) = std::complex<double>(std::cos(ix), std::sin(ix));
+  }
+
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+  auto transformed = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+  transformed->build_reference_transforms();
+  auto lgp2 = fes::tidal_model::LGP2<double>(index, codes, fes::kTide);
+  auto other = fes::tidal_model::LGP2<double>(transformed, codes, fes::kTide);
+  lgp2.add_constituent(fes::kM2, values);
+  other.add_constituent(fes::kM2, values);
+
+  auto acc1 = std::unique_ptr<fes::Accelerator>(
+      lgp2.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto acc2 = std::unique_ptr<fes::Accelerator>(
+      other.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  // Successive close points, mostly located in the cached triangle.
+  for (auto x = -0.4; x <= 0.5; x += 0.003) {
+    const auto point = fes::geometry::Point(x, 0.1 * std::sin(10 * x));
+    fes::Quality expected_quality;
+    fes::Quality quality;
+    const auto expected = lgp2.interpolate(point, expected_quality, acc1.get());
+    const auto result = other.interpolate(point, quality, acc2.get());
+    EXPECT_EQ(quality, expected_quality);
+    if (quality != fes::kUndefined) {
+      EXPECT_NEAR(std::abs(result[0].second - expected[0].second), 0, 1e-10);
+    }
+  }
+}
+
+TEST(InterpolatorLGP2, Subset) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto m2 = Eigen::VectorXcd(24 * 6);
+  auto s2 = Eigen::VectorXcd(24 * 6);
+  for (auto ix = 0; ix < m2.size(); ++ix) {
+    m2(ix) = std::complex<double>(std::cos(ix), std::sin(ix));
+    s2(ix) = std::complex<double>(ix, -ix);
+  }
+
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+  auto lgp2 = fes::tidal_model::LGP2<double>(index, codes, fes::kTide);
+  lgp2.add_constituent(fes::kM2, m2);
+  lgp2.add_constituent(fes::kS2, s2);
+  lgp2.interleave();
+
+  const auto bbox = std::make_tuple(-0.2, -0.1, 0.2, 0.2);
+  const auto subset = lgp2.subset(bbox);
+  EXPECT_LT(subset.index()->n_triangles(), index->n_triangles());
+  EXPECT_LT(subset.index()->n_positions(), index->n_positions());
+  EXPECT_TRUE(subset.interleaved());
+  EXPECT_EQ(subset.size(), 2);
+
+  // The selected indices locate the values of the extracted model in the
+  // original wave models.
+  const auto& selected = subset.selected_indices();
+  ASSERT_EQ(selected.size(), subset.values(fes::kM2).size());
+  EXPECT_TRUE(
+      std::is_sorted(selected.data(), selected.data() + selected.size()));
+  for (auto ix = 0; ix < selected.size(); ++ix) {
+    EXPECT_EQ(subset.values(fes::kM2)(ix), m2(selected(ix)));
+    EXPECT_EQ(subset.values(fes::kS2)(ix), s2(selected(ix)));
+  }
+
+  // The extracted model is standalone: it survives the serialization.
+  const auto state = subset.getstate();
+  EXPECT_LT(state.size(), lgp2.getstate().size());
+  const auto other = fes::tidal_model::LGP2<double>::setstate(
+      fes::string_view(state.data(), state.size()));
+
+  auto acc1 = std::unique_ptr<fes::Accelerator>(
+      lgp2.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto acc2 = std::unique_ptr<fes::Accelerator>(
+      other.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  for (auto x = -0.2; x <= 0.2; x += 0.01) {
+    for (auto y = -0.1; y <= 0.2; y += 0.01) {
+      const auto point = fes::geometry::Point(x, y);
+      fes::Quality expected_quality;
+      fes::Quality quality;
+      const auto expected =
+          lgp2.interpolate(point, expected_quality, acc1.get());
+      const auto result = other.interpolate(point, quality, acc2.get());
+      EXPECT_EQ(quality, expected_quality);
+      ASSERT_EQ(result.size(), expected.size());
+      for (size_t ix = 0; ix < result.size(); ++ix) {
+        EXPECT_EQ(result[ix].first, expected[ix].first);
+        EXPECT_NEAR(std::abs(result[ix].second - expected[ix].second), 0,
+                    1e-12);
+      }
+    }
+  }
+
+  // Subset of a regional model.
+  auto regional = fes::tidal_model::LGP2<double>(
+      index, codes, fes::kTide, 0, std::make_tuple(-0.3, -0.2, 0.3, 0.3));
+  auto values = Eigen::VectorXcd(regional.selected_indices().size());
+  for (auto ix = 0; ix < values.size(); ++ix) {
+    values(ix) = m2(regional.selected_indices()(ix));
+  }
+  regional.add_constituent(fes::kM2, values);
+  const auto nested = regional.subset(bbox);
+  ASSERT_EQ(nested.selected_indices().size(),
+            subset.selected_indices().size());
+  EXPECT_EQ(nested.selected_indices(), subset.selected_indices());
+  EXPECT_EQ(nested.values(fes::kM2), subset.values(fes::kM2));
+
+  EXPECT_THROW(lgp2.subset(std::make_tuple(10.0, 10.0, 11.0, 11.0)),
+               std::invalid_argument);
+}
+
+TEST(InterpolatorLGP2, Batch) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+
+  auto generator = std::mt19937(42);
+  auto lgp2 =
+      fes::tidal_model::LGP2<double>(index, codes, fes::kTide, 20'000);
+  for (auto ident : {fes::kM2, fes::kS2, fes::kK1}) {
+    auto wave = Eigen::VectorXcd(24 * 6);
+    for (auto ix = 0; ix < wave.size(); ++ix) {
+      wave(ix) = std::complex<double>(std::cos(ix + ident), std::sin(ix));
+    }
+    lgp2.add_constituent(ident, wave);
+  }
+
+  // Points inside, around and far from the mesh, and on its vertices.
+  auto distribution = std::uniform_real_distribution<double>(-0.8, 0.8);
+  auto x = Eigen::VectorXd(1000 + lon.size());
+  auto y = Eigen::VectorXd(1000 + lon.size());
+  for (auto ix = 0; ix < 1000; ++ix) {
+    x(ix) = distribution(generator);
+    y(ix) = distribution(generator);
+  }
+  x.tail(lon.size()) = lon;
+  y.tail(lat.size()) = lat;
+
+  for (auto interleave : {false, true}) {
+    if (interleave) {
+      lgp2.interleave();
+    }
+    auto acc = std::unique_ptr<fes::Accelerator>(
+        lgp2.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+    for (auto num_threads : {1, 3}) {
+      auto values = fes::tidal_model::LGP2<double>::BatchValues();
+      auto qualities = fes::Vector<fes::Quality>();
+      std::tie(values, qualities) = lgp2.interpolate_batch(x, y, num_threads);
+      ASSERT_EQ(values.rows(), x.size());
+      ASSERT_EQ(values.cols(), 3);
+      auto counts = std::array<int, 3>{};
+      for (auto ix = 0; ix < x.size(); ++ix) {
+        fes::Quality quality;
+        const auto& expected =
+            lgp2.interpolate({x(ix), y(ix)}, quality, acc.get());
+        EXPECT_EQ(qualities(ix), quality);
+        ++counts[quality > 0 ? 0 : quality < 0 ? 1 : 2];
+        for (auto jx = 0; jx < 3; ++jx) {
+          if (quality == fes::kUndefined) {
+            EXPECT_TRUE(std::isnan(values(ix, jx).real()));
+          } else {
+            EXPECT_EQ(values(ix, jx), expected[jx].second);
+          }
+        }
+      }
+      // All the cases are covered.
+      EXPECT_GT(counts[0], 0);
+      EXPECT_GT(counts[1], 0);
+      EXPECT_GT(counts[2], 0);
+    }
+  }
+  EXPECT_THROW(lgp2.interpolate_batch(x, y.head(10)), std::invalid_argument);
+}
+
+TEST(InterpolatorLGP2, StreamState) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+  index->build_coastal_band(20'000);
+
+  auto generator = std::mt19937(42);
+  auto distribution = std::uniform_real_distribution<double>(-1, 1);
+  auto lgp2 = fes::tidal_model::LGP2<double>(index, codes, fes::kTide, 20'000);
+  for (auto ident : {fes::kM2, fes::kK1}) {
+    auto wave = Eigen::VectorXcd(24 * 6);
+    for (auto ix = 0; ix < wave.size(); ++ix) {
+      wave(ix) = {distribution(generator), distribution(generator)};
+    }
+    lgp2.add_constituent(ident, wave);
+  }
+  lgp2.interleave();
+
+  // The stream receives the bytes of the in-memory state.
+  const auto state = lgp2.getstate();
+  auto ss = std::stringstream();
+  lgp2.getstate(ss);
+  EXPECT_EQ(ss.str(), state);
+
+  const auto other = fes::tidal_model::LGP2<double>::setstate(ss);
+  EXPECT_EQ(other.getstate(), state);
+  EXPECT_TRUE(other.interleaved());
+  EXPECT_TRUE(other.index()->has_coastal_band());
+
+  auto acc1 = std::unique_ptr<fes::Accelerator>(
+      lgp2.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto acc2 = std::unique_ptr<fes::Accelerator>(
+      other.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+  auto x = std::uniform_real_distribution<double>(-0.6, 0.7);
+  auto y = std::uniform_real_distribution<double>(-0.5, 0.55);
+  for (auto trial = 0; trial < 100; ++trial) {
+    const auto point = fes::geometry::Point(x(generator), y(generator));
+    fes::Quality expected_quality;
+    fes::Quality quality;
+    const auto expected = lgp2.interpolate(point, expected_quality, acc1.get());
+    const auto values = other.interpolate(point, quality, acc2.get());
+    EXPECT_EQ(quality, expected_quality);
+    if (quality != fes::kUndefined) {
+      for (size_t ix = 0; ix < values.size(); ++ix) {
+        EXPECT_EQ(values[ix].second, expected[ix].second);
+      }
+    }
+  }
+
+  // A truncated stream is rejected.
+  auto truncated = std::stringstream(state.substr(0, state.size() / 2));
+  EXPECT_THROW(fes::tidal_model::LGP2<double>::setstate(truncated),
+               std::runtime_error);
+
+  // The arrays stored out-of-band are not written in the state.
+  auto out_of_band = fes::detail::serialize::OutOfBand(1024);
+  auto header = std::stringstream();
+  out_of_band.attach(header);
+  lgp2.getstate(header);
+  ASSERT_FALSE(out_of_band.buffers().empty());
+  EXPECT_LT(header.str().size(), state.size());
+
+  auto reader = fes::detail::serialize::OutOfBand(out_of_band.buffers());
+  auto input = std::stringstream(header.str());
+  reader.attach(input);
+  const auto restored = fes::tidal_model::LGP2<double>::setstate(input);
+  EXPECT_EQ(restored.getstate(), state);
+
+  // The arrays of the search structures of the index are also stored
+  // out-of-band: the state only keeps a flag for each array.
+  auto all = fes::detail::serialize::OutOfBand(0);
+  auto shapes = std::stringstream();
+  all.attach(shapes);
+  lgp2.getstate(shapes);
+  auto stored = size_t(0);
+  for (const auto& item : all.buffers()) {
+    stored += item.second;
+  }
+  EXPECT_EQ(shapes.str().size() + stored, state.size() + all.buffers().size());
+  reader = fes::detail::serialize::OutOfBand(all.buffers());
+  input = std::stringstream(shapes.str());
+  reader.attach(input);
+  EXPECT_EQ(fes::tidal_model::LGP2<double>::setstate(input).getstate(), state);
+
+  // With an owner, the model borrows the buffers and keeps them alive.
+  auto owner = std::make_shared<int>(0);
+  reader = fes::detail::serialize::OutOfBand(all.buffers(), owner);
+  input = std::stringstream(shapes.str());
+  reader.attach(input);
+  {
+    const auto borrowed = fes::tidal_model::LGP2<double>::setstate(input);
+    EXPECT_EQ(borrowed.getstate(), state);
+    EXPECT_GT(owner.use_count(), 1);
+    const auto* lon =
+        reinterpret_cast<const char*>(borrowed.index()->lon().data());
+    EXPECT_TRUE(std::any_of(
+        all.buffers().begin(), all.buffers().end(),
+        [lon](const fes::detail::serialize::OutOfBand::Buffer& item) {
+          return item.first == lon;
+        }));
+  }
+  EXPECT_EQ(owner.use_count(), 2);
+  reader = fes::detail::serialize::OutOfBand();
+  EXPECT_EQ(owner.use_count(), 1);
+
+  // The buffers must match the arrays expected.
+  auto missing = fes::detail::serialize::OutOfBand(
+      std::vector<fes::detail::serialize::OutOfBand::Buffer>());
+  input = std::stringstream(header.str());
+  missing.attach(input);
+  EXPECT_THROW(fes::tidal_model::LGP2<double>::setstate(input),
+               std::runtime_error);
+}
+
+TEST(InterpolatorLGP2, SetStateOutOfRange) {
+  auto lon = Eigen::VectorXd();
+  auto lat = Eigen::VectorXd();
+  auto triangles = Eigen::Matrix<int, -1, 3>();
+  auto codes = Eigen::Matrix<int, -1, 6>();
+  std::tie(lon, lat, triangles, codes) = make_data();
+  auto index = std::make_shared<fes::mesh::Index>(lon, lat, triangles);
+
+  auto lgp2 = fes::tidal_model::LGP2<double>(index, codes, fes::kTide);
+  lgp2.add_constituent(fes::kM2, Eigen::VectorXcd::Ones(24 * 6));
+  const auto state = lgp2.getstate();
+  // Restores the model from its state, with one item replaced.
+  auto setstate = [&state](const size_t offset, const int value) {
+    auto data = state;
+    std::memcpy(&data[offset], &value, sizeof(value));
+    return fes::tidal_model::LGP2<double>::setstate(
+        fes::string_view(data.data(), data.size()));
+  };
+
+  // Position of the expected data size, then of the first LGP code.
+  const auto size_offset = sizeof(fes::TideType);
+  const auto codes_offset = size_offset + sizeof(int) + sizeof(size_t) +
+                            index->getstate().size() + sizeof(double) +
+                            2 * sizeof(Eigen::Index);
+
+  EXPECT_NO_THROW(setstate(codes_offset, 143));
+  EXPECT_NO_THROW(setstate(codes_offset, -1));
+  EXPECT_THROW(setstate(codes_offset, 144), std::runtime_error);
+  EXPECT_THROW(setstate(codes_offset, -2), std::runtime_error);
+  // The codes no longer fit in the wave values, or the wave values no longer
+  // have the expected size.
+  EXPECT_THROW(setstate(size_offset, 143), std::runtime_error);
+  EXPECT_THROW(setstate(size_offset, 145), std::runtime_error);
+}
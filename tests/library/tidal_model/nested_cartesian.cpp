@@ -0,0 +1,85 @@
+// Copyright (c) 2025 CNES
+//
+// All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+#include "fes/tidal_model/nested_cartesian.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+using Model = fes::tidal_model::Cartesian<double>;
+using NestedModel = fes::tidal_model::NestedCartesian<double>;
+
+static auto build_models() -> std::vector<std::shared_ptr<Model>> {
+  // Global grid with a resolution of one degree.
+  auto global = std::make_shared<Model>(
+      fes::Axis(Eigen::VectorXd::LinSpaced(360, 0, 359), 1e-6, true),
+      fes::Axis(Eigen::VectorXd::LinSpaced(181, -90, 90)), fes::kTide);
+  global->add_constituent(fes::kM2,
+                          Eigen::VectorXcd::Constant(360 * 181, {1, 0}));
+
+  // Regional grid, with a resolution of half a degree, undefined along its
+  // first two meridians.
+  auto regional = std::make_shared<Model>(
+      fes::Axis(Eigen::VectorXd::LinSpaced(5, -2, 0)),
+      fes::Axis(Eigen::VectorXd::LinSpaced(5, 40, 42)), fes::kTide);
+  auto wave = Eigen::VectorXcd::Constant(25, {2, 0}).eval();
+  wave.head(10).setConstant({std::nan(""), 0});
+  regional->add_constituent(fes::kM2, wave);
+  return {regional, global};
+}
+
+TEST(TidalModelNestedCartesian, Interpolate) {
+  auto model = NestedModel(build_models());
+  ASSERT_EQ(model.grids().size(), 2);
+  EXPECT_EQ(model.grids()[0].offset, 0);
+  EXPECT_EQ(model.grids()[1].offset, 25);
+  EXPECT_EQ(model.data().at(fes::kM2).size(), 25 + 360 * 181);
+
+  auto quality = fes::Quality{};
+  auto acc = std::unique_ptr<fes::Accelerator>(
+      model.accelerator(fes::angle::Formulae::kMeeus, 0.0));
+
+  // The regional grid is used where it is defined, whatever the longitude
+  // convention.
+  auto values = model.interpolate({-0.75, 41.25}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_EQ(values[0].second, std::complex<double>(2, 0));
+  values = model.interpolate({359.25, 41.25}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_EQ(values[0].second, std::complex<double>(2, 0));
+
+  // Falls back to the global grid where the regional one is undefined or
+  // does not cover the point.
+  values = model.interpolate({-1.75, 41.25}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_EQ(values[0].second, std::complex<double>(1, 0));
+  values = model.interpolate({120, -30}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_EQ(values[0].second, std::complex<double>(1, 0));
+
+  // The model state is restored.
+  auto state = model.getstate();
+  auto other =
+      NestedModel::setstate(fes::string_view(state.data(), state.size()));
+  EXPECT_EQ(other.resolution(), model.resolution());
+  ASSERT_EQ(other.grids().size(), 2);
+  values = other.interpolate({-0.75, 41.25}, quality, acc.get());
+  EXPECT_EQ(quality, 4);
+  EXPECT_EQ(values[0].second, std::complex<double>(2, 0));
+
+  EXPECT_THROW(NestedModel::setstate("invalid"), std::invalid_argument);
+}
+
+TEST(TidalModelNestedCartesian, Constructor) {
+  EXPECT_THROW(NestedModel(std::vector<std::shared_ptr<Model>>{}),
+               std::invalid_argument);
+  auto models = build_models();
+  models[0]->add_constituent(fes::kK2, Eigen::VectorXcd::Zero(25));
+  EXPECT_THROW(NestedModel(models, 1.0), std::invalid_argument);
+  EXPECT_THROW(NestedModel(build_models(), 0.0), std::invalid_argument);
+}
@@ -2,9 +2,13 @@
 #
 # All rights reserved. Use of this source code is governed by a
 # BSD-style license that can be found in the LICENSE file.
+import os
 import pathlib
 import pickle
+import shutil
 
+import pytest
+import pyfes
 import pyfes.config as config_handler
 
 DATASET = pathlib.Path(__file__).parent / 'dataset'
@@ -63,3 +67,154 @@ tide:
     other = pickle.loads(pickle.dumps(config))
     assert config.keys() == other.keys()
     assert config != other
+
+
+def test_config_selection(tmp_path):
+    """Test the loading of a subset of the constituents."""
+    config = f"""
+tide:
+    lgp:
+        path: {DATASET / "fes_2014.nc"}
+        codes: lgp2
+        amplitude: "{{constituent}}_amp"
+        phase: "{{constituent}}_phase"
+        type: lgp2
+        constituents:
+            - M2
+            - K1
+            - O1
+radial:
+    cartesian:
+        paths:
+            M2: {DATASET / "M2_radial.nc"}
+            K1: {DATASET / "K1_radial.nc"}
+            O1: {DATASET / "O1_radial.nc"}
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    config = config_handler.load(config_path, constituents=['m2', 'O1'])
+    for model in config.values():
+        assert sorted(map(int, model.identifiers())) == sorted(
+            map(int, [pyfes.core.kM2, pyfes.core.kO1]))
+
+    config = config_handler.load(config_path, lazy=True)
+    assert isinstance(config, config_handler.LazyModels)
+    assert sorted(config) == ['radial', 'tide']
+    assert config.loaded() == []
+    assert len(config['radial']) == 3
+    assert config.loaded() == ['radial']
+    assert config['radial'] is config['radial']
+
+    other = pickle.loads(pickle.dumps(config))
+    assert sorted(other) == ['radial', 'tide']
+
+    with pytest.raises(ValueError):
+        config_handler.load(config_path, constituents=['S2'])
+
+
+def test_config_cache(tmp_path):
+    """Test the cache of the models built."""
+    paths = {}
+    for item in ('M2', 'K1'):
+        paths[item] = tmp_path / f'{item}_radial.nc'
+        shutil.copy(DATASET / f'{item}_radial.nc', paths[item])
+    config = f"""
+radial:
+    cartesian:
+        paths:
+            M2: {paths["M2"]}
+            K1: {paths["K1"]}
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    cache = tmp_path / 'cache'
+    model = config_handler.load(config_path, cache=cache)['radial']
+    assert len(list(cache.iterdir())) == 1
+
+    # The second load reads the model stored in the cache.
+    cached = config_handler.load(config_path, cache=cache)['radial']
+    assert len(list(cache.iterdir())) == 1
+    assert cached.__getstate__() == model.__getstate__()
+
+    # The models built from other settings or files are stored separately.
+    config_handler.load(config_path, cache=cache, constituents=['M2'])
+    assert len(list(cache.iterdir())) == 2
+    stat = os.stat(paths['M2'])
+    os.utime(paths['M2'], ns=(stat.st_atime_ns, stat.st_mtime_ns + 10**9))
+    config_handler.load(config_path, cache=cache)
+    assert len(list(cache.iterdir())) == 3
+
+    # The entries writable by the other users are never unpickled, but
+    # replaced.
+    for item in cache.iterdir():
+        os.chmod(item, 0o666)
+    with pytest.warns(RuntimeWarning, match='writable by other users'):
+        config_handler.load(config_path, cache=cache)
+    assert len(list(cache.iterdir())) == 3
+
+    # A cache directory writable by the other users is not used.
+    os.chmod(cache, 0o777)
+    with pytest.warns(RuntimeWarning, match='Unable to use the cache'):
+        other = config_handler.load(config_path, cache=cache)['radial']
+    assert other.__getstate__() == model.__getstate__()
+    assert len(list(cache.iterdir())) == 3
+
+
+def test_config_concurrent(tmp_path):
+    """Test the concurrent loading of the models."""
+    config = f"""
+tide:
+    lgp:
+        path: {DATASET / "fes_2014.nc"}
+        codes: lgp2
+        amplitude: "{{constituent}}_amp"
+        phase: "{{constituent}}_phase"
+        type: lgp2
+        constituents:
+            - M2
+            - K1
+            - O1
+radial:
+    cartesian:
+        paths:
+            M2: {DATASET / "M2_radial.nc"}
+            K1: {DATASET / "K1_radial.nc"}
+            O1: {DATASET / "O1_radial.nc"}
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    expected = config_handler.load(config_path, num_threads=1)
+    config = config_handler.load(config_path, num_threads=4)
+    assert list(config) == list(expected)
+    for key, model in config.items():
+        assert pickle.dumps(model) == pickle.dumps(expected[key])
+
+
+def test_config_num_threads(tmp_path, monkeypatch):
+    """Test that the threads are shared out between the sections."""
+    config = f"""
+tide:
+    cartesian:
+        paths:
+            M2: {DATASET / "M2_tide.nc"}
+radial:
+    cartesian:
+        paths:
+            M2: {DATASET / "M2_radial.nc"}
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    shares = []
+
+    def build_model(settings, cache, num_threads):
+        shares.append(num_threads)
+
+    monkeypatch.setattr(config_handler, '_build_model', build_model)
+    for num_threads, expected in ((1, [1, 1]), (2, [1, 1]), (5, [2, 2])):
+        shares.clear()
+        config_handler.load(config_path, num_threads=num_threads)
+        assert shares == expected
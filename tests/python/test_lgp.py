@@ -3,6 +3,7 @@
 # All rights reserved. Use of this source code is governed by a
 # BSD-style license that can be found in the LICENSE file.
 import pathlib
+import pickle
 
 import numpy
 from pyfes import evaluate_tide
@@ -52,3 +53,80 @@ tide:
                                lats,
                                num_threads=1)
     assert tide.shape == (24, )
+
+
+def test_renumbered_mesh(tmp_path) -> None:
+    """Test that the renumbering of the mesh does not change the tide."""
+    tides = []
+    for renumber in ('false', 'true'):
+        config = f"""
+tide:
+    lgp:
+        path: {DATASET / "fes_2014.nc"}
+        codes: lgp2
+        amplitude: "{{constituent}}_amp"
+        phase: "{{constituent}}_phase"
+        type: lgp2
+        renumber: {renumber}
+        constituents:
+            - K1
+            - M2
+            - O1
+            - S2
+"""
+        config_path = str(tmp_path / f'config_{renumber}.yaml')
+        with open(config_path, 'w', encoding='utf-8') as stream:
+            stream.write(config)
+        handler = config_handler.load(config_path)
+
+        dates = numpy.full((16, ),
+                           numpy.datetime64('1983-01-01T00:00:00'),
+                           dtype='M8[ms]')
+        lons = numpy.linspace(-8.5, -6.5, 16)
+        lats = numpy.linspace(58.5, 60.0, 16)
+        tide, _, _ = evaluate_tide(handler['tide'],
+                                   dates,
+                                   lons,
+                                   lats,
+                                   num_threads=1)
+        tides.append(tide)
+    numpy.testing.assert_allclose(tides[0], tides[1], equal_nan=True)
+
+
+def test_pickle_out_of_band(tmp_path) -> None:
+    """Test the pickling of a model with out-of-band buffers."""
+    config = f"""
+tide:
+    lgp:
+        path: {DATASET / "fes_2014.nc"}
+        codes: lgp2
+        amplitude: "{{constituent}}_amp"
+        phase: "{{constituent}}_phase"
+        type: lgp2
+        constituents:
+            - K1
+            - M2
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    model = config_handler.load(config_path)['tide']
+
+    buffers: list[pickle.PickleBuffer] = []
+    data = pickle.dumps(model, protocol=5, buffer_callback=buffers.append)
+    assert buffers
+    # The large arrays are not part of the pickled data.
+    assert len(data) < len(pickle.dumps(model, protocol=4))
+    other = pickle.loads(data, buffers=buffers)
+
+    lons = numpy.linspace(-8.5, -6.5, 16)
+    lats = numpy.linspace(58.5, 60.0, 16)
+    expected, expected_quality = model.interpolate(lons, lats)
+    values, quality = other.interpolate(lons, lats)
+    numpy.testing.assert_array_equal(quality, expected_quality)
+    for key, item in expected.items():
+        numpy.testing.assert_array_equal(values[key], item)
+
+    # Without callback, the buffers are serialized in-band.
+    other = pickle.loads(pickle.dumps(model, protocol=5))
+    assert other.__getstate__() == model.__getstate__()
@@ -0,0 +1,87 @@
+# Copyright (c) 2025 CNES
+#
+# All rights reserved. Use of this source code is governed by a
+# BSD-style license that can be found in the LICENSE file.
+import os
+import pathlib
+import stat
+
+import numpy
+import pytest
+import pyfes.config as config_handler
+import pyfes.shared_memory
+
+DATASET = pathlib.Path(__file__).parent / 'dataset'
+
+
+def test_publish_attach(tmp_path) -> None:
+    """Test the publication of a model in shared memory."""
+    config = f"""
+tide:
+    lgp:
+        path: {DATASET / "fes_2014.nc"}
+        codes: lgp2
+        amplitude: "{{constituent}}_amp"
+        phase: "{{constituent}}_phase"
+        type: lgp2
+        constituents:
+            - K1
+            - M2
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    model = config_handler.load(config_path)['tide']
+
+    path = pyfes.shared_memory.publish(model, 'fes_tide', tmp_path)
+    assert path == tmp_path / 'fes_tide'
+    other = pyfes.shared_memory.attach('fes_tide', tmp_path)
+    assert isinstance(other, type(model))
+
+    lons = numpy.linspace(-8.5, -6.5, 16)
+    lats = numpy.linspace(58.5, 60.0, 16)
+    expected, expected_quality = model.interpolate(lons, lats)
+    values, quality = other.interpolate(lons, lats)
+    numpy.testing.assert_array_equal(quality, expected_quality)
+    for key, item in expected.items():
+        numpy.testing.assert_array_equal(values[key], item)
+
+    # A file writable by the other users is never unpickled.
+    os.chmod(path, 0o666)
+    with pytest.raises(PermissionError, match='writable by other users'):
+        pyfes.shared_memory.attach('fes_tide', tmp_path)
+    os.chmod(path, 0o600)
+
+    pyfes.shared_memory.unlink('fes_tide', tmp_path)
+    assert not path.exists()
+    with pytest.raises(FileNotFoundError):
+        pyfes.shared_memory.attach('fes_tide', tmp_path)
+    with pytest.raises(ValueError):
+        pyfes.shared_memory.attach('tide/fes', tmp_path)
+
+
+def test_default_directory(tmp_path, monkeypatch) -> None:
+    """Test the directory storing the published models by default."""
+    monkeypatch.setattr(pyfes.shared_memory, 'SHARED_MEMORY_DIRECTORY',
+                        str(tmp_path / 'shm'))
+    config = f"""
+radial:
+    cartesian:
+        paths:
+            M2: {DATASET / "M2_radial.nc"}
+"""
+    config_path = str(tmp_path / 'config.yaml')
+    with open(config_path, 'w', encoding='utf-8') as stream:
+        stream.write(config)
+    model = config_handler.load(config_path)['radial']
+    path = pyfes.shared_memory.publish(model, 'fes_tide')
+    directory = path.parent
+    assert directory.parent == tmp_path / 'shm'
+    assert stat.S_IMODE(directory.stat().st_mode) == 0o700
+    assert isinstance(pyfes.shared_memory.attach('fes_tide'), type(model))
+    pyfes.shared_memory.unlink('fes_tide')
+
+    # A directory writable by the other users is not used.
+    os.chmod(directory, 0o777)
+    with pytest.raises(PermissionError, match='writable by other users'):
+        pyfes.shared_memory.publish(model, 'fes_tide')